@@ -23,6 +23,7 @@
 #include <metaverse/bitcoin/messages.hpp>
 #include <metaverse/bitcoin/version.hpp>
 #include <metaverse/bitcoin/chain/block.hpp>
+#include <metaverse/bitcoin/chain/frozen_transaction.hpp>
 #include <metaverse/bitcoin/chain/header.hpp>
 #include <metaverse/bitcoin/chain/history.hpp>
 #include <metaverse/bitcoin/chain/input.hpp>
@@ -60,6 +61,7 @@
 #include <metaverse/bitcoin/math/hash.hpp>
 #include <metaverse/bitcoin/math/hash_number.hpp>
 #include <metaverse/bitcoin/math/script_number.hpp>
+#include <metaverse/bitcoin/math/siphash.hpp>
 #include <metaverse/bitcoin/math/stealth.hpp>
 #include <metaverse/bitcoin/math/uint256.hpp>
 #include <metaverse/bitcoin/message/address.hpp>
@@ -113,6 +115,7 @@
 #include <metaverse/bitcoin/utility/container_sink.hpp>
 #include <metaverse/bitcoin/utility/container_source.hpp>
 #include <metaverse/bitcoin/utility/data.hpp>
+#include <metaverse/bitcoin/utility/data_reader.hpp>
 #include <metaverse/bitcoin/utility/deadline.hpp>
 #include <metaverse/bitcoin/utility/decorator.hpp>
 #include <metaverse/bitcoin/utility/delegates.hpp>
@@ -121,6 +124,7 @@
 #include <metaverse/bitcoin/utility/enable_shared_from_base.hpp>
 #include <metaverse/bitcoin/utility/endian.hpp>
 #include <metaverse/bitcoin/utility/exceptions.hpp>
+#include <metaverse/bitcoin/utility/inventory_requests.hpp>
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
 #include <metaverse/bitcoin/utility/log.hpp>
 #include <metaverse/bitcoin/utility/logging.hpp>
@@ -132,7 +136,9 @@
 #include <metaverse/bitcoin/utility/reader.hpp>
 #include <metaverse/bitcoin/utility/resource_lock.hpp>
 #include <metaverse/bitcoin/utility/resubscriber.hpp>
+#include <metaverse/bitcoin/utility/rolling_filter.hpp>
 #include <metaverse/bitcoin/utility/scope_lock.hpp>
+#include <metaverse/bitcoin/utility/sequence_buffer.hpp>
 #include <metaverse/bitcoin/utility/serializer.hpp>
 #include <metaverse/bitcoin/utility/string.hpp>
 #include <metaverse/bitcoin/utility/subscriber.hpp>
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_CHAIN_FROZEN_TRANSACTION_HPP
+#define MVS_CHAIN_FROZEN_TRANSACTION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/chain/input.hpp>
+#include <metaverse/bitcoin/chain/output.hpp>
+#include <metaverse/bitcoin/chain/point.hpp>
+#include <metaverse/bitcoin/chain/transaction.hpp>
+#include <metaverse/bitcoin/math/hash.hpp>
+#include <metaverse/bitcoin/utility/data.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+/// An immutable transaction held as its wire bytes.
+/// The hash and the input/output offsets are computed once when frozen,
+/// inputs and outputs are only parsed when asked for.
+class BC_API frozen_transaction
+{
+public:
+    typedef std::shared_ptr<const frozen_transaction> ptr;
+
+    static ptr freeze(const transaction& tx);
+
+    frozen_transaction();
+    explicit frozen_transaction(const transaction& tx);
+
+    bool is_valid() const;
+    const data_chunk& data() const;
+    const hash_digest& hash() const;
+    uint64_t serialized_size() const;
+
+    size_t inputs_size() const;
+    size_t outputs_size() const;
+
+    /// Read from the bytes without parsing the input script.
+    output_point previous_output(size_t index) const;
+
+    input input_at(size_t index) const;
+    output output_at(size_t index) const;
+
+    /// Parse the whole transaction.
+    transaction thaw() const;
+
+private:
+    data_chunk slice(size_t begin, size_t end) const;
+
+    data_chunk data_;
+    hash_digest hash_;
+
+    // [inputs..., end of inputs, outputs..., end of outputs]
+    std::vector<uint32_t> offsets_;
+    uint32_t inputs_;
+};
+
+} // namespace chain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATA_READER_IPP
+#define MVS_DATA_READER_IPP
+
+#include <algorithm>
+#include <metaverse/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+
+template <typename T>
+T data_reader::read_big_endian()
+{
+    if (!require(sizeof(T)))
+        return 0;
+
+    const auto value = from_big_endian_unsafe<T>(position_);
+    position_ += sizeof(T);
+    return value;
+}
+
+template <typename T>
+T data_reader::read_little_endian()
+{
+    if (!require(sizeof(T)))
+        return 0;
+
+    const auto value = from_little_endian_unsafe<T>(position_);
+    position_ += sizeof(T);
+    return value;
+}
+
+template <unsigned Size>
+byte_array<Size> data_reader::read_bytes()
+{
+    byte_array<Size> out{ {} };
+    if (!require(Size))
+        return out;
+
+    std::copy(position_, position_ + Size, out.begin());
+    position_ += Size;
+    return out;
+}
+
+template <unsigned Size>
+byte_array<Size> data_reader::read_bytes_reverse()
+{
+    byte_array<Size> out{ {} };
+    if (!require(Size))
+        return out;
+
+    std::reverse_copy(position_, position_ + Size, out.begin());
+    position_ += Size;
+    return out;
+}
+
+} // libbitcoin
+
+#endif
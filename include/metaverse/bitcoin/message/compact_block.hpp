@@ -21,9 +21,16 @@
 #ifndef MVS_MESSAGE_COMPACT_BLOCK_HPP
 #define MVS_MESSAGE_COMPACT_BLOCK_HPP
 
+#include <cstdint>
+#include <functional>
 #include <istream>
+#include <vector>
 #include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/chain/block.hpp>
 #include <metaverse/bitcoin/chain/header.hpp>
+#include <metaverse/bitcoin/chain/transaction.hpp>
+#include <metaverse/bitcoin/math/hash.hpp>
+#include <metaverse/bitcoin/math/siphash.hpp>
 #include <metaverse/bitcoin/message/prefilled_transaction.hpp>
 #include <metaverse/bitcoin/utility/data.hpp>
 #include <metaverse/bitcoin/utility/reader.hpp>
@@ -38,6 +45,11 @@ public:
     typedef std::shared_ptr<compact_block> ptr;
     typedef mini_hash short_id;
     typedef mini_hash_list short_id_list;
+    typedef std::function<bool(const hash_digest&, chain::transaction&)>
+        transaction_finder;
+
+    /// The compact form of the block, only the coinbase is prefilled.
+    static compact_block from_block(const chain::block& block, uint64_t nonce);
 
     static compact_block factory_from_data(uint32_t version,
         const data_chunk& data);
@@ -56,6 +68,19 @@ public:
     void reset();
     uint64_t serialized_size(uint32_t version) const;
 
+    // The short id key is sha256(header || nonce), as specified by bip152.
+    siphash_key short_id_key() const;
+    static short_id to_short_id(const siphash_key& key,
+        const hash_digest& transaction_hash);
+
+    /// Rebuild the block from the prefilled transactions and those found by
+    /// candidate hash, setting the (absolute) indexes still to be requested.
+    /// False if a prefilled index is invalid or two short ids collide, then
+    /// the full block must be requested instead.
+    bool reconstruct(chain::block& out_block,
+        std::vector<uint64_t>& out_missing, const hash_list& candidates,
+        transaction_finder find) const;
+
     static const std::string command;
     static const uint32_t version_minimum;
     static const uint32_t version_maximum;
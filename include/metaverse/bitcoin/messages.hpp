@@ -22,6 +22,7 @@
 #define MVS_MESSAGES_HPP
 
 #include <cstdint>
+#include <string>
 #include <metaverse/bitcoin/message/address.hpp>
 #include <metaverse/bitcoin/message/alert.hpp>
 #include <metaverse/bitcoin/message/alert_payload.hpp>
@@ -104,19 +105,15 @@ namespace libbitcoin {
 namespace message {
 
 /**
-* Serialize a message object to the Bitcoin wire protocol encoding.
+* Frame an already serialized payload in the Bitcoin wire protocol encoding.
 */
-template <typename Message>
-data_chunk serialize(uint32_t version, const Message& packet,
-    uint32_t magic)
+inline data_chunk serialize(const std::string& command,
+    const data_chunk& payload, uint32_t magic)
 {
-    // Serialize the payload (required for header size).
-    const auto payload = packet.to_data(version);
-
     // Construct the payload header.
     heading head;
     head.magic = magic;
-    head.command = Message::command;
+    head.command = command;
     head.payload_size = static_cast<uint32_t>(payload.size());
     head.checksum = bitcoin_checksum(payload);
 
@@ -126,6 +123,17 @@ data_chunk serialize(uint32_t version, const Message& packet,
     return message;
 }
 
+/**
+* Serialize a message object to the Bitcoin wire protocol encoding.
+*/
+template <typename Message>
+data_chunk serialize(uint32_t version, const Message& packet,
+    uint32_t magic)
+{
+    // Serialize the payload (required for header size).
+    return serialize(Message::command, packet.to_data(version), magic);
+}
+
 } // namespace message
 } // namespace libbitcoin
 
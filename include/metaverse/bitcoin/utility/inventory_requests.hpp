@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_INVENTORY_REQUESTS_HPP
+#define MVS_INVENTORY_REQUESTS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/math/hash.hpp>
+#include <metaverse/bitcoin/utility/asio.hpp>
+#include <metaverse/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+
+/**
+ * Inventory requested from peers and not yet delivered, thread safe.
+ * Each hash is claimed by at most one owner (a channel nonce) at a time.
+ * A claim lapses after the timeout, so an owner that never answers cannot
+ * keep the inventory from being requested of another peer that announced it.
+ */
+class BC_API inventory_requests
+{
+public:
+    inventory_requests(const asio::duration& timeout);
+
+    /// This class is not copyable.
+    inventory_requests(const inventory_requests&) = delete;
+    void operator=(const inventory_requests&) = delete;
+
+    /// Claim the hash for the owner, false if claimed and not yet lapsed.
+    bool claim(const hash_digest& hash, uint64_t owner);
+
+    /// Release the hash if it is claimed by the owner.
+    void release(const hash_digest& hash, uint64_t owner);
+
+    /// Release the hash whoever claimed it (the inventory has arrived).
+    void release(const hash_digest& hash);
+
+    /// Release every hash claimed by the owner (the owner has stopped).
+    void release_all(uint64_t owner);
+
+    /// The number of outstanding claims, including lapsed ones.
+    size_t size() const;
+
+private:
+    struct claim_entry
+    {
+        uint64_t owner;
+        asio::time_point expires;
+    };
+
+    typedef std::unordered_map<hash_digest, claim_entry> claim_map;
+
+    void purge(const asio::time_point& now);
+
+    const asio::duration timeout_;
+
+    // These are protected by mutex.
+    claim_map claims_;
+    asio::time_point next_purge_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_ROLLING_FILTER_HPP
+#define MVS_ROLLING_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/math/hash.hpp>
+#include <metaverse/bitcoin/math/siphash.hpp>
+#include <metaverse/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+
+/**
+ * A bloom filter over hashes that forgets its oldest entries, thread safe.
+ * Two generations of capacity / 2 entries are kept: when the current one
+ * fills it becomes the previous one and the oldest is discarded, so at least
+ * the most recent capacity / 2 entries are always matched. False positives
+ * occur at about the given rate, false negatives only for aged out entries.
+ * Positions are keyed by a random siphash key so they cannot be ground.
+ */
+class BC_API rolling_filter
+{
+public:
+    rolling_filter(size_t capacity, double false_positive_rate);
+
+    /// This class is not copyable.
+    rolling_filter(const rolling_filter&) = delete;
+    void operator=(const rolling_filter&) = delete;
+
+    /// Add the hash to the filter.
+    void insert(const hash_digest& hash);
+
+    /// Add the hash to the filter, false if it was (probably) present.
+    bool insert_new(const hash_digest& hash);
+
+    /// True if the hash was (probably) added and has not aged out.
+    bool contains(const hash_digest& hash) const;
+
+    /// Forget all entries.
+    void clear();
+
+private:
+    typedef std::vector<uint64_t> bits;
+
+    void positions(const hash_digest& hash, uint64_t& first,
+        uint64_t& step) const;
+    bool test(const bits& generation, uint64_t first, uint64_t step) const;
+    void do_insert(uint64_t first, uint64_t step);
+
+    const size_t generation_size_;
+    const size_t hash_count_;
+    const uint64_t bit_count_;
+    const siphash_key first_key_;
+    const siphash_key second_key_;
+
+    // These are protected by mutex.
+    size_t inserted_;
+    bits current_;
+    bits previous_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_SEQUENCE_BUFFER_HPP
+#define MVS_SEQUENCE_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+
+namespace libbitcoin {
+
+/**
+ * Restores the order of items completed out of order, not thread safe.
+ * Each item carries the sequence assigned on arrival, starting at zero, and
+ * is held until every item of a lower sequence has been pushed. Every
+ * sequence must be pushed once, an item that is dropped is pushed empty so
+ * that its successors are not held forever.
+ */
+template <typename Item>
+class sequence_buffer
+{
+public:
+    sequence_buffer()
+      : next_(0)
+    {
+    }
+
+    /// Push the item of the sequence, then release each item that is no
+    /// longer held to the handler, in sequence order.
+    template <typename Handler>
+    void push(uint64_t sequence, Item item, Handler release)
+    {
+        held_.emplace(sequence, std::move(item));
+
+        for (auto it = held_.begin(); it != held_.end() && it->first == next_;
+            it = held_.erase(it), ++next_)
+            release(std::move(it->second));
+    }
+
+    /// The sequence of the next item to release.
+    uint64_t next() const
+    {
+        return next_;
+    }
+
+    /// The number of items held for a lower sequence.
+    size_t held() const
+    {
+        return held_.size();
+    }
+
+private:
+    uint64_t next_;
+    std::map<uint64_t, Item> held_;
+};
+
+} // namespace libbitcoin
+
+#endif
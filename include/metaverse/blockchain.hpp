@@ -25,6 +25,7 @@
 #include <metaverse/blockchain/block_chain_impl.hpp>
 #include <metaverse/blockchain/block_detail.hpp>
 #include <metaverse/blockchain/block_fetcher.hpp>
+#include <metaverse/blockchain/block_message_cache.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/organizer.hpp>
 #include <metaverse/blockchain/orphan_pool.hpp>
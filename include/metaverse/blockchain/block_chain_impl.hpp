@@ -22,13 +22,18 @@
 #define MVS_BLOCKCHAIN_BLOCK_CHAIN_IMPL_HPP
 
 #include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <thread>
+#include <utility>
 #include <vector>
 #include <functional>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/database.hpp>
 #include <metaverse/blockchain/block_chain.hpp>
+#include <metaverse/blockchain/block_message_cache.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/organizer.hpp>
 #include <metaverse/blockchain/settings.hpp>
@@ -50,6 +55,9 @@ class BCB_API block_chain_impl
   : public block_chain, public simple_chain
 {
 public:
+    typedef handle1<block_message_cache::message_ptr>
+        block_message_fetch_handler;
+
     block_chain_impl(threadpool& pool, 
         const blockchain::settings& chain_settings,
         const database::settings& database_settings);
@@ -111,7 +119,8 @@ public:
     bool get_transaction(chain::transaction& out_transaction,
         uint64_t& out_block_height, const hash_digest& transaction_hash) const;
 
-    /// Import a block to the blockchain.
+    /// Import a block to the blockchain, false if stopped or it is invalid.
+    /// Context-free checks run on the caller, synchronization is batched.
     bool import(chain::block::ptr block, uint64_t height);
 
     /// Append the block to the top of the chain.
@@ -124,8 +133,25 @@ public:
     // ------------------------------------------------------------------------
 
     /// Store a block to the blockchain, with indexing and validation.
+    /// Context-free checks run concurrently, commits are batched in order.
     void store(message::block_message::ptr block,
         block_store_handler handler);
+
+    /// Occupancy and throughput of the store pipeline.
+    struct import_statistics
+    {
+        size_t checking;
+        size_t checking_peak;
+        size_t queued;
+        size_t queued_peak;
+        uint64_t batches;
+        uint64_t committed;
+        uint64_t queue_waits;
+        uint64_t imported;
+        uint64_t import_rejected;
+    };
+
+    import_statistics import_stats() const;
     
     /// fetch a block by height.
     void fetch_block(uint64_t height, block_fetch_handler handler);
@@ -133,6 +159,11 @@ public:
     /// fetch a block by height.
     void fetch_block(const hash_digest& hash, block_fetch_handler handler);
 
+    /// fetch a block by hash, framed as a block message for the given magic.
+    /// Recently served blocks are returned from memory without decoding.
+    void fetch_block_message(const hash_digest& hash, uint32_t magic,
+        block_message_fetch_handler handler);
+
     /// fetch block header by height.
     void fetch_block_header(uint64_t height,
         block_header_fetch_handler handler);
@@ -273,6 +304,9 @@ public:
 	operation_result store_account_address(std::shared_ptr<account_address> address);
 	std::shared_ptr<account_address> get_account_address(const std::string& name, const std::string& address);
 	std::shared_ptr<std::vector<account_address>> get_account_addresses(const std::string& name);
+	database::account_transaction::list get_account_transactions(const std::string& name,
+		uint64_t start_height, uint64_t end_height, uint64_t offset, uint64_t limit,
+		uint64_t& total);
 	void uppercase_symbol(std::string& symbol);
 
     bool is_valid_address(const std::string& address);
@@ -321,9 +355,16 @@ private:
         handler(std::forward<Args>(args)...);
     }
 
+    typedef std::pair<block_detail::ptr, block_store_handler> pending_store;
+    typedef std::vector<pending_store> pending_stores;
+
     void start_write();
-    void do_store(message::block_message::ptr block,
+    void check_store(uint64_t sequence, block_detail::ptr detail,
+        block_store_handler handler);
+    void enqueue_store(uint64_t sequence, block_detail::ptr detail,
         block_store_handler handler);
+    void commit_stores();
+    void do_store(const pending_stores& batch, std::vector<bool>& added);
 
     ////void fetch_ordered(perform_read_functor perform_read);
     ////void fetch_parallel(perform_read_functor perform_read);
@@ -338,6 +379,27 @@ private:
     ////dispatcher read_dispatch_;
     ////dispatcher write_dispatch_;
     blockchain::transaction_pool transaction_pool_;
+    block_message_cache block_messages_;
+    dispatcher check_dispatch_;
+
+    // Store pipeline metrics.
+    std::atomic<size_t> checking_;
+    std::atomic<size_t> checking_peak_;
+    std::atomic<uint64_t> batches_;
+    std::atomic<uint64_t> committed_;
+    std::atomic<uint64_t> queue_waits_;
+    std::atomic<uint64_t> imported_;
+    std::atomic<uint64_t> import_rejected_;
+    std::atomic<uint64_t> arrivals_;
+
+    // These are protected by store_mutex_.
+    sequence_buffer<pending_store> store_order_;
+    std::deque<pending_store> store_queue_;
+    size_t queued_peak_;
+    bool committing_;
+    std::thread::id committer_;
+    std::condition_variable_any store_space_;
+    mutable shared_mutex store_mutex_;
 
     // This is protected by mutex.
     database::data_base database_;
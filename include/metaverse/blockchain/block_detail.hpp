@@ -49,6 +49,10 @@ public:
     void set_processed();
     bool processed() const;
 
+    /// Set a flag indicating context-free checks have already passed.
+    void set_prechecked();
+    bool prechecked() const;
+
     /// Set the accepted block height (non-zero).
     void set_height(uint64_t height);
     uint64_t height() const;
@@ -66,6 +70,7 @@ public:
 private:
     bc::atomic<code> code_;
     std::atomic<bool> processed_;
+    std::atomic<bool> prechecked_;
     std::atomic<uint64_t> height_;
     const block_ptr actual_block_;
     bool is_checked_work_proof_;
@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_BLOCK_MESSAGE_CACHE_HPP
+#define MVS_BLOCKCHAIN_BLOCK_MESSAGE_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// A byte-bounded, least recently used cache of blocks framed as wire
+/// messages, so that a block requested by many peers is serialized once.
+class BCB_API block_message_cache
+{
+public:
+    typedef std::shared_ptr<const data_chunk> message_ptr;
+
+    block_message_cache(size_t capacity);
+
+    /// Get the framed block message, or nullptr if not cached for magic.
+    message_ptr find(const hash_digest& hash, uint32_t magic);
+
+    /// Cache the framed block message, evicting the least recently used.
+    void store(const hash_digest& hash, uint32_t magic, message_ptr message);
+
+    /// Drop the block, for example when it is popped from the chain.
+    void remove(const hash_digest& hash);
+
+    /// The number of bytes currently cached.
+    size_t size() const;
+
+private:
+    struct entry
+    {
+        hash_digest hash;
+        uint32_t magic;
+        message_ptr message;
+    };
+
+    typedef std::list<entry> list;
+
+    void erase(list::iterator it);
+
+    const size_t capacity_;
+
+    // These are protected by mutex.
+    size_t size_;
+    list entries_;
+    std::unordered_map<hash_digest, list::iterator> index_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
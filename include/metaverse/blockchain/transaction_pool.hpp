@@ -24,6 +24,7 @@
 #include <atomic>
 #include <cstddef>
 #include <functional>
+#include <memory>
 #include <boost/circular_buffer.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/blockchain/define.hpp>
@@ -54,6 +55,8 @@ public:
 
     static bool is_spent_by_tx(const chain::output_point& outpoint,
         const transaction_ptr tx);
+    static bool is_spent_by_tx(const chain::output_point& outpoint,
+        const chain::frozen_transaction& tx);
 
     /// Construct a transaction memory pool.
     transaction_pool(threadpool& pool, block_chain& chain,
@@ -86,21 +89,43 @@ public:
     void store(transaction_ptr tx, confirm_handler confirm_handler,
         validate_handler validate_handler);
 
+    /// Read the pool directly, without waiting on the pool dispatcher.
+    transaction_ptr find_transaction(const hash_digest& tx_hash) const;
+    std::vector<transaction_ptr> snapshot() const;
+    hash_list transaction_hashes() const;
+
     /// Subscribe to transaction acceptance into the mempool.
     void subscribe_transaction(transaction_handler handler);
 
 protected:
+    /// The last transaction handed out for an entry, held weakly so that
+    /// the pool keeps only the frozen bytes once no caller holds it.
+    struct thawed
+    {
+        unique_mutex mutex;
+        std::weak_ptr<message::transaction_message> tx;
+    };
+
     /// This is analogous to the orphan pool's block_detail.
+    /// The transaction is held frozen and thawed when handed out, unless the
+    /// last one handed out is still held.
     struct entry
     {
-        transaction_ptr tx;
+        chain::frozen_transaction::ptr tx;
+        uint64_t originator;
         confirm_handler handle_confirm;
+
+        /// Shared by copies of the entry.
+        std::shared_ptr<thawed> cache;
+
+        transaction_ptr cached() const;
+        transaction_ptr thaw() const;
     };
 
     typedef boost::circular_buffer<entry> buffer;
     typedef buffer::const_iterator const_iterator;
 
-    typedef std::function<bool(const chain::input&)> input_compare;
+    typedef std::function<bool(const chain::output_point&)> input_compare;
     typedef message::block_message::ptr_list block_list;
 
     bool stopped();
@@ -133,9 +158,12 @@ protected:
     void delete_package(const code& ec);
     void delete_package(transaction_ptr tx, const code& ec);
     bool delete_single(const hash_digest& tx_hash, const code& ec);
+    void erase(buffer::iterator it);
 
-    // The buffer is protected by non-concurrent dispatch.
+    // The buffer is written only by non-concurrent dispatch, under the
+    // mutex so that readers outside of the dispatcher may share it.
     buffer buffer_;
+    mutable shared_mutex mutex_;
     std::atomic<bool> stopped_;
 
 private:
@@ -44,6 +44,12 @@ constexpr uint32_t max_block_script_sigops = max_block_size / 50;
 class BCB_API validate_block
 {
 public:
+    /// Checks that depend only on the block, safe to run off the organizer.
+    static code check_block_context_free(const chain::block& block);
+
+    /// Skip the context-free checks in check_block (already performed).
+    void set_prechecked(bool prechecked);
+
     code check_block(blockchain::block_chain_impl& chain) const;
     code accept_block() const;
     code connect_block(hash_digest& err_tx) const;
@@ -103,6 +109,7 @@ private:
     const size_t height_;
     uint32_t activations_;
     uint32_t minimum_version_;
+    bool prechecked_;
     const chain::block& current_block_;
     const config::checkpoint::list& checkpoints_;
     const stopped_callback stop_callback_;
@@ -392,10 +392,10 @@ public:
 	~RLPStream() {}
 
 	/// Append given datum to the byte stream.
-	RLPStream& append(unsigned _s) { return append(bigint(_s)); }
-	RLPStream& append(u160 _s) { return append(bigint(_s)); }
-	RLPStream& append(u256 _s) { return append(bigint(_s)); }
-	RLPStream& append(bigint _s);
+	RLPStream& append(unsigned _s) { return appendInt(_s); }
+	RLPStream& append(u160 _s) { return appendInt(_s); }
+	RLPStream& append(u256 _s) { return appendInt(_s); }
+	RLPStream& append(bigint _s) { return appendInt(_s); }
 	RLPStream& append(bytesConstRef _s, bool _compact = false);
 	RLPStream& append(bytes const& _s) { return append(bytesConstRef(&_s)); }
 	RLPStream& append(std::string const& _s) { return append(bytesConstRef(_s)); }
@@ -439,6 +439,32 @@ public:
 	void swapOut(bytes& _dest) { if(!m_listStack.empty()) BOOST_THROW_EXCEPTION(RLPException() << errinfo_comment("listStack is not empty")); swap(m_out, _dest); }
 
 private:
+	/// Append an integer in its native width, fixed-width types never allocate.
+	template <class _T> RLPStream& appendInt(_T _i)
+	{
+		if (!_i)
+			m_out.push_back(c_rlpDataImmLenStart);
+		else if (_i < c_rlpDataImmLenStart)
+			m_out.push_back((byte)_i);
+		else
+		{
+			unsigned br = bytesRequired(_i);
+			if (br < c_rlpDataImmLenCount)
+				m_out.push_back((byte)(br + c_rlpDataImmLenStart));
+			else
+			{
+				auto brbr = bytesRequired(br);
+				if (c_rlpDataIndLenZero + brbr > 0xff)
+					BOOST_THROW_EXCEPTION(RLPException() << errinfo_comment("Number too large for RLP"));
+				m_out.push_back((byte)(c_rlpDataIndLenZero + brbr));
+				pushInt(br, brbr);
+			}
+			pushInt(_i, br);
+		}
+		noteAppended();
+		return *this;
+	}
+
 	void noteAppended(size_t _itemCount = 1);
 
 	/// Push the node-type byte (using @a _base) along with the item count @a _count.
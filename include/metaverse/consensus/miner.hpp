@@ -21,6 +21,9 @@
 #ifndef MVS_CONSENSUS_MINER_HPP
 #define MVS_CONSENSUS_MINER_HPP
 
+#include <atomic>
+#include <functional>
+#include <mutex>
 #include <vector>
 #include <boost/thread.hpp>
 
@@ -60,6 +63,8 @@ public:
 	typedef blockchain::block_chain_impl block_chain_impl;
 	typedef blockchain::transaction_pool transaction_pool;
 	typedef libbitcoin::node::p2p_node p2p_node;
+	typedef message::block_message::ptr_list block_ptr_list;
+	typedef std::function<void()> work_handler;
 
 	miner(p2p_node& node);
 	~miner();
@@ -80,6 +85,10 @@ public:
 
 	block_ptr get_block(bool is_force_create_block = false);
 	bool get_work(std::string& seed_hash, std::string& header_hash, std::string& boundary);
+
+	/// Invoke the handler each time the chain tip moves and the work changes.
+	/// The handler is called on the reorganization thread and must not block.
+	void subscribe_work(work_handler handler);
 	bool put_result(const std::string& nounce, const std::string& mix_hash, const std::string& header_hash);
 	bool set_miner_public_key(const string& public_key);
 	bool set_miner_payment_address(const wallet::payment_address& address);
@@ -100,13 +109,31 @@ private:
 	uint64_t store_block(block_ptr block);
 	uint64_t get_height();
 	bool is_stop_miner(uint64_t block_height);
+	block_ptr refresh_block(bool is_force_create_block);
+	void set_block(block_ptr block);
+	void subscribe_reorganize();
+	bool handle_reorganized(const code& ec, uint64_t fork_point,
+		const block_ptr_list& new_blocks, const block_ptr_list& old_blocks);
 
 private:
 	p2p_node& node_;
 	std::shared_ptr<boost::thread> thread_;
 	mutable state state_;
 
+	// Protected by block mutex, work strings are cached per block template.
 	block_ptr new_block_;
+	std::string work_seed_hash_;
+	std::string work_header_hash_;
+	std::string work_boundary_;
+	std::mutex block_mutex_;
+
+	// Set by the reorganization subscription, started by the first work request.
+	std::atomic<bool> work_stale_;
+	std::atomic<uint64_t> tip_height_;
+	std::once_flag work_subscribed_;
+	std::vector<work_handler> work_handlers_;
+	std::mutex work_handlers_mutex_;
+
 	wallet::payment_address pay_address_;
 	const blockchain::settings& setting_;
 };
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <condition_variable>
+#include <deque>
 #include <thread>
+#include <unordered_set>
 #include <metaverse/consensus/libethash/ethash.h>
 #include <metaverse/consensus/libdevcore/Log.h>
 #include <metaverse/consensus/libdevcore/BasicType.h>
@@ -23,6 +25,10 @@ public:
 	static LightType get_light(h256& _seedHash);
 	static FullType get_full(h256& _seedHash);
 	static bool verifySeal(chain::header& header,chain::header& _parent);
+	/// Verify only the ethash seal (no difficulty retarget check), thread safe.
+	/// A header that passes is remembered so verifySeal can skip the compute.
+	static bool verifyProofOfWork(chain::header& header);
+	static bool isProofOfWorkVerified(const hash_digest& _hash);
 	static bool search(chain::header& header, std::function<bool (void)> is_exit);
     static uint64_t getRate(){ return get()->m_rate; }
 
@@ -37,6 +43,9 @@ private:
     std::condition_variable m_fullsChanged;
     std::unordered_map<h256, std::weak_ptr<FullAllocation>> m_fulls;
     FullType m_lastUsedFull;
+    SharedMutex x_verified;
+    std::unordered_set<hash_digest> m_verified;
+    std::deque<hash_digest> m_verifiedOrder;
    // uint64_t m_hashCount;
     uint64_t m_rate;
 
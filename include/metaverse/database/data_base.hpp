@@ -24,6 +24,9 @@
 #include <atomic>
 #include <cstddef>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <metaverse/bitcoin.hpp>
@@ -46,6 +49,7 @@
 
 #include <metaverse/database/databases/account_database.hpp>
 #include <metaverse/database/databases/account_address_database.hpp>
+#include <metaverse/database/databases/account_transaction_database.hpp>
 #include <metaverse/database/databases/asset_database.hpp>
 #include <metaverse/database/databases/blockchain_asset_database.hpp>
 #include <metaverse/database/databases/address_asset_database.hpp>
@@ -87,6 +91,10 @@ public:
         path account_assets_rows;
         path account_addresses_lookup;
         path account_addresses_rows;
+        path account_transactions_lookup;
+        path account_transactions_rows;
+        path address_accounts_lookup;
+        path address_accounts_rows;
 		/* end database for account, asset, address_asset relationship */
     };
 
@@ -121,6 +129,17 @@ public:
         path assets_lookup;
 		/* end database for account, asset, address_asset relationship */
     };
+    class account_transaction_store
+    {
+    public:
+        account_transaction_store(const path& prefix);
+        bool touch_all() const;
+        path account_transactions_lookup;
+        path account_transactions_rows;
+        path address_accounts_lookup;
+        path address_accounts_rows;
+    };
+
 	class db_metadata
 	{
 	public:
@@ -167,6 +186,7 @@ public:
     bool create();
 	bool blockchain_create();
 	bool blockchain_asset_create();
+	bool account_transaction_create();
  
 	void upgrade_blockchain_asset();
 	bool account_db_start();
@@ -198,6 +218,18 @@ public:
     /// If height is not count + 1 then the count will not equal top height.
     void push(const chain::block& block, uint64_t height);
 
+    /// Commit block at given height as push does, but without synchronizing.
+    /// Safe to call concurrently, the caller synchronizes a run of imports.
+    void import(const chain::block& block, uint64_t height);
+
+    /// Synchronize everything committed since the last synchronization.
+    void synchronize();
+
+    /// Defer synchronization of pushed blocks until the batch is ended.
+    /// Call within a write, the batch is synchronized once at its end.
+    void begin_batch();
+    void end_batch();
+
     /// Throws if the chain is empty.
     chain::block pop();
 
@@ -284,6 +316,24 @@ public:
 	void set_admin(const std::string& name, const std::string& passwd);
    /* begin store asset info into  database */
 
+    /* begin account transaction index */
+
+    /// Attribute an address to an account, merging its history into the
+    /// transactions of the account if they are indexed.
+    void link_account_address(const std::string& name, const std::string& address);
+
+    /// Detach the addresses from the account and drop its transactions,
+    /// they are indexed again on next use.
+    void unlink_account_addresses(const std::string& name,
+        const std::vector<std::string>& addresses);
+
+    /// Index the transactions of the account from the business records of
+    /// its addresses, unless already indexed.
+    void build_account_transactions(const std::string& name,
+        const std::vector<std::string>& addresses);
+
+    /* end account transaction index */
+
 protected:
     data_base(const store& paths, size_t history_height, size_t stealth_height);
     data_base(const path& prefix, size_t history_height, size_t stealth_height);
@@ -297,7 +347,6 @@ private:
     static void uninitialize_lock(const path& lock);
     static file_lock initialize_lock(const path& lock);
 
-    void synchronize();
     void push_inputs(const hash_digest& tx_hash, size_t height,
         const inputs& inputs);
     void push_outputs(const hash_digest& tx_hash, size_t height,
@@ -306,6 +355,10 @@ private:
         const outputs& outputs);
     void pop_inputs(const inputs& inputs, size_t height);
     void pop_outputs(const outputs& outputs, size_t height);
+    std::set<short_hash> transaction_accounts(const chain::transaction& tx) const;
+    void push_account_transactions(const chain::transaction& tx,
+        const hash_digest& tx_hash, size_t height);
+    void pop_account_transactions(const chain::transaction& tx, size_t height);
 
     const path lock_file_path_;
     const size_t history_height_;
@@ -320,6 +373,9 @@ private:
     // Cross-database mutext to prevent concurrent file remapping.
     std::shared_ptr<shared_mutex> mutex_;
 
+    // Set while pushes are batched, protected by the caller's write.
+    bool batching_;
+
 	// temp block timestamp
 	uint32_t timestamp_;
 
@@ -338,6 +394,7 @@ public:
     address_asset_database address_assets;
     account_asset_database account_assets;
     account_address_database account_addresses;
+    account_transaction_database account_transactions;
 	/* end database for account, asset, address_asset relationship */
 };
 
@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_ACCOUNT_TRANSACTION_DATABASE_HPP
+#define MVS_DATABASE_ACCOUNT_TRANSACTION_DATABASE_HPP
+
+#include <memory>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/primitives/record_multimap.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// A transaction touching an address of an account.
+struct BCD_API account_transaction
+{
+    typedef std::vector<account_transaction> list;
+
+    uint32_t height;
+    hash_digest hash;
+    uint32_t timestamp;
+};
+
+struct BCD_API account_transaction_statinfo
+{
+    /// Number of buckets used in the hashtable.
+    /// load factor = accounts / buckets
+    const size_t buckets;
+
+    /// Total number of unique accounts in the database.
+    const size_t accounts;
+
+    /// Total number of rows across all accounts.
+    const size_t rows;
+};
+
+/// This is a multimap where the key is the account name hash, which returns
+/// the transactions of the account newest first, one row per transaction.
+/// A second multimap from address hash to account name hash attributes the
+/// transactions of a block to accounts as the block is pushed.
+/// An indexed account keeps a marker row (null hash) below its transactions,
+/// so an account without rows is not yet indexed and is built on first use.
+class BCD_API account_transaction_database
+{
+public:
+    /// Construct the database.
+    account_transaction_database(const boost::filesystem::path& lookup_filename,
+        const boost::filesystem::path& rows_filename,
+        const boost::filesystem::path& addresses_lookup_filename,
+        const boost::filesystem::path& addresses_rows_filename,
+        std::shared_ptr<shared_mutex> mutex=nullptr);
+
+    /// Close the database (all threads must first be stopped).
+    ~account_transaction_database();
+
+    /// Initialize a new account_transaction database.
+    bool create();
+
+    /// Call before using the database.
+    bool start();
+
+    /// Call to signal a stop of current operations.
+    bool stop();
+
+    /// Call to unload the memory map.
+    bool close();
+
+    /// Attribute the address to the account, false if it already is.
+    bool link(const short_hash& address, const short_hash& account);
+
+    /// Remove the attribution of the address to the account.
+    void unlink(const short_hash& address, const short_hash& account);
+
+    /// The accounts the address is attributed to.
+    std::vector<short_hash> accounts(const short_hash& address) const;
+
+    /// Whether the account has no rows, not even its marker (is not indexed).
+    bool empty(const short_hash& account) const;
+
+    /// Add a transaction above all rows of the account.
+    void store(const short_hash& account, const account_transaction& row);
+
+    /// Replace all rows of the account, given in ascending height, and mark
+    /// the account indexed.
+    void replace(const short_hash& account, const account_transaction::list& rows);
+
+    /// Remove all rows of the account, including its marker.
+    void reset(const short_hash& account);
+
+    /// Remove the transaction from the account, normally its last row.
+    void remove(const short_hash& account, const hash_digest& hash);
+
+    /// All rows of the account in ascending height, without the marker.
+    account_transaction::list get(const short_hash& account) const;
+
+    /// Rows in descending height within [start_height, end_height), or all
+    /// if both are zero, skipping offset rows and returning at most limit
+    /// (all if zero). The number of rows in the range is set in total. The
+    /// marker is not a row of the range.
+    account_transaction::list get(const short_hash& account,
+        uint64_t start_height, uint64_t end_height, uint64_t offset,
+        uint64_t limit, uint64_t& total) const;
+
+    /// Synchonise with disk.
+    void sync();
+
+    /// Return statistical info about the database.
+    account_transaction_statinfo statinfo() const;
+
+private:
+    typedef record_hash_table<short_hash> record_map;
+    typedef record_multimap<short_hash> record_multiple_map;
+
+
+    /// Hash table used for start index lookup for linked list by account hash.
+    memory_map lookup_file_;
+    record_hash_table_header lookup_header_;
+    record_manager lookup_manager_;
+    record_map lookup_map_;
+
+    /// List of account_transaction rows.
+    memory_map rows_file_;
+    record_manager rows_manager_;
+    record_list rows_list_;
+    record_multiple_map rows_multimap_;
+
+    /// Hash table used for start index lookup for linked list by address hash.
+    memory_map addresses_lookup_file_;
+    record_hash_table_header addresses_lookup_header_;
+    record_manager addresses_lookup_manager_;
+    record_map addresses_lookup_map_;
+
+    /// List of account hash rows of each address.
+    memory_map addresses_rows_file_;
+    record_manager addresses_rows_manager_;
+    record_list addresses_rows_list_;
+    record_multiple_map addresses_rows_multimap_;
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
@@ -19,11 +19,15 @@
  * 2017.7.7 wangdongyun modify to 0.6.2
  * 1. modification in 0.6.1 must let user to resync block data from height 1. this will waste too long time.
  *    this version is enhanced to read block data from local block database not resysn block data from p2p network. 
+ *
+ * 0.6.3
+ * 1. add account transaction index (account_transaction_table/rows, address_account_table/rows) for listtxs.
+ *    created empty on upgrade, each account is indexed from its address business records on first use.
  */
-#define MVS_DATABASE_VERSION "0.6.2"
+#define MVS_DATABASE_VERSION "0.6.3"
 
 #define MVS_DATABASE_MAJOR_VERSION 0
 #define MVS_DATABASE_MINOR_VERSION 6
-#define MVS_DATABASE_PATCH_VERSION 2
+#define MVS_DATABASE_PATCH_VERSION 3
 
 #endif
@@ -24,6 +24,7 @@
 #include <metaverse/explorer/generated.hpp>
 #include <metaverse/explorer/parser.hpp>
 #include <metaverse/explorer/json_helper.hpp>
+#include <metaverse/explorer/json_writer.hpp>
 #include <metaverse/explorer/utility.hpp>
 #include <metaverse/explorer/version.hpp>
 #include <metaverse/explorer/commands/fetch-history.hpp>
@@ -69,6 +69,19 @@ BCX_API console_result dispatch_command(int argc, const char* argv[],
     Json::Value& jv_output, 
     bc::server::server_node& node, uint8_t api_version = 1);
 
+/**
+ * Invoke the command identified by symbol with json-rpc 2.0 params, bound
+ * to the command options and arguments without an argv round-trip.
+ * @param[in]  symbol  The command symbolic name.
+ * @param[in]  params  Options object and positional argument values.
+ * @param[in]  node server_node instance.
+ * @param[in]  command version, defaults to v2.
+ * @return            The appropriate console return code { -1, 0, 1 }.
+ */
+BCX_API console_result dispatch_command(const std::string& symbol,
+    const Json::Value& params, Json::Value& jv_output,
+    bc::server::server_node& node, uint8_t api_version = 2);
+
 } // namespace explorer
 } // namespace libbitcoin
 
@@ -73,7 +73,12 @@ public:
             "ADMINAUTH",
             value<std::string>(&auth_.auth),
             BX_ADMIN_AUTH
-	    );
+	    )
+        (
+            "longpoll,l",
+            value<std::string>(&option_.longpoll),
+            "The header hash of the work already held. Over HTTP the call waits until the work changes or times out."
+        );
 
 
         return options;
@@ -92,6 +97,7 @@ public:
 
     struct option
     {
+        std::string longpoll;
     } option_;
 
 };
@@ -32,6 +32,7 @@
 #include <metaverse/explorer/config/point.hpp>
 #include <metaverse/explorer/config/transaction.hpp>
 #include <metaverse/explorer/config/wrapper.hpp>
+#include <metaverse/explorer/json_writer.hpp>
 
 #include <jsoncpp/json/json.h>
 
@@ -110,6 +111,13 @@ Json::Value prop_value_list(const std::string& name, const Values& values,
  */
 BCX_API Json::Value prop_list(const header& header);
 
+/**
+ * Write the property list for a block header, without building a tree.
+ * @param[in]  writer  The writer receiving the property list.
+ * @param[in]  header  The header.
+ */
+BCX_API void prop_list(json_writer& writer, const header& header);
+
 /**
  * Generate a property tree for a block header.
  * @param[in]  header  The header.
@@ -273,6 +281,17 @@ BCX_API Json::Value prop_tree(const chain::points_info& points_info, bool json);
  */
 BCX_API Json::Value prop_list(const transaction& transaction, bool json);
 BCX_API Json::Value prop_list(const transaction& transaction, uint64_t tx_height, bool json);
+
+/**
+ * Write the property list for a confirmed transaction, without building a
+ * tree for the transaction (inputs and outputs are built one at a time).
+ * @param[in]  writer       The writer receiving the property list.
+ * @param[in]  transaction  The transaction.
+ * @param[in]  tx_height    The height of the containing block.
+ * @param[in]  json         Use json array formatting.
+ */
+BCX_API void prop_list(json_writer& writer, const transaction& transaction,
+    uint64_t tx_height, bool json);
 /**
  * Generate a property tree for a transaction.
  * @param[in]  transaction  The transaction.
@@ -408,6 +427,13 @@ BCX_API Json::Value prop_tree(const wallet::bitcoin_uri& uri);
 BCX_API Json::Value prop_tree(const block& block, bool json, bool tx_json);
 
 private:
+    // Visit the members of a property list, in key order, so that the tree
+    // and the streaming writer are generated from one declaration.
+    template <typename Fields>
+    void visit(Fields& fields, const chain::header& header);
+    template <typename Fields>
+    void visit(Fields& fields, const tx_type& tx, uint64_t tx_height);
+
     uint8_t version_{ 1 }; //1 - api v1; 2 - api v2;
 };
 
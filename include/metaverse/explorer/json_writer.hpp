@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse-explorer.
+ *
+ * metaverse-explorer is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BX_JSON_WRITER_HPP
+#define BX_JSON_WRITER_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <metaverse/explorer/define.hpp>
+
+#include <jsoncpp/json/json.h>
+
+namespace libbitcoin {
+namespace explorer {
+namespace config {
+
+/**
+ * Compact json writer emitting directly into a stream, without indentation
+ * and without building an intermediate string. Members are written in call
+ * order; callers matching Json::Value output write them sorted by key.
+ */
+class BCX_API json_writer
+{
+public:
+    explicit json_writer(std::ostream& stream);
+
+    json_writer& begin_object();
+    json_writer& end_object();
+    json_writer& begin_array();
+    json_writer& end_array();
+
+    /// Write the name of the next object member.
+    json_writer& key(const std::string& name);
+
+    json_writer& null();
+    json_writer& value(bool value);
+    json_writer& value(int32_t value);
+    json_writer& value(uint32_t value);
+    json_writer& value(int64_t value);
+    json_writer& value(uint64_t value);
+    json_writer& value(double value);
+    json_writer& value(const char* value);
+    json_writer& value(const std::string& value);
+
+    /// Write a tree, compact, as one value.
+    json_writer& value(const Json::Value& tree);
+
+    /// Write one value that is already encoded as json.
+    json_writer& raw(const std::string& json);
+
+    template <typename Value>
+    json_writer& member(const std::string& name, const Value& value)
+    {
+        return key(name).value(value);
+    }
+
+private:
+    void separate();
+    void write_string(const char* data, size_t size);
+
+    std::ostream& stream_;
+
+    // Whether a value has been written at each open nesting level.
+    std::vector<bool> written_;
+    bool keyed_;
+};
+
+/// Serialize a tree compactly, replacing toStyledString for transport.
+BCX_API std::string write_compact(const Json::Value& tree);
+
+} // namespace config
+} // namespace explorer
+} // namespace libbitcoin
+
+#endif
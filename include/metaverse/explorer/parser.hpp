@@ -21,6 +21,7 @@
 #ifndef BX_PARSER_HPP
 #define BX_PARSER_HPP
 
+#include <functional>
 #include <iostream>
 #include <string>
 #include <boost/filesystem.hpp>
@@ -46,6 +47,11 @@ public:
     virtual bool parse(std::string& out_error, std::istream& input,
         int argc, const char* argv[]);
 
+    /// Parse all configuration into member settings, with the command line
+    /// bound directly from json-rpc params (options object and arguments).
+    virtual bool parse(std::string& out_error, std::istream& input,
+        const Json::Value& params);
+
     virtual bool help() const;
 
     /// Load command line options (named).
@@ -64,7 +70,13 @@ protected:
     virtual void load_command_variables(variables_map& variables,
         std::istream& input, int argc, const char* argv[]);
 
+    virtual void load_json_variables(variables_map& variables,
+        std::istream& input, const Json::Value& params);
+
 private:
+    bool parse(std::string& out_error,
+        std::function<void(variables_map&)> load_command);
+
     static std::string system_config_directory();
     static boost::filesystem::path default_config_path();
 
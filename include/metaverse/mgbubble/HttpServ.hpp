@@ -1,12 +1,23 @@
 
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <metaverse/mgbubble/Mongoose.hpp>
 #include <metaverse/mgbubble/MgServer.hpp>
+#include <metaverse/mgbubble/RpcCache.hpp>
+#include <metaverse/mgbubble/RpcWorkers.hpp>
 #include <metaverse/mgbubble/utility/Stream_buf.hpp>
 #include <metaverse/mgbubble/utility/Tokeniser.hpp>
 #include <metaverse/mgbubble/exception/Instances.hpp>
 
 #include <metaverse/client.hpp>
 #include <metaverse/blockchain.hpp>
+#include <metaverse/explorer/extensions/exception.hpp>
+#include <metaverse/explorer/json_writer.hpp>
 #include <metaverse/server/services/query_service.hpp> //public_query
 
 namespace libbitcoin{
@@ -23,12 +34,7 @@ class HttpServ : public MgServer
 {
     typedef MgServer base;
 public:
-    explicit HttpServ(const char* webroot, libbitcoin::server::server_node &node, const std::string& srv_addr)
-        : node_(node), MgServer(srv_addr)
-    {
-        document_root_ = webroot;
-        set_document_root(document_root_.c_str());
-    }
+    explicit HttpServ(const char* webroot, libbitcoin::server::server_node &node, const std::string& srv_addr);
     ~HttpServ() noexcept { stop(); };
 
     // Copy.
@@ -46,6 +52,10 @@ public:
     void reset(HttpMessage& data) noexcept;
 
     bool start() override;
+    void stop() override;
+
+    RpcWorkers::Statistics rpc_statistics() const { return workers_.statistics(); }
+    RpcCache::Statistics rpc_cache_statistics() const { return cache_.statistics(); }
 
     void spawn_to_mongoose(const std::function<void(uint64_t)>&& handler);
 
@@ -56,8 +66,70 @@ protected:
     void on_notify_handler(struct mg_connection& nc, struct mg_event& ev) override;
     void on_ws_handshake_done_handler(struct mg_connection& nc) override;
     void on_ws_frame_handler(struct mg_connection& nc, struct websocket_message& msg) override;
+    void on_timer_handler(struct mg_connection& nc) override;
+    void on_close_handler(struct mg_connection& nc) override;
+    void ev_handler_default(struct mg_connection* nc, int ev, void* ev_data) override;
 
 private:
+    // A getwork call held until the work changes or the poll times out.
+    struct LongPoll {
+        int64_t jsonrpc_id;
+        uint8_t rpc_version;
+        bool close;
+        double deadline;
+    };
+
+    // An rpc call executed by the workers, answered in arrival order on its connection.
+    struct RpcCall {
+        mg_connection* nc;
+        std::vector<std::string> args;
+        Json::Value params; // v2, bound to the command without argv.
+        int64_t jsonrpc_id{-1};
+        uint8_t rpc_version{1};
+        bool websocket{false};
+        bool close{false};
+        double deadline{0};
+        bool done{false};
+        std::atomic<bool> abandoned{false};
+        console_result retcode{console_result::failure};
+        Json::Value output;
+        std::exception_ptr error;
+
+        // A cacheable call, the result rendered once and shared by later hits.
+        std::string cache_key;
+        uint64_t cache_generation{0};
+        RpcCache::Rendered rendered;
+
+        // Json-rpc 2.0 batch, answered as one array once every element is done.
+        std::vector<std::shared_ptr<RpcCall>> batch;
+        std::weak_ptr<RpcCall> batch_parent;
+        size_t pending{0};
+    };
+    typedef std::shared_ptr<RpcCall> RpcCallPtr;
+
+    void submit_rpc(mg_connection& nc, RpcCallPtr call);
+    void submit_batch(mg_connection& nc, RpcCallPtr call, const HttpMessage& data, const Json::Value& requests);
+    void dispatch_rpc(RpcCallPtr call);
+    void abandon_rpc(RpcCall& call);
+    void execute_rpc(RpcCallPtr call);
+    void complete_rpc(RpcCallPtr call);
+    void expire_rpc_calls(mg_connection& nc);
+    void flush_rpc_calls(mg_connection& nc);
+    void rearm_timer(mg_connection& nc);
+    void rpc_respond(mg_connection& nc, const RpcCall& call);
+    void ws_respond(mg_connection& nc, const RpcCall& call);
+    void rpc_response(explorer::config::json_writer& writer, const RpcCall& call);
+    void route_http_request(mg_connection& nc, http_message& msg);
+    void parse_pipelined(mg_connection& nc);
+
+    void rpc_result(const Json::Value& jv_output, int64_t jsonrpc_id, uint8_t rpc_version);
+    void rpc_rendered(const std::string& rendered, int64_t jsonrpc_id, uint8_t rpc_version);
+    void rpc_error(const explorer::explorer_exception& e, int64_t jsonrpc_id, uint8_t rpc_version);
+
+    bool park_long_poll(mg_connection& nc, const RpcCall& call);
+    void resume_long_poll(mg_connection& nc);
+    void resume_long_polls();
+
     enum : int {
       // Method values are represented as powers of two for simplicity.
       MethodGet = 1 << 0,
@@ -83,6 +155,14 @@ private:
     const char* const servername_{"Metaverse " MVS_VERSION};
     libbitcoin::server::server_node &node_;
     string document_root_;
+
+    RpcWorkers workers_;
+    RpcCache cache_;
+
+    // Only accessed on the mongoose thread.
+    std::unordered_map<mg_connection*, LongPoll> long_polls_;
+    std::unordered_map<mg_connection*, std::deque<RpcCallPtr>> rpc_calls_;
+    std::unordered_map<mg_connection*, std::string> pipelined_;
 };
 
 } // mgbubble
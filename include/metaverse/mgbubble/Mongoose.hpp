@@ -18,6 +18,7 @@
 #define MVSD_MONGOOSE_HPP
 
 #include <vector>
+#include <jsoncpp/json/json.h>
 #include <metaverse/mgbubble/utility/Queue.hpp>
 #include <metaverse/mgbubble/utility/String.hpp>
 #include <metaverse/mgbubble/exception/Error.hpp>
@@ -91,6 +92,9 @@ public:
     const int64_t jsonrpc_id() const noexcept { return jsonrpc_id_; }
 
     void data_to_arg(uint8_t rpc_version) override;
+
+    // Convert one parsed json-rpc request object, a batch element or the body.
+    void request_to_arg(const Json::Value& root, uint8_t rpc_version);
     
 private:
     int64_t jsonrpc_id_;
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ * Copyright (C) 2013, 2016 Swirly Cloud Limited.
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#ifndef MVSD_RPC_CACHE_HPP
+#define MVSD_RPC_CACHE_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <jsoncpp/json/json.h>
+
+namespace mgbubble {
+
+/**
+ * Pre-rendered results of read-only rpc methods, keyed by version, method,
+ * normalized parameters and chain tip. The tip is a generation advanced on
+ * every reorganization, which drops all entries, and a result computed at an
+ * older generation is not stored. Entries also expire after a short age, as
+ * some results (peers, hash rate) change without a new block. The least
+ * recently used entries are evicted beyond the entry and byte limits.
+ */
+class RpcCache
+{
+public:
+    typedef std::shared_ptr<const std::string> Rendered;
+
+    struct Statistics {
+        size_t entries;
+        size_t bytes;
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        uint64_t invalidations;
+    };
+
+    /// A zero entry limit disables the cache.
+    RpcCache(size_t max_entries, size_t max_bytes, std::chrono::seconds max_age);
+
+    // Copy.
+    RpcCache(const RpcCache& rhs) = delete;
+    RpcCache& operator=(const RpcCache& rhs) = delete;
+
+    bool enabled() const { return max_entries_ != 0; }
+
+    /// Whether the results of the method depend only on the chain tip.
+    static bool cacheable(const std::string& method);
+
+    /// The key of a v1 command line or of a v2 method and its parameters.
+    static std::string key(uint8_t rpc_version, const std::vector<std::string>& args,
+        const Json::Value& params);
+
+    /// The tip generation, read before the command executes.
+    uint64_t generation() const;
+
+    /// The rendered result, nullptr (and a miss) if not cached.
+    Rendered find(const std::string& key);
+
+    /// Store a result unless the tip has moved past its generation.
+    void insert(const std::string& key, uint64_t generation, Rendered rendered);
+
+    /// Drop every entry, called on a new tip.
+    void invalidate();
+
+    Statistics statistics() const;
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    struct Entry {
+        std::string key;
+        Rendered rendered;
+        clock::time_point expires;
+    };
+
+    typedef std::list<Entry> Lru;
+
+    void erase(Lru::iterator it);
+
+    const size_t max_entries_;
+    const size_t max_bytes_;
+    const std::chrono::seconds max_age_;
+
+    // Protected by mutex, the most recently used entry is at the front.
+    Lru lru_;
+    std::unordered_map<std::string, Lru::iterator> index_;
+    size_t bytes_{0};
+    uint64_t generation_{0};
+    uint64_t hits_{0};
+    uint64_t misses_{0};
+    uint64_t evictions_{0};
+    uint64_t invalidations_{0};
+    mutable std::mutex mutex_;
+};
+
+} // mgbubble
+
+#endif
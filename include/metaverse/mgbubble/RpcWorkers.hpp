@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ * Copyright (C) 2013, 2016 Swirly Cloud Limited.
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#ifndef MVSD_RPC_WORKERS_HPP
+#define MVSD_RPC_WORKERS_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace mgbubble {
+
+/**
+ * Bounded pool of threads executing rpc commands off the mongoose loop.
+ * Jobs are submitted under a group (usually the method name) and each group
+ * has a concurrency limit. A job whose group is at its limit waits in the
+ * queue without holding up jobs of other groups behind it.
+ */
+class RpcWorkers
+{
+public:
+    typedef std::function<void()> Job;
+
+    struct Statistics {
+        size_t threads;
+        size_t queued;
+        size_t queued_peak;
+        size_t running;
+        uint64_t completed;
+        uint64_t rejected;
+        uint64_t timed_out;
+        uint64_t undelivered;
+    };
+
+    RpcWorkers(size_t threads, size_t max_queue, size_t default_limit);
+    ~RpcWorkers();
+
+    // Copy.
+    RpcWorkers(const RpcWorkers& rhs) = delete;
+    RpcWorkers& operator=(const RpcWorkers& rhs) = delete;
+
+    /// Set the concurrency limit of a group, call before start.
+    void set_limit(const std::string& group, size_t limit);
+
+    void start();
+    void stop();
+
+    /// Queue a job, false if the queue is full or the pool is stopped.
+    bool submit(const std::string& group, Job job);
+
+    /// Count a request answered with a timeout before its job completed.
+    void timed_out();
+
+    /// Count a completion that could not be handed to the http thread.
+    void undelivered();
+
+    Statistics statistics() const;
+
+private:
+    struct Pending {
+        std::string group;
+        Job job;
+    };
+
+    typedef std::deque<Pending> Queue;
+
+    void work();
+    size_t limit(const std::string& group) const;
+    Queue::iterator next_runnable();
+
+    const size_t threads_;
+    const size_t max_queue_;
+    const size_t default_limit_;
+
+    // Protected by mutex.
+    std::unordered_map<std::string, size_t> limits_;
+    std::unordered_map<std::string, size_t> running_;
+    Queue queue_;
+    size_t queued_peak_{0};
+    size_t running_count_{0};
+    uint64_t completed_{0};
+    uint64_t rejected_{0};
+    uint64_t timed_out_{0};
+    uint64_t undelivered_{0};
+    bool stopped_{true};
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+
+    std::vector<std::thread> workers_;
+};
+
+} // mgbubble
+
+#endif
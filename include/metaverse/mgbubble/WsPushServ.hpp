@@ -23,8 +23,10 @@
 #include <mutex>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/mgbubble/MgServer.hpp>
+#include <metaverse/server/utility/publisher.hpp>
 
 namespace libbitcoin {
     namespace server {
@@ -65,8 +67,8 @@ private:
 };
 
 class WsPushServ : public MgServer {
-    typedef bc::chain::point::indexes index_list;
-    typedef bc::message::block_message::ptr_list block_list;
+    typedef bc::server::publication publication;
+    typedef bc::server::published_transaction published_transaction;
     typedef MgServer base;
 
 public:
@@ -81,19 +83,23 @@ public:
     void spawn_to_mongoose(const std::function<void(uint64_t)>&& handler);
 
 protected:
-    bool handle_blockchain_reorganization(const bc::code& ec, uint64_t fork_point, const block_list& new_blocks, const block_list&);
-    bool handle_transaction_pool(const bc::code& ec, const index_list&, bc::message::transaction_message::ptr tx);
+    bool handle_publication(const bc::code& ec, publication::ptr value);
 
-    void notify_blocks(uint32_t fork_point, const block_list& blocks);
-    void notify_block(uint32_t height, const bc::chain::block::ptr block);
+    void notify_transaction(uint64_t sequence, published_transaction::ptr tx);
+    void replay_transactions(mg_connection& nc, uint64_t sequence, size_t addr_hash);
 
-    void notify_transaction(uint32_t height, const bc::hash_digest& block_hash, const bc::chain::transaction& tx);
+    // called on mongoose thread
+    void notify_work();
+    bool work_response(Json::Value& root);
 
 protected:
     void send_bad_response(struct mg_connection& nc, const char* message = nullptr, int code = 1000001, Json::Value data = Json::nullValue);
     void send_response(struct mg_connection& nc, const std::string& event, const std::string& channel);
 
-    void refresh_connections();
+    // Transaction subscription index, called with subscribers_lock_ held.
+    bool subscribe_address(mg_connection& nc, uint64_t connection_id, size_t addr_hash);
+    void unsubscribe_addresses(mg_connection& nc);
+    void unindex_addresses(mg_connection& nc, const std::vector<size_t>& addresses);
 
 protected:
     void run() override;
@@ -106,9 +112,31 @@ protected:
     void on_notify_handler(struct mg_connection& nc, struct mg_event& ev) override;
 
 private:
+    struct Subscription {
+        uint64_t connection_id;
+        std::vector<size_t> addresses; // empty is all transactions
+    };
+
+    // A matched connection, the id detects reuse of a closed connection's address.
+    struct Target {
+        mg_connection* nc;
+        uint64_t connection_id;
+
+        bool operator<(const Target& other) const { return nc < other.nc; }
+        bool operator==(const Target& other) const { return nc == other.nc; }
+    };
+
     libbitcoin::server::server_node& node_;
-    std::unordered_map<void*, std::shared_ptr<mg_connection>> map_connections_;
-    std::map<std::weak_ptr<mg_connection>, std::vector<size_t>, std::owner_less<std::weak_ptr<mg_connection>>> subscribers_;
+
+    // connections and work subscribers are only touched on mongoose thread
+    std::unordered_map<mg_connection*, uint64_t> connections_;
+    uint64_t connection_sequence_{0};
+    std::unordered_set<mg_connection*> work_subscribers_;
+
+    // transaction subscriptions, indexed by address hash
+    std::unordered_map<mg_connection*, Subscription> subscriptions_;
+    std::unordered_map<size_t, std::unordered_set<mg_connection*>> address_subscribers_;
+    std::unordered_set<mg_connection*> all_subscribers_;
     std::mutex subscribers_lock_;
 };
 }
@@ -43,7 +43,6 @@ class StreamBuf : public std::streambuf {
 
   const char_type* data() const noexcept { return buf_.buf; }
   std::streamsize size() const noexcept { return buf_.len; }
-  void reset() noexcept;
   void setContentLength(size_t pos, size_t len) noexcept;
 
  protected:
@@ -79,6 +78,7 @@ class OStream : public std::ostream {
   void setContentLength() noexcept;
 
  private:
+  size_t begin_{0};
   size_t headSize_{0};
   size_t lengthAt_{0};
 };
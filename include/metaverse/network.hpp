@@ -16,6 +16,7 @@
 
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/network/acceptor.hpp>
+#include <metaverse/network/ban_table.hpp>
 #include <metaverse/network/channel.hpp>
 #include <metaverse/network/connections.hpp>
 #include <metaverse/network/connector.hpp>
@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_NETWORK_BAN_TABLE_HPP
+#define MVS_NETWORK_BAN_TABLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// Bounded, expiring table of banned peer addresses, thread safe.
+/// Entries are keyed by ip, the port is ignored, and spread over shards so
+/// that concurrent checks do not contend on a single lock. Expired entries
+/// are swept by a coarse time wheel as bans are added.
+class BCT_API ban_table
+{
+public:
+    /// The process-wide table shared by acceptor, connector and sessions.
+    static ban_table& instance();
+
+    ban_table(size_t capacity, uint32_t ban_seconds);
+
+    /// This class is not copyable.
+    ban_table(const ban_table&) = delete;
+    void operator=(const ban_table&) = delete;
+
+    /// Ban the address of the authority for the default duration.
+    void ban(const config::authority& authority);
+
+    /// Ban the address of the authority for the given duration.
+    void ban(const config::authority& authority, uint32_t seconds);
+
+    /// True if the address of the authority is banned and unexpired.
+    bool banned(const config::authority& authority) const;
+
+    /// The number of entries, including those expired but not yet swept.
+    size_t size() const;
+
+private:
+    typedef message::ip_address key;
+    typedef std::vector<key> slot;
+
+    struct key_hash
+    {
+        size_t operator()(const key& value) const;
+    };
+
+    struct shard
+    {
+        shard();
+
+        std::unordered_map<key, int64_t, key_hash> expiries;
+        std::vector<slot> wheel;
+        int64_t cursor;
+        mutable upgrade_mutex mutex;
+    };
+
+    static constexpr size_t shard_count = 16;
+    static constexpr size_t wheel_slots = 64;
+
+    shard& find_shard(const key& address);
+    const shard& find_shard(const key& address) const;
+    size_t slot_index(int64_t millisecond) const;
+    void unschedule(shard& shard, const key& address, int64_t expiry);
+    void sweep(shard& shard, int64_t now);
+    void evict(shard& shard);
+
+    const size_t shard_capacity_;
+    const uint32_t ban_seconds_;
+    const int64_t slot_milliseconds_;
+    std::array<shard, shard_count> shards_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -54,6 +54,13 @@ public:
     virtual uint64_t nonce() const;
     virtual void set_nonce(uint64_t value);
 
+    /// Record that the peer has the inventory (it sent, announced or was
+    /// sent it), so that it is not announced to or requested from it again.
+    virtual void set_known(const hash_digest& hash);
+
+    /// True if the peer (probably) has the inventory.
+    virtual bool known(const hash_digest& hash) const;
+
     void set_protocol_start_handler(std::function<void()> handler);
 
     void invoke_protocol_start_handler(const code& ec);
@@ -76,6 +83,7 @@ private:
     deadline::ptr expiration_;
     deadline::ptr inactivity_;
     std::function<void()> protocol_start_handler_;
+    rolling_filter known_inventory_;
     upgrade_mutex mutex_;
 };
 
@@ -25,8 +25,10 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/network/channel.hpp>
@@ -63,10 +65,16 @@ public:
     void broadcast(const Message& message, channel_handler handle_channel,
         result_handler handle_complete)
     {
+        const auto channels = safe_copy();
+
         // We cannot use a synchronizer here because handler closure in loop.
-        auto counter = std::make_shared<std::atomic<size_t>>(channels_.size());
+        auto counter = std::make_shared<std::atomic<size_t>>(channels.size());
 
-        for (const auto channel: safe_copy())
+        // Serialize once per protocol version and magic, the wire buffer is
+        // reference counted and shared by the outbound queue of each channel.
+        std::map<std::pair<uint32_t, uint32_t>, const_buffer> buffers;
+
+        for (const auto channel: channels)
         {
             const auto handle_send = [=](code ec)
             {
@@ -76,8 +84,15 @@ public:
                     handle_complete(error::success);
             };
 
-            // No pre-serialize, channels may have different protocol versions.
-            channel->send(message, handle_send);
+            const auto key = std::make_pair(channel->protocol_version(),
+                channel->protocol_magic());
+
+            auto it = buffers.find(key);
+            if (it == buffers.end())
+                it = buffers.emplace(key, const_buffer(message::serialize(
+                    key.first, message, key.second))).first;
+
+            channel->send_buffer(message.command, it->second, handle_send);
         }
     }
 
@@ -102,9 +117,13 @@ public:
         truth_handler handler) const;
     config::authority::list authority_list();
 
-private:
     typedef std::vector<channel::ptr> list;
 
+    /// A snapshot of the active channels.
+    list channel_list() const;
+
+private:
+
     list safe_copy() const;
     size_t safe_count() const;
     code safe_store(channel::ptr channel);
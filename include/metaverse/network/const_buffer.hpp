@@ -42,12 +42,15 @@ public:
     explicit const_buffer(data_chunk&& data);
     explicit const_buffer(const data_chunk& data);
 
+    /// Share an immutable buffer without copying it.
+    explicit const_buffer(std::shared_ptr<const data_chunk> data);
+
     size_t size() const;
     const_iterator begin() const;
     const_iterator end() const;
 
 private:
-    std::shared_ptr<data_chunk> data_;
+    std::shared_ptr<const data_chunk> data_;
     value_type buffer_;
 };
 
@@ -116,9 +116,24 @@ public:
     template <class Message, class Subscriber>
     code relay(std::istream& stream, uint32_t version,
         Subscriber subscriber) const
+    {
+        istream_reader source(stream);
+        return relay<Message>(source, version, subscriber);
+    }
+
+    /**
+     * Load a reader into a message instance and notify subscribers.
+     * @param[in]  source      The reader from which to load the message.
+     * @param[in]  version  The peer protocol version.
+     * @param[in]  subscriber  The subscriber for the message type.
+     * @return                 Returns error::bad_stream if failed.
+     */
+    template <class Message, class Subscriber>
+    code relay(reader& source, uint32_t version,
+        Subscriber subscriber) const
     {
         const auto message_ptr = std::make_shared<Message>();
-        const bool parsed = message_ptr->from_data(version, stream);
+        const bool parsed = message_ptr->from_data(version, source);
         const code ec(parsed ? error::success : error::bad_stream);
         subscriber->relay(ec, message_ptr);
         return ec;
@@ -134,9 +149,24 @@ public:
     template <class Message, class Subscriber>
     code handle(std::istream& stream, uint32_t version,
         Subscriber subscriber) const
+    {
+        istream_reader source(stream);
+        return handle<Message>(source, version, subscriber);
+    }
+
+    /**
+     * Load a reader into a message instance and invoke subscribers.
+     * @param[in]  source      The reader from which to load the message.
+     * @param[in]  version  The peer protocol version.
+     * @param[in]  subscriber  The subscriber for the message type.
+     * @return                 Returns error::bad_stream if failed.
+     */
+    template <class Message, class Subscriber>
+    code handle(reader& source, uint32_t version,
+        Subscriber subscriber) const
     {
         const auto message_ptr = std::make_shared<Message>();
-        const bool parsed = message_ptr->from_data(version, stream);
+        const bool parsed = message_ptr->from_data(version, source);
         const code ec(parsed ? error::success : error::bad_stream);
         subscriber->invoke(ec, message_ptr);
         return ec;
@@ -160,6 +190,18 @@ public:
     virtual code load(message::message_type type, uint32_t version,
         std::istream& stream) const;
 
+    /*
+     * Load a message of the specified command type from a reader.
+     * Creates an instance of the indicated message type.
+     * Sends the message instance to each subscriber of the type.
+     * @param[in]  type     The stream message type identifier.
+     * @param[in]  version  The peer protocol version.
+     * @param[in]  source   The reader from which to load the message.
+     * @return              Returns error::bad_stream if failed.
+     */
+    virtual code load(message::message_type type, uint32_t version,
+        reader& source) const;
+
     /**
      * Start all subscribers so that they accept subscription.
      */
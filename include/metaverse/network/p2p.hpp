@@ -131,6 +131,15 @@ public:
     /// Return a reference to the network threadpool.
     virtual threadpool& thread_pool();
 
+    /// Inventory recently requested or received from any channel.
+    virtual rolling_filter& recent_inventory();
+
+    /// Inventory requested from a channel and not yet delivered.
+    virtual inventory_requests& requested_inventory();
+
+    /// Channels whose peer pushes new blocks to us as compact blocks.
+    virtual std::atomic<size_t>& high_bandwidth_peers();
+
     // Subscriptions.
     // ------------------------------------------------------------------------
 
@@ -235,6 +244,9 @@ private:
     std::atomic<size_t> height_;
     bc::atomic<session_manual::ptr> manual_;
     threadpool threadpool_;
+    rolling_filter recent_inventory_;
+    inventory_requests requested_inventory_;
+    std::atomic<size_t> high_bandwidth_peers_;
     hosts::ptr hosts_;
     connections::ptr connections_;
     stop_subscriber::ptr stop_subscriber_;
@@ -81,6 +81,14 @@ protected:
             BOUND_PROTOCOL(handler, args));
     }
 
+    /// Send a message already serialized for this channel's magic.
+    template <class Protocol, typename Handler, typename... Args>
+    void send_buffer(const std::string& command, const_buffer buffer,
+        Handler&& handler, Args&&... args)
+    {
+        channel_->send_buffer(command, buffer, BOUND_PROTOCOL(handler, args));
+    }
+
     /// Subscribe to all channel messages, blocking until subscribed.
     template <class Protocol, class Message, typename Handler, typename... Args>
     void subscribe(Handler&& handler, Args&&... args)
@@ -104,6 +112,12 @@ protected:
     /// Get the channel nonce.
     virtual uint64_t nonce() const;
 
+    /// Record that the peer has the inventory.
+    virtual void set_known(const hash_digest& hash);
+
+    /// True if the peer (probably) has the inventory.
+    virtual bool known(const hash_digest& hash) const;
+
     /// Get the peer version message. This method is NOT thread safe and must
     /// not be called if any other thread could write the peer version.
     virtual message::version peer_version() const;
@@ -114,6 +128,9 @@ protected:
 
     uint32_t peer_start_height();
 
+    /// Get the magic used to serialize messages on the channel.
+    uint32_t protocol_magic() const;
+
     /// Get the threadpool.
     virtual threadpool& pool();
 
@@ -149,6 +166,9 @@ private:
 #define SEND3(message, method, p1, p2, p3) \
     send<CLASS>(message, &CLASS::method, p1, p2, p3)
 
+#define SEND_BUFFER2(command, buffer, method, p1, p2) \
+    send_buffer<CLASS>(command, buffer, &CLASS::method, p1, p2)
+
 #define SUBSCRIBE2(message, method, p1, p2) \
     subscribe<CLASS, message>(&CLASS::method, p1, p2)
 #define SUBSCRIBE3(message, method, p1, p2, p3) \
@@ -24,11 +24,13 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/network/const_buffer.hpp>
 #include <metaverse/network/define.hpp>
@@ -51,7 +53,6 @@ public:
     typedef subscriber<const code&> stop_subscriber;
     typedef resubscriber<const code&, const std::string&, const_buffer,
         result_handler> send_subscriber;
-    using request_callback = std::function<void()>;
 
     /// Construct an instance.
     proxy(threadpool& pool, socket::ptr socket, uint32_t protocol_magic,
@@ -73,6 +74,20 @@ public:
         do_send(message.command, buffer, handler);
     }
 
+    /// Send a message already serialized for this proxy's version and magic.
+    void send_buffer(const std::string& command, const_buffer buffer,
+        result_handler handler);
+
+    /// The protocol version and magic used to serialize outgoing messages.
+    uint32_t protocol_version() const;
+    uint32_t protocol_magic() const;
+
+    /// Outbound metrics: bytes waiting to be written, vectored writes
+    /// issued and bytes written on this channel.
+    size_t outbound_bytes() const;
+    uint64_t outbound_flushes() const;
+    uint64_t outbound_bytes_sent() const;
+
     /// Subscribe to messages of the specified type on the socket.
     template <class Message>
     void subscribe(message_handler<Message>&& handler)
@@ -113,9 +128,6 @@ protected:
     virtual void handle_stopping() = 0;
 
 private:
-    typedef byte_source<data_chunk> payload_source;
-    typedef boost::iostreams::stream<payload_source> payload_stream;
-
     static config::authority authority_factory(socket::ptr socket);
 
     void do_close();
@@ -128,12 +140,22 @@ private:
     void handle_read_payload(const boost_code& ec, size_t,
         const message::heading& head);
 
+    struct outbound
+    {
+        const_buffer buffer;
+        result_handler handler;
+    };
+
+    typedef std::deque<outbound> outbound_queue;
+    typedef std::shared_ptr<std::vector<outbound>> outbound_batch;
+
     void do_send(const std::string& command, const_buffer buffer,
         result_handler handler);
-    void handle_send(const boost_code& ec, const_buffer buffer,
-        result_handler handler);
+    void write_batch(locked_socket::ptr socket);
+    void handle_send(const boost_code& ec, size_t bytes,
+        outbound_batch batch);
 
-    void handle_request(data_chunk payload_buffer, uint32_t protocol_version_, message::heading head, size_t payload_size);
+    void handle_request(const data_chunk& payload_buffer, uint32_t protocol_version_, const message::heading& head, size_t payload_size);
 
     const uint32_t protocol_magic_;
     const uint32_t protocol_version_;
@@ -152,12 +174,16 @@ private:
     bc::atomic<message::version::ptr> peer_version_message_;
     message_subscriber message_subscriber_;
     stop_subscriber::ptr stop_subscriber_;
-    std::queue<request_callback> outbound_queue_;
-    std::atomic_bool has_sent_;
+
+    // These are protected by the socket lock.
+    outbound_queue outbound_queue_;
+    bool sending_;
+
+    std::atomic<size_t> outbound_bytes_;
+    std::atomic<uint64_t> outbound_flushes_;
+    std::atomic<uint64_t> outbound_bytes_sent_;
 
     std::atomic_int misbehaving_;
-    static boost::detail::spinlock spinlock_;
-    static std::map<config::authority, int64_t> banned_;
 };
 
 } // namespace network
@@ -87,6 +87,9 @@ public:
     /// Transaction pool interface.
     virtual blockchain::transaction_pool& pool();
 
+    /// Initial block download throughput, false if not synchronizing.
+    bool sync_statistics(reservations::sync_statistics& out) const;
+
     // Subscriptions.
     // ------------------------------------------------------------------------
 
@@ -121,6 +124,7 @@ private:
 
     // These are thread safe.
     header_queue hashes_;
+    bc::atomic<session_block_sync::ptr> block_sync_;
     const settings& settings_;
 protected:
     // fix me, for explorer only.
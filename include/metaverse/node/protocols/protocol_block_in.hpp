@@ -24,6 +24,7 @@
 #include <atomic>
 #include <cstddef>
 #include <memory>
+#include <vector>
 #include <metaverse/blockchain.hpp>
 #include <metaverse/network.hpp>
 #include <metaverse/node/define.hpp>
@@ -53,17 +54,28 @@ private:
     typedef message::headers::ptr headers_ptr;
     typedef message::inventory::ptr inventory_ptr;
     typedef message::not_found::ptr not_found_ptr;
+    typedef message::compact_block::ptr compact_block_ptr;
+    typedef message::block_transactions::ptr block_transactions_ptr;
     typedef message::block_message::ptr_list block_ptr_list;
 
     void get_block_inventory(const code& ec);
     void send_get_blocks(const hash_digest& stop_hash);
     void send_get_blocks(const hash_digest& from_hash, const hash_digest& to_hash);
     void send_get_data(const code& ec, get_data_ptr message);
+    void send_get_block(const hash_digest& hash);
 
     bool handle_receive_block(const code& ec, block_ptr message);
     bool handle_receive_headers(const code& ec, headers_ptr message);
     bool handle_receive_inventory(const code& ec, inventory_ptr message);
     bool handle_receive_not_found(const code& ec, not_found_ptr message);
+    bool handle_receive_compact_block(const code& ec,
+        compact_block_ptr message);
+    bool handle_receive_block_transactions(const code& ec,
+        block_transactions_ptr message);
+    void store_compact_block(block_ptr block);
+    bool take_high_bandwidth();
+    void release_high_bandwidth();
+    void handle_stop(const code&);
     void handle_filter_orphans(const code& ec, get_data_ptr message);
     void handle_store_block(const code& ec, block_ptr message);
     void handle_fetch_block_locator(const code& ec, const hash_list& locator,
@@ -72,10 +84,19 @@ private:
         const block_ptr_list& incoming, const block_ptr_list& outgoing);
 
     blockchain::block_chain& blockchain_;
+    rolling_filter& recent_;
     bc::atomic<hash_digest> last_locator_top_;
     bc::atomic<hash_digest> current_chain_top_;
     const bool headers_from_peer_;
     std::atomic_int headers_batch_size_;
+    const bool compact_from_peer_;
+    std::atomic<size_t>& high_bandwidth_peers_;
+    std::atomic<bool> high_bandwidth_;
+
+    // The compact block awaiting its missing transactions, if any.
+    block_ptr compact_pending_;
+    std::vector<uint64_t> compact_missing_;
+    mutable upgrade_mutex compact_mutex_;
 };
 
 } // namespace node
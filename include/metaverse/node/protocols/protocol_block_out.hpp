@@ -56,19 +56,31 @@ private:
     typedef message::get_blocks::ptr get_blocks_ptr;
     typedef message::get_headers::ptr get_headers_ptr;
     typedef message::send_headers::ptr send_headers_ptr;
+    typedef message::send_compact_blocks::ptr send_compact_blocks_ptr;
+    typedef message::get_block_transactions::ptr get_block_transactions_ptr;
     typedef message::merkle_block::ptr merkle_block_ptr;
     typedef message::block_message::ptr_list block_ptr_list;
     typedef chain::header::list header_list;
 
-    void send_block(const code& ec, chain::block::ptr block,
+    void send_block(const code& ec,
+        blockchain::block_message_cache::message_ptr message,
         const hash_digest& hash);
     void send_merkle_block(const code& ec, merkle_block_ptr message,
         const hash_digest& hash);
+    void send_compact_block(const code& ec, chain::block::ptr block,
+        const hash_digest& hash);
+    void send_block_transactions(const code& ec, chain::block::ptr block,
+        get_block_transactions_ptr request);
+    bool announce_compact_blocks(const block_ptr_list& incoming);
 
     bool handle_receive_get_data(const code& ec, get_data_ptr message);
     bool handle_receive_get_blocks(const code& ec, get_blocks_ptr message);
     bool handle_receive_get_headers(const code& ec, get_headers_ptr message);
     bool handle_receive_send_headers(const code& ec, send_headers_ptr message);
+    bool handle_receive_send_compact_blocks(const code& ec,
+        send_compact_blocks_ptr message);
+    bool handle_receive_get_block_transactions(const code& ec,
+        get_block_transactions_ptr message);
 
     void handle_fetch_locator_hashes(const code& ec, const hash_list& hashes);
     void handle_fetch_locator_headers(const code& ec, 
@@ -84,6 +96,8 @@ private:
     bc::atomic<hash_digest> last_locator_top_;
     std::atomic<size_t> current_chain_height_;
     std::atomic<bool> headers_to_peer_;
+    const bool compact_capable_;
+    std::atomic<bool> compact_to_peer_;
 };
 
 } // namespace node
@@ -64,9 +64,18 @@ private:
     bool handle_receive(const code& ec, headers_ptr message,
         event_handler complete);
 
+    void verify_headers(headers_ptr message, event_handler complete);
+    void verify_slice(headers_ptr message, size_t first, size_t last,
+        event_handler verified);
+    void handle_verified(const code& ec, headers_ptr message,
+        event_handler complete);
+
     // Thread safe and guarded by sequential header sync.
     header_queue& hashes_;
 
+    // Thread safe, used to verify header seals in parallel.
+    dispatcher dispatch_;
+
     // This is guarded by protocol_timer/deadline contract (exactly one call).
     size_t current_second_;
 
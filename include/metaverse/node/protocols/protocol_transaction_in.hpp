@@ -22,6 +22,7 @@
 #define MVS_NODE_PROTOCOL_TRANSACTION_IN_HPP
 
 #include <memory>
+#include <unordered_set>
 #include <metaverse/blockchain.hpp>
 #include <metaverse/network.hpp>
 #include <metaverse/node/define.hpp>
@@ -30,7 +31,7 @@ namespace libbitcoin {
 namespace node {
 
 class BCN_API protocol_transaction_in
-  : public network::protocol_events, track<protocol_transaction_in>
+  : public network::protocol_timer, track<protocol_transaction_in>
 {
 public:
     typedef std::shared_ptr<protocol_transaction_in> ptr;
@@ -49,6 +50,8 @@ private:
     typedef chain::point::indexes index_list;
     typedef message::get_data::ptr get_data_ptr;
     typedef message::inventory::ptr inventory_ptr;
+    typedef message::not_found::ptr not_found_ptr;
+    typedef std::unordered_set<hash_digest> hash_set;
     typedef message::transaction_message::ptr transaction_ptr;
     typedef message::block_message::ptr_list block_ptr_list;
     typedef message::block_message::ptr block_ptr;
@@ -57,19 +60,30 @@ private:
     void handle_filter_floaters(const code& ec, get_data_ptr message);
     bool handle_receive_inventory(const code& ec, inventory_ptr message);
     bool handle_receive_transaction(const code& ec, transaction_ptr message);
+    bool handle_receive_not_found(const code& ec, not_found_ptr message);
     void handle_store_confirmed(const code& ec, transaction_ptr message);
     void handle_store_validated(const code& ec, transaction_ptr message,
         const index_list& unconfirmed);
     bool handle_reorganized(const code& ec, size_t fork_point,
         const block_ptr_list& incoming, const block_ptr_list& outgoing);
 
+    void defer(const hash_digest& hash);
+    void send_deferred();
+
+    void handle_event(const code& ec);
     void handle_stop(const code&);
 
     blockchain::block_chain& blockchain_;
     blockchain::transaction_pool& pool_;
+    rolling_filter& recent_;
+    inventory_requests& requested_;
     const bool relay_from_peer_;
     const bool peer_suports_memory_pool_;
     const bool refresh_pool_;
+
+    // These are protected by mutex.
+    hash_set deferred_;
+    mutable unique_mutex deferred_mutex_;
 };
 
 } // namespace node
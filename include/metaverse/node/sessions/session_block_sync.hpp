@@ -47,6 +47,9 @@ public:
 
     virtual void start(result_handler handler);
 
+    /// The import throughput of the sync, for reporting.
+    reservations::sync_statistics statistics() const;
+
 protected:
     /// Overridden to attach and start specialized handshake.
     void attach_handshake_protocols(network::channel::ptr channel,
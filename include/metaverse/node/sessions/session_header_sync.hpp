@@ -24,6 +24,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 #include <metaverse/blockchain.hpp>
 #include <metaverse/network.hpp>
 #include <metaverse/node/define.hpp>
@@ -33,7 +34,9 @@
 namespace libbitcoin {
 namespace node {
     
-/// Class to manage initial header download connection, thread safe.
+/// Class to manage initial header download connections, thread safe.
+/// The range is partitioned at checkpoints and the partitions are downloaded
+/// from different peers concurrently, then merged in order.
 class BCN_API session_header_sync
   : public network::session_batch, track<session_header_sync>
 {
@@ -53,34 +56,58 @@ protected:
 
     /// Override to attach and start specialized protocols after handshake.
     virtual void attach_protocols(network::channel::ptr channel,
-        network::connector::ptr connect, result_handler handler);
+        network::connector::ptr connect, size_t index,
+        result_handler handler);
 
 private:
+    struct segment
+    {
+        config::checkpoint start;
+        config::checkpoint stop;
+        std::shared_ptr<header_queue> hashes;
+        bool active;
+        bool complete;
+    };
+
+    typedef std::vector<segment> segments;
+
     bool initialize(result_handler handler);
+    void partition(const config::checkpoint& seed);
+    bool reserve_segment(size_t& out_index, std::shared_ptr<header_queue>&
+        out_hashes, config::checkpoint& out_stop);
+    bool release_segment(size_t index);
+    bool complete_segment(size_t index);
+    bool unassigned() const;
+
     void handle_started(const code& ec, result_handler handler);
     void new_connection(network::connector::ptr connect,
         result_handler handler);
-    void start_syncing(const code& ec, const config::authority& host,
-        network::connector::ptr connect, result_handler handler);
     void handle_connect(const code& ec, network::channel::ptr channel,
         network::connector::ptr connect, result_handler handler);
-    void handle_complete(const code& ec, network::channel::ptr channel, network::connector::ptr connect,
+    void handle_complete(const code& ec, network::channel::ptr channel,
+        network::connector::ptr connect, size_t index,
         result_handler handler);
     void handle_channel_start(const code& ec, network::connector::ptr connect,
-        network::channel::ptr channel, result_handler handler);
-    void handle_channel_stop(const code& ec, network::connector::ptr connect, result_handler handler);
+        network::channel::ptr channel, size_t index, result_handler handler);
+    void handle_channel_stop(const code& ec, network::connector::ptr connect,
+        size_t index, result_handler handler);
     code get_range(config::checkpoint& out_seed, config::checkpoint& out_stop);
 
     // Thread safe.
     header_queue& hashes_;
+    std::atomic<uint32_t> minimum_rate_;
 
     // These do not require guard because they are not used concurrently.
-    uint32_t minimum_rate_;
     config::checkpoint last_;
     blockchain::simple_chain& blockchain_;
     const config::checkpoint::list checkpoints_;
     std::atomic_int try_count_;
     std::atomic_bool synced_;
+
+    // These are protected by mutex.
+    segments segments_;
+    size_t merged_;
+    mutable upgrade_mutex mutex_;
 };
 
 } // namespace node
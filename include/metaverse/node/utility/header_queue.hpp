@@ -69,6 +69,13 @@ public:
     /// Clear the queue and populate the hash at the given height.
     void initialize(const hash_digest& hash, size_t height);
 
+    /// Clear the queue and populate the start, reserving up to the stop.
+    void initialize(const config::checkpoint& start,
+        const config::checkpoint& stop);
+
+    /// Append a completed segment, the first hash of which is our last.
+    bool append(const header_queue& segment);
+
     /// Mark the heights if they exist.
     void invalidate(size_t first_height, size_t count);
 
@@ -24,6 +24,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <set>
 #include <vector>
 #include <boost/bimap.hpp>
 #include <boost/bimap/set_of.hpp>
@@ -61,6 +62,15 @@ public:
     /// The number of outstanding blocks.
     size_t size() const;
 
+    /// The number of outstanding blocks requested from the channel.
+    size_t in_flight() const;
+
+    /// The number of outstanding blocks not yet requested from the channel.
+    size_t unrequested() const;
+
+    /// The in-flight request limit, sized from the measured import rate.
+    size_t window() const;
+
     /// The reservation is empty and will remain so.
     bool stopped() const;
 
@@ -79,7 +89,8 @@ public:
     /// The current cached average block import rate excluding import time.
     void set_rate(const performance& rate);
 
-    /// The block data request message for the outstanding block hashes.
+    /// The block data request message for outstanding block hashes, up to
+    /// the window. Empty until half of the in-flight window has arrived.
     /// Set new if the preceding request was unsuccessful or discarded.
     message::get_data request(bool new_channel);
 
@@ -90,7 +101,7 @@ public:
     void insert(const hash_digest& hash, size_t height);
 
     /// Add to the blockchain, with height determined by the reservation.
-    void import(chain::block::ptr block);
+    bool import(chain::block::ptr block);
 
     /// Determine if the reservation was partitioned and reset partition flag.
     bool toggle_partitioned();
@@ -98,6 +109,10 @@ public:
     /// Move half of the reservation to the specified reservation.
     bool partition(reservation::ptr minimal);
 
+    /// Move half of the unrequested hashes to the specified reservation.
+    /// In-flight hashes are retained, so this channel need not restart.
+    bool surrender(reservation::ptr fast);
+
     /// If not stopped and if empty try to get more hashes.
     void populate();
 
@@ -157,6 +172,7 @@ private:
     bool pending_;
     bool partitioned_;
     hash_heights heights_;
+    std::set<uint32_t> requested_;
     mutable upgrade_mutex hash_mutex_;
 
     const size_t slot_;
@@ -21,6 +21,7 @@
 #define MVS_NODE_RESERVATIONS_HPP
 
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -45,6 +46,17 @@ public:
         double standard_deviation;
     } rate_statistics;
 
+    typedef struct
+    {
+        size_t active_count;
+        size_t imported;
+        size_t in_flight;
+        size_t remaining;
+        double blocks_per_second;
+        double average_blocks_per_second;
+        double database_ratio;
+    } sync_statistics;
+
     typedef std::shared_ptr<reservations> ptr;
 
     /// Construct a reservation table of reservations, allocating hashes evenly
@@ -55,6 +67,9 @@ public:
     /// The average and standard deviation of block import rates.
     rate_statistics rates() const;
 
+    /// The import throughput of the sync, for reporting.
+    sync_statistics statistics() const;
+
     /// Return a copy of the reservation table.
     reservation::list table() const;
 
@@ -64,6 +79,10 @@ public:
     /// Populate a starved row by taking half of the hashes from a weak row.
     bool populate(reservation::ptr minimal);
 
+    /// Give a fast row with nothing left to request the unrequested hashes
+    /// of the slowest row, ahead of that row's expiry.
+    bool steal(reservation::ptr fast);
+
     /// Remove the row from the reservation table if found.
     void remove(reservation::ptr row);
 
@@ -95,6 +114,9 @@ private:
     // Move the maximum unreserved hashes to the specified reservation.
     bool reserve(reservation::ptr minimal);
 
+    // Move unrequested hashes of the slowest row to the specified reservation.
+    bool take_unrequested(reservation::ptr fast);
+
     // Thread safe.
     header_queue& hashes_;
     blockchain::simple_chain& blockchain_;
@@ -105,6 +127,8 @@ private:
 
     const uint32_t timeout_;
     std::atomic<size_t> max_request_;
+    std::atomic<size_t> imported_;
+    const std::chrono::steady_clock::time_point started_;
 };
 
 } // namespace node
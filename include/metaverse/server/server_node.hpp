@@ -35,9 +35,13 @@
 #include <metaverse/server/services/query_service.hpp>
 #include <metaverse/server/services/transaction_service.hpp>
 #include <metaverse/server/utility/authenticator.hpp>
+#include <metaverse/server/utility/publisher.hpp>
+#include <metaverse/server/utility/query_statistics.hpp>
 #include <metaverse/server/workers/notification_worker.hpp>
 #include <metaverse/bitcoin/utility/path.hpp>
 #include <metaverse/consensus/miner.hpp>
+#include <metaverse/mgbubble/RpcCache.hpp>
+#include <metaverse/mgbubble/RpcWorkers.hpp>
 
 #include <boost/shared_ptr.hpp>
 
@@ -105,6 +109,18 @@ public:
     /// Get miner.
     virtual consensus::miner& miner();
 
+    /// Block and transaction publications, encoded once for all services.
+    virtual publisher& publications();
+
+    /// Statistics of the rpc execution pool.
+    mgbubble::RpcWorkers::Statistics rpc_statistics() const;
+
+    /// Statistics of the rpc result cache.
+    mgbubble::RpcCache::Statistics rpc_cache_statistics() const;
+
+    /// Latency of zmq queries by method.
+    query_statistics& query_latency();
+
     bool is_blockchain_sync() const { return under_blockchain_sync_.load(std::memory_order_relaxed); }
 
 private:
@@ -129,6 +145,10 @@ private:
     boost::shared_ptr<mgbubble::HttpServ> rest_server_;
     boost::shared_ptr<mgbubble::WsPushServ> push_server_;
     // These are thread safe.
+    publisher publisher_;
+    query_statistics query_latency_;
+    threadpool secure_history_pool_;
+    threadpool public_history_pool_;
     authenticator authenticator_;
     query_service secure_query_service_;
     query_service public_query_service_;
@@ -25,6 +25,7 @@
 #include <metaverse/protocol.hpp>
 #include <metaverse/server/define.hpp>
 #include <metaverse/server/settings.hpp>
+#include <metaverse/server/utility/publisher.hpp>
 
 namespace libbitcoin {
 namespace server {
@@ -63,14 +64,9 @@ protected:
     virtual void work();
 
 private:
-    typedef bc::message::block_message::ptr block_ptr;
-    typedef bc::message::block_message::ptr_list block_list;
-
-    bool handle_reorganization(const code& ec, uint64_t fork_point,
-        const block_list& new_blocks, const block_list&);
-    void publish_blocks(uint32_t fork_point, const block_list& blocks);
-    void publish_block(socket& publisher, uint32_t height,
-        const block_ptr block);
+    bool handle_publication(const code& ec, publication::ptr value);
+    void publish_blocks(const published_block::list& blocks);
+    void publish_block(socket& publisher, const published_block& block);
 
     const bool secure_;
     const server::settings& settings_;
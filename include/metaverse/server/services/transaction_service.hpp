@@ -24,6 +24,7 @@
 #include <metaverse/protocol.hpp>
 #include <metaverse/server/define.hpp>
 #include <metaverse/server/settings.hpp>
+#include <metaverse/server/utility/publisher.hpp>
 
 namespace libbitcoin {
 namespace server {
@@ -62,11 +63,8 @@ protected:
     virtual void work();
 
 private:
-    typedef bc::chain::point::indexes index_list;
-
-    bool handle_transaction(const code& ec, const index_list&,
-        bc::message::transaction_message::ptr tx);
-    void publish_transaction(const chain::transaction& tx);
+    bool handle_publication(const code& ec, publication::ptr value);
+    void publish_transaction(const published_transaction& tx);
 
     const bool secure_;
     const server::settings& settings_;
@@ -41,9 +41,12 @@ public:
 
     /// Properties.
     uint16_t query_workers;
+    uint16_t query_history_workers;
     uint32_t heartbeat_interval_seconds;
     uint32_t subscription_expiration_minutes;
     uint32_t subscription_limit;
+    uint32_t publication_replay_limit;
+    uint32_t rpc_cache_entries;
     std::string mongoose_listen;
     std::string websocket_listen;
     std::string log_level;
@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse-server.
+ *
+ * metaverse-server is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_SERVER_ADDRESS_SUBSCRIPTIONS_HPP
+#define MVS_SERVER_ADDRESS_SUBSCRIPTIONS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/server/define.hpp>
+#include <metaverse/server/messages/route.hpp>
+#include <metaverse/server/utility/address_key.hpp>
+
+namespace libbitcoin {
+namespace server {
+
+/// This class is thread safe.
+/// Prefix filter subscriptions indexed by a binary trie, so that matching a
+/// field visits one node per bit of the longest filter along its path rather
+/// than every subscription. Expiry is tracked in a timer wheel whose slots
+/// are one resolution wide, so each tick touches only the due subscriptions.
+class BCS_API address_subscriptions
+{
+public:
+    struct subscription
+    {
+        route reply_to;
+        uint32_t id;
+        binary prefix_filter;
+
+        /// Notification sequence, only advanced by the notifying strand.
+        uint8_t sequence;
+
+        /// The wheel tick at which the subscription expires.
+        size_t deadline;
+    };
+
+    typedef std::shared_ptr<subscription> ptr;
+    typedef std::vector<ptr> list;
+
+    /// Construct an empty set, a zero limit is unlimited.
+    address_subscriptions(size_t limit, const asio::duration& expiration,
+        const asio::duration& resolution);
+
+    /// Enable subscription.
+    void start();
+
+    /// Disable subscription and return the subscriptions that were dropped.
+    list stop();
+
+    /// Add a subscription or renew the expiry of an existing one (the id is
+    /// not changed). False if stopped or the limit is reached.
+    bool subscribe(const route& reply_to, uint32_t id,
+        const binary& prefix_filter);
+
+    /// Remove a subscription, returns nullptr if not subscribed.
+    ptr unsubscribe(const route& reply_to, const binary& prefix_filter);
+
+    /// The subscriptions with a filter that is a prefix of the field.
+    list match(const binary& field) const;
+
+    /// Advance the wheel to now and remove the expired subscriptions.
+    list expire();
+
+    /// The number of subscriptions.
+    size_t size() const;
+
+private:
+    struct node
+    {
+        list subscriptions;
+        std::unique_ptr<node> children[2];
+    };
+
+    typedef std::unordered_set<ptr> slot;
+    typedef std::unordered_map<address_key, ptr> index;
+
+    size_t current_tick() const;
+    void schedule(const ptr& subscription);
+    void unschedule(const ptr& subscription);
+    void insert(const ptr& subscription);
+    void remove(const ptr& subscription);
+
+    // These are thread safe.
+    const size_t limit_;
+    const asio::duration resolution_;
+    const size_t span_;
+    const asio::time_point epoch_;
+
+    // These are protected by mutex.
+    bool stopped_;
+    size_t tick_;
+    node root_;
+    index index_;
+    std::vector<slot> wheel_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace server
+} // namespace libbitcoin
+
+#endif
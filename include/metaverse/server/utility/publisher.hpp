@@ -0,0 +1,183 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse-server.
+ *
+ * metaverse-server is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_SERVER_PUBLISHER_HPP
+#define MVS_SERVER_PUBLISHER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/circular_buffer.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/server/define.hpp>
+
+namespace libbitcoin {
+namespace server {
+
+class server_node;
+
+/// A chain or pool transaction, serialized and encoded once for publishers.
+/// The encodings are made on first use, so a publication without consumers
+/// costs no serialization.
+struct BCS_API published_transaction
+{
+    typedef std::shared_ptr<const published_transaction> ptr;
+    typedef std::vector<ptr> list;
+
+    /// Zero height and null block hash for a pool transaction.
+    uint32_t height;
+    hash_digest block_hash;
+
+    /// The block holding the transaction and its position there, or else
+    /// the pool transaction, so that the transaction is never copied.
+    chain::block::ptr block;
+    uint32_t index;
+    std::shared_ptr<const chain::transaction> pool_transaction;
+
+    const chain::transaction& tx() const
+    {
+        return block ? block->transactions[index] : *pool_transaction;
+    }
+
+    /// The transaction hash.
+    const hash_digest& hash() const;
+
+    /// Payment addresses of the inputs and then the outputs.
+    const std::vector<wallet::payment_address>& addresses() const;
+
+    /// The wire serialization.
+    const data_chunk& data() const;
+
+    /// The compact json encoding.
+    const std::string& json() const;
+
+private:
+    mutable std::once_flag hash_once_;
+    mutable std::once_flag addresses_once_;
+    mutable std::once_flag data_once_;
+    mutable std::once_flag json_once_;
+    mutable hash_digest hash_;
+    mutable std::vector<wallet::payment_address> addresses_;
+    mutable data_chunk data_;
+    mutable std::string json_;
+};
+
+/// A block of the long chain, serialized once for publishers.
+struct BCS_API published_block
+{
+    typedef std::shared_ptr<const published_block> ptr;
+    typedef std::vector<ptr> list;
+
+    uint32_t height;
+    hash_digest hash;
+    chain::block::ptr block;
+
+    /// The wire serialization, without the transaction count.
+    const data_chunk& data() const;
+
+    /// The transactions of the block, in block order.
+    published_transaction::list transactions;
+
+private:
+    mutable std::once_flag data_once_;
+    mutable data_chunk data_;
+};
+
+/// A reorganization (blocks) or a pool acceptance (transaction).
+struct BCS_API publication
+{
+    typedef std::shared_ptr<const publication> ptr;
+    typedef std::vector<ptr> list;
+
+    /// Assigned in publication order, starting at one.
+    uint64_t sequence;
+
+    /// The height of the first block of a reorganization.
+    uint32_t fork_point;
+    published_block::list blocks;
+    published_transaction::ptr transaction;
+};
+
+/// This class is thread safe.
+/// Serialize (and json encode) each reorganization and pool transaction at
+/// most once and share the result with every publisher. The last
+/// publications are retained so that a slow consumer can replay them by
+/// sequence.
+class BCS_API publisher
+{
+public:
+    typedef std::function<bool(const code&, publication::ptr)> handler;
+
+    /// Construct a publisher retaining the last replay_limit publications.
+    publisher(server_node& node, size_t replay_limit);
+
+    /// Subscribe to the node, call before the node is run.
+    void start();
+
+    /// Notify subscribers with error::service_stopped.
+    void stop();
+
+    /// Subscribe to publications, return true to resubscribe.
+    void subscribe(handler handler);
+
+    /// The sequence of the last publication, zero if none.
+    uint64_t sequence() const;
+
+    /// Get the retained publications after the sequence, in order.
+    /// False if a publication after the sequence is no longer retained.
+    bool replay(uint64_t sequence, publication::list& out) const;
+
+private:
+    typedef chain::point::indexes index_list;
+    typedef bc::message::block_message::ptr_list block_list;
+    typedef resubscriber<const code&, publication::ptr> subscriber;
+
+    bool handle_reorganization(const code& ec, uint64_t fork_point,
+        const block_list& new_blocks, const block_list&);
+    bool handle_transaction_pool(const code& ec, const index_list&,
+        bc::message::transaction_message::ptr tx);
+
+    published_block::ptr encode(uint32_t height,
+        chain::block::ptr block) const;
+    published_transaction::ptr encode(uint32_t height,
+        const hash_digest& block_hash, chain::block::ptr block,
+        uint32_t index) const;
+    published_transaction::ptr encode(
+        bc::message::transaction_message::ptr tx) const;
+    void publish(std::shared_ptr<publication> value);
+
+    // These are thread safe.
+    server_node& node_;
+    subscriber::ptr subscriber_;
+
+    // These are protected by mutex.
+    uint64_t sequence_;
+    boost::circular_buffer<publication::ptr> retained_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace server
+} // namespace libbitcoin
+
+#endif
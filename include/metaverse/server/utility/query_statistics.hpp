@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse-server.
+ *
+ * metaverse-server is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_SERVER_QUERY_STATISTICS_HPP
+#define MVS_SERVER_QUERY_STATISTICS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/server/define.hpp>
+
+namespace libbitcoin {
+namespace server {
+
+/// This class is thread safe.
+/// Latency of queries by method, from receipt to response, counted in power
+/// of two microsecond buckets. Recording takes only a shared lock to find the
+/// method, the counts themselves are atomic.
+class BCS_API query_statistics
+{
+public:
+    /// Bucket n counts latencies below 2^n microseconds, the last is open.
+    static constexpr size_t buckets = 32;
+
+    struct method
+    {
+        std::string name;
+        bool heavy;
+        uint64_t count;
+        uint64_t mean_microseconds;
+        uint64_t p50_microseconds;
+        uint64_t p99_microseconds;
+        uint64_t max_microseconds;
+    };
+
+    typedef std::vector<method> list;
+
+    /// Register a method and its lane, registering again has no effect.
+    void attach(const std::string& command, bool heavy);
+
+    /// Record a query latency, unregistered methods are ignored.
+    void record(const std::string& command, const asio::duration& latency);
+
+    /// The statistics of each registered method, in name order.
+    list snapshot() const;
+
+private:
+    struct histogram
+    {
+        explicit histogram(bool heavy);
+
+        const bool heavy;
+        std::atomic<uint64_t> counts[buckets];
+        std::atomic<uint64_t> total;
+        std::atomic<uint64_t> maximum;
+    };
+
+    typedef std::map<std::string, std::unique_ptr<histogram>> map;
+
+    static uint64_t percentile(const uint64_t (&counts)[buckets],
+        uint64_t count, uint64_t maximum, size_t percent);
+
+    // This is protected by mutex.
+    map histograms_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace server
+} // namespace libbitcoin
+
+#endif
@@ -29,6 +29,8 @@
 #include <metaverse/server/messages/route.hpp>
 #include <metaverse/server/settings.hpp>
 #include <metaverse/server/utility/address_key.hpp>
+#include <metaverse/server/utility/address_subscriptions.hpp>
+#include <metaverse/server/utility/publisher.hpp>
 
 namespace libbitcoin {
 namespace server {
@@ -71,17 +73,8 @@ protected:
     virtual void work();
 
 private:
-    typedef chain::point::indexes index_list;
-    typedef std::shared_ptr<uint8_t> sequence_ptr;
-    typedef bc::message::block_message::ptr_list block_list;
-
-    typedef notifier<address_key, const code&,
-        const wallet::payment_address&, int32_t, const hash_digest&,
-        const chain::transaction&> payment_subscriber;
-    typedef notifier<address_key, const code&, uint32_t, uint32_t,
-        const hash_digest&, const chain::transaction&> stealth_subscriber;
-    typedef notifier<address_key, const code&, const binary&, uint32_t,
-        const hash_digest&, const chain::transaction&> address_subscriber;
+    typedef address_subscriptions::list subscription_list;
+
     typedef notifier<address_key, const code&, uint32_t,
         const hash_digest&, const hash_digest&> penetration_subscriber;
 
@@ -89,56 +82,47 @@ private:
     void purge();
     int32_t purge_interval_milliseconds() const;
 
-    bool handle_blockchain_reorganization(const code& ec, uint64_t fork_point,
-        const block_list& new_blocks, const block_list&);
-    bool handle_transaction_pool(const code& ec, const index_list&,
-        bc::message::transaction_message::ptr tx);
+    bool handle_publication(const code& ec, publication::ptr value);
     bool handle_inventory(const code& ec,
         const bc::message::inventory::ptr packet);
 
-    void notify_blocks(uint32_t fork_point, const block_list& blocks);
-    void notify_block(socket& peer, uint32_t height,
-        const chain::block::ptr block);
-    void notify_transaction(uint32_t height, const hash_digest& block_hash,
-        const chain::transaction& tx);
+    void notify_blocks(const published_block::list& blocks);
+    void notify_block(const published_block& block);
+    void notify_transaction(published_transaction::ptr tx);
 
     // v2/v3 (deprecated)
-    void notify_payment(const wallet::payment_address& address,
-        uint32_t height, const hash_digest& block_hash,
-        const chain::transaction& tx);
-    void notify_stealth(uint32_t prefix, uint32_t height,
-        const hash_digest& block_hash, const chain::transaction& tx);
+    void notify_payment(const binary& field,
+        const wallet::payment_address& address,
+        published_transaction::ptr tx);
+    void notify_stealth(const binary& field, uint32_t prefix,
+        published_transaction::ptr tx);
 
     // v3
-    void notify_address(const binary& field, uint32_t height,
-        const hash_digest& block_hash, const chain::transaction& tx);
+    void notify_address(const binary& field, published_transaction::ptr tx);
     void notify_penetration(uint32_t height, const hash_digest& block_hash,
         const hash_digest& tx_hash);
 
     // Send a notification to the subscriber.
     void send(const route& reply_to, const std::string& command,
         uint32_t id, const data_chunk& payload);
+    void send_error(const subscription_list& subscriptions,
+        const std::string& command, const code& ec);
     void send_payment(const route& reply_to, uint32_t id,
-        const wallet::payment_address& address, uint32_t height,
-        const hash_digest& block_hash, const chain::transaction& tx);
+        const wallet::payment_address& address,
+        const published_transaction& tx);
     void send_stealth(const route& reply_to, uint32_t id, uint32_t prefix,
-        uint32_t height, const hash_digest& block_hash,
-        const chain::transaction& tx);
+        const published_transaction& tx);
     void send_address(const route& reply_to, uint32_t id, uint8_t sequence,
-        uint32_t height, const hash_digest& block_hash,
-        const chain::transaction& tx);
-
-    bool handle_payment(const code& ec, const wallet::payment_address& address,
-        uint32_t height, const hash_digest& block_hash,
-        const chain::transaction& tx, const route& reply_to, uint32_t id,
-        const binary& prefix_filter);
-    bool handle_stealth(const code& ec, uint32_t prefix, uint32_t height,
-        const hash_digest& block_hash, const chain::transaction& tx,
-        const route& reply_to, uint32_t id, const binary& prefix_filter);
-    bool handle_address(const code& ec, const binary& field, uint32_t height,
-        const hash_digest& block_hash, const chain::transaction& tx,
-        const route& reply_to, uint32_t id, const binary& prefix_filter,
-        sequence_ptr sequence);
+        const published_transaction& tx);
+
+    // Send a notification to each matched subscriber (ordered).
+    void send_payments(const subscription_list& subscriptions,
+        const wallet::payment_address& address,
+        published_transaction::ptr tx);
+    void send_stealths(const subscription_list& subscriptions,
+        uint32_t prefix, published_transaction::ptr tx);
+    void send_addresses(const subscription_list& subscriptions,
+        published_transaction::ptr tx);
 
     const bool secure_;
     const server::settings& settings_;
@@ -146,10 +130,11 @@ private:
     // These are thread safe.
     server_node& node_;
     bc::protocol::zmq::authenticator& authenticator_;
-    address_subscriber::ptr address_subscriber_;
-    payment_subscriber::ptr payment_subscriber_;
-    stealth_subscriber::ptr stealth_subscriber_;
+    address_subscriptions payment_subscriptions_;
+    address_subscriptions stealth_subscriptions_;
+    address_subscriptions address_subscriptions_;
     penetration_subscriber::ptr penetration_subscriber_;
+    dispatcher dispatch_;
 };
 
 } // namespace server
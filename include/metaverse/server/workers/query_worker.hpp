@@ -28,6 +28,7 @@
 #include <metaverse/server/define.hpp>
 #include <metaverse/server/messages/message.hpp>
 #include <metaverse/server/settings.hpp>
+#include <metaverse/server/utility/query_statistics.hpp>
 
 namespace libbitcoin {
 namespace server {
@@ -36,6 +37,9 @@ class server_node;
 
 // This class is thread safe.
 // Provide asynchronous query responses to the query service.
+// Lookups execute on the worker thread. History, stealth and validation
+// queries execute on the history pool so that they cannot delay lookups,
+// with their responses returned to the worker thread for sending.
 class BCS_API query_worker
   : public bc::protocol::zmq::worker
 {
@@ -44,21 +48,35 @@ public:
 
     /// Construct a query worker.
     query_worker(bc::protocol::zmq::authenticator& authenticator,
-        server_node& node, bool secure);
+        server_node& node, bool secure, threadpool& history_pool);
 
 protected:
     typedef bc::protocol::zmq::socket socket;
 
     typedef std::function<void(const message&, send_handler)> command_handler;
-    typedef std::unordered_map<std::string, command_handler> command_map;
+
+    struct command_entry
+    {
+        command_handler handler;
+        bool heavy;
+    };
+
+    typedef std::unordered_map<std::string, command_entry> command_map;
 
     virtual void attach_interface();
-    virtual void attach(const std::string& command, command_handler handler);
+    virtual void attach(const std::string& command, command_handler handler,
+        bool heavy);
 
     virtual bool connect(socket& router);
     virtual bool disconnect(socket& router);
+    virtual bool bind(socket& puller);
+    virtual bool open_responder();
+    virtual bool close_responder();
     virtual void query(socket& router);
 
+    // Return a response from the history pool to the worker thread.
+    virtual void respond(message&& response);
+
     // Implement the worker.
     virtual void work();
 
@@ -66,12 +84,20 @@ private:
     const bool secure_;
     const server::settings& settings_;
 
+    const config::endpoint responses_;
+
     // These are thread safe.
     server_node& node_;
     bc::protocol::zmq::authenticator& authenticator_;
+    threadpool& history_pool_;
+    query_statistics& statistics_;
 
     // This is protected by base class mutex.
     command_map command_handlers_;
+
+    // This is protected by mutex, the history pool shares one pusher.
+    socket::ptr pusher_;
+    mutable unique_mutex pusher_mutex_;
 };
 
 } // namespace server
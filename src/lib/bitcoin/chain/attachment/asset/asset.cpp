@@ -25,6 +25,7 @@
 #include <boost/iostreams/stream.hpp>
 #include <metaverse/bitcoin/utility/container_sink.hpp>
 #include <metaverse/bitcoin/utility/container_source.hpp>
+#include <metaverse/bitcoin/utility/data_reader.hpp>
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
 #include <metaverse/bitcoin/utility/ostream_writer.hpp>
 
@@ -84,8 +85,8 @@ bool asset::is_valid_type() const
 
 bool asset::from_data(const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(istream);
+    data_reader source(data);
+    return from_data(source);
 }
 
 bool asset::from_data(std::istream& stream)
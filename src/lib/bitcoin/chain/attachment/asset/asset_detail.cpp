@@ -23,6 +23,7 @@
 #include <boost/iostreams/stream.hpp>
 #include <metaverse/bitcoin/utility/container_sink.hpp>
 #include <metaverse/bitcoin/utility/container_source.hpp>
+#include <metaverse/bitcoin/utility/data_reader.hpp>
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
 #include <metaverse/bitcoin/utility/ostream_writer.hpp>
 #include <json/minijson_writer.hpp>
@@ -98,8 +99,8 @@ void asset_detail::reset()
 
 bool asset_detail::from_data(const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(istream);
+    data_reader source(data);
+    return from_data(source);
 }
 
 bool asset_detail::from_data(std::istream& stream)
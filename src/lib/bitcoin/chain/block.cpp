@@ -27,6 +27,7 @@
 #include <metaverse/bitcoin/utility/assert.hpp>
 #include <metaverse/bitcoin/utility/container_sink.hpp>
 #include <metaverse/bitcoin/utility/container_source.hpp>
+#include <metaverse/bitcoin/utility/data_reader.hpp>
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
 #include <metaverse/bitcoin/utility/ostream_writer.hpp>
 
@@ -105,8 +106,8 @@ void block::reset()
 
 bool block::from_data(const data_chunk& data, bool with_transaction_count)
 {
-    data_source istream(data);
-    return from_data(istream, with_transaction_count);
+    data_reader source(data);
+    return from_data(source, with_transaction_count);
 }
 
 bool block::from_data(std::istream& stream, bool with_transaction_count)
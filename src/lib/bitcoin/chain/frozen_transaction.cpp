@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/chain/frozen_transaction.hpp>
+
+#include <metaverse/bitcoin/utility/assert.hpp>
+#include <metaverse/bitcoin/utility/endian.hpp>
+#include <metaverse/bitcoin/utility/variable_uint_size.hpp>
+
+namespace libbitcoin {
+namespace chain {
+
+frozen_transaction::ptr frozen_transaction::freeze(const transaction& tx)
+{
+    return std::make_shared<const frozen_transaction>(tx);
+}
+
+frozen_transaction::frozen_transaction()
+  : hash_(null_hash), inputs_(0)
+{
+}
+
+frozen_transaction::frozen_transaction(const transaction& tx)
+  : data_(tx.to_data()), hash_(bitcoin_hash(data_)),
+    inputs_(static_cast<uint32_t>(tx.inputs.size()))
+{
+    offsets_.reserve(tx.inputs.size() + tx.outputs.size() + 2);
+
+    // version
+    uint64_t offset = 4 + variable_uint_size(tx.inputs.size());
+
+    for (const auto& input: tx.inputs)
+    {
+        offsets_.push_back(static_cast<uint32_t>(offset));
+        offset += input.serialized_size();
+    }
+
+    offsets_.push_back(static_cast<uint32_t>(offset));
+    offset += variable_uint_size(tx.outputs.size());
+
+    for (const auto& output: tx.outputs)
+    {
+        offsets_.push_back(static_cast<uint32_t>(offset));
+        offset += output.serialized_size();
+    }
+
+    offsets_.push_back(static_cast<uint32_t>(offset));
+
+    // locktime
+    BITCOIN_ASSERT(offset + 4 == data_.size());
+}
+
+bool frozen_transaction::is_valid() const
+{
+    return !data_.empty() && !offsets_.empty() &&
+        offsets_.back() + 4 == data_.size();
+}
+
+const data_chunk& frozen_transaction::data() const
+{
+    return data_;
+}
+
+const hash_digest& frozen_transaction::hash() const
+{
+    return hash_;
+}
+
+uint64_t frozen_transaction::serialized_size() const
+{
+    return data_.size();
+}
+
+size_t frozen_transaction::inputs_size() const
+{
+    return inputs_;
+}
+
+size_t frozen_transaction::outputs_size() const
+{
+    return offsets_.empty() ? 0 : offsets_.size() - inputs_ - 2;
+}
+
+output_point frozen_transaction::previous_output(size_t index) const
+{
+    BITCOIN_ASSERT(index < inputs_size());
+    const auto begin = data_.begin() + offsets_[index];
+
+    output_point point;
+    std::copy(begin, begin + hash_size, point.hash.begin());
+    point.index = from_little_endian_unsafe<uint32_t>(begin + hash_size);
+    return point;
+}
+
+input frozen_transaction::input_at(size_t index) const
+{
+    BITCOIN_ASSERT(index < inputs_size());
+    return input::factory_from_data(
+        slice(offsets_[index], offsets_[index + 1]));
+}
+
+output frozen_transaction::output_at(size_t index) const
+{
+    BITCOIN_ASSERT(index < outputs_size());
+    const auto position = inputs_ + 1 + index;
+    return output::factory_from_data(
+        slice(offsets_[position], offsets_[position + 1]));
+}
+
+transaction frozen_transaction::thaw() const
+{
+    return transaction::factory_from_data(data_);
+}
+
+data_chunk frozen_transaction::slice(size_t begin, size_t end) const
+{
+    return data_chunk(data_.begin() + begin, data_.begin() + end);
+}
+
+} // namespace chain
+} // namespace libbitcoin
@@ -25,6 +25,7 @@
 #include <metaverse/bitcoin/constants.hpp>
 #include <metaverse/bitcoin/utility/container_sink.hpp>
 #include <metaverse/bitcoin/utility/container_source.hpp>
+#include <metaverse/bitcoin/utility/data_reader.hpp>
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
 #include <metaverse/bitcoin/utility/ostream_writer.hpp>
 #include <metaverse/consensus/libdevcore/FixedHash.h>
@@ -32,6 +33,23 @@
 namespace libbitcoin {
 namespace chain {
 
+// The ethash fields are big-endian on the wire, moved a 64 bit word at a time.
+static u256 read_u256_big_endian(reader& source)
+{
+    u256 value = 0;
+    for (size_t word = 0; word < 4; ++word)
+        value = (value << 64) | source.read_8_bytes_big_endian();
+
+    return value;
+}
+
+static void write_u256_big_endian(writer& sink, const u256& value)
+{
+    for (size_t word = 4; word > 0; --word)
+        sink.write_8_bytes_big_endian(
+            static_cast<uint64_t>(value >> (64 * (word - 1))));
+}
+
 header header::factory_from_data(const data_chunk& data,
     bool with_transaction_count)
 {
@@ -166,8 +184,8 @@ void header::reset()
 bool header::from_data(const data_chunk& data,
     bool with_transaction_count)
 {
-    data_source istream(data);
-    return from_data(istream, with_transaction_count);
+    data_reader source(data);
+    return from_data(source, with_transaction_count);
 }
 
 bool header::from_data(std::istream& stream, bool with_transaction_count)
@@ -185,15 +203,9 @@ bool header::from_data(reader& source, bool with_transaction_count)
     merkle = source.read_hash();
     timestamp = source.read_4_bytes_little_endian();
 
-    unsigned char buff[32];
-    source.read_data(buff, 32);
-    bits = (h256::Arith)(h256((const uint8_t*)&buff[0], h256::ConstructFromPointer));
-
-    source.read_data(buff, 8);
-    nonce = (h64::Arith)(h64((const uint8_t*)&buff[0], h64::ConstructFromPointer));
-
-    source.read_data(buff, 32);
-    mixhash = (h256::Arith)(h256((const uint8_t*)&buff[0], h256::ConstructFromPointer));
+    bits = read_u256_big_endian(source);
+    nonce = source.read_8_bytes_big_endian();
+    mixhash = read_u256_big_endian(source);
 
     number = source.read_4_bytes_little_endian();
 
@@ -233,9 +245,9 @@ void header::to_data(writer& sink, bool with_transaction_count) const
     sink.write_hash(merkle);
     sink.write_4_bytes_little_endian(timestamp);
 
-    sink.write_data((unsigned char*)h256(bits).data(), 32);
-    sink.write_data((unsigned char*)h64(nonce).data(), 8);
-    sink.write_data((unsigned char*)h256(mixhash).data(), 32);
+    write_u256_big_endian(sink, bits);
+    sink.write_8_bytes_big_endian(static_cast<uint64_t>(nonce));
+    write_u256_big_endian(sink, mixhash);
 
     sink.write_4_bytes_little_endian(number);
 
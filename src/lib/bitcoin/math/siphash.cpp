@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/math/siphash.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <metaverse/bitcoin/utility/endian.hpp>
+
+namespace libbitcoin {
+
+#define ROTL(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
+
+#define SIPROUND \
+    do { \
+        v0 += v1; v1 = ROTL(v1, 13); v1 ^= v0; v0 = ROTL(v0, 32); \
+        v2 += v3; v3 = ROTL(v3, 16); v3 ^= v2; \
+        v0 += v3; v3 = ROTL(v3, 21); v3 ^= v0; \
+        v2 += v1; v1 = ROTL(v1, 17); v1 ^= v2; v2 = ROTL(v2, 32); \
+    } while (false)
+
+uint64_t siphash(const siphash_key& key, const data_slice& message)
+{
+    const auto k0 = std::get<0>(key);
+    const auto k1 = std::get<1>(key);
+
+    uint64_t v0 = 0x736f6d6570736575ull ^ k0;
+    uint64_t v1 = 0x646f72616e646f6dull ^ k1;
+    uint64_t v2 = 0x6c7967656e657261ull ^ k0;
+    uint64_t v3 = 0x7465646279746573ull ^ k1;
+
+    const auto size = message.size();
+    const auto tail = size % sizeof(uint64_t);
+    auto it = message.begin();
+    const auto end = it + (size - tail);
+
+    for (; it != end; it += sizeof(uint64_t))
+    {
+        const auto word = from_little_endian_unsafe<uint64_t>(it);
+        v3 ^= word;
+        SIPROUND;
+        SIPROUND;
+        v0 ^= word;
+    }
+
+    // The final word carries the low byte of the length and the remainder.
+    auto last = static_cast<uint64_t>(size) << 56;
+    for (size_t i = 0; i < tail; ++i)
+        last |= static_cast<uint64_t>(it[i]) << (8 * i);
+
+    v3 ^= last;
+    SIPROUND;
+    SIPROUND;
+    v0 ^= last;
+
+    v2 ^= 0xff;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+#undef SIPROUND
+#undef ROTL
+
+siphash_key to_siphash_key(const hash_digest& hash)
+{
+    const auto k0 = from_little_endian_unsafe<uint64_t>(hash.begin());
+    const auto k1 = from_little_endian_unsafe<uint64_t>(hash.begin() +
+        sizeof(uint64_t));
+    return std::make_tuple(k0, k1);
+}
+
+} // namespace libbitcoin
@@ -24,6 +24,7 @@
 #include <metaverse/bitcoin/message/version.hpp>
 #include <metaverse/bitcoin/utility/container_sink.hpp>
 #include <metaverse/bitcoin/utility/container_source.hpp>
+#include <metaverse/bitcoin/utility/data_reader.hpp>
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
 #include <metaverse/bitcoin/utility/ostream_writer.hpp>
 
@@ -68,8 +69,8 @@ void address::reset()
 
 bool address::from_data(uint32_t version, const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool address::from_data(uint32_t version, std::istream& stream)
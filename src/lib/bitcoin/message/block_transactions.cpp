@@ -24,6 +24,7 @@
 #include <metaverse/bitcoin/message/version.hpp>
 #include <metaverse/bitcoin/utility/container_sink.hpp>
 #include <metaverse/bitcoin/utility/container_source.hpp>
+#include <metaverse/bitcoin/utility/data_reader.hpp>
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
 #include <metaverse/bitcoin/utility/ostream_writer.hpp>
 
@@ -73,8 +74,8 @@ void block_transactions::reset()
 bool block_transactions::from_data(uint32_t version,
     const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool block_transactions::from_data(uint32_t version,
@@ -20,11 +20,17 @@
  */
 #include <metaverse/bitcoin/message/compact_block.hpp>
 
+#include <algorithm>
 #include <initializer_list>
+#include <map>
+#include <vector>
 #include <boost/iostreams/stream.hpp>
+#include <metaverse/bitcoin/math/hash.hpp>
 #include <metaverse/bitcoin/message/version.hpp>
 #include <metaverse/bitcoin/utility/container_sink.hpp>
 #include <metaverse/bitcoin/utility/container_source.hpp>
+#include <metaverse/bitcoin/utility/data_reader.hpp>
+#include <metaverse/bitcoin/utility/endian.hpp>
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
 #include <metaverse/bitcoin/utility/ostream_writer.hpp>
 
@@ -35,6 +41,28 @@ const std::string compact_block::command = "cmpctblock";
 const uint32_t compact_block::version_minimum = version::level::bip152;
 const uint32_t compact_block::version_maximum = version::level::bip152;
 
+compact_block compact_block::from_block(const chain::block& block,
+    uint64_t nonce)
+{
+    compact_block instance;
+    instance.header = block.header;
+    instance.nonce = nonce;
+
+    const auto& transactions = block.transactions;
+    if (transactions.empty())
+        return instance;
+
+    instance.transactions.push_back({ 0, transactions.front() });
+
+    const auto key = instance.short_id_key();
+    instance.short_ids.reserve(transactions.size() - 1);
+
+    for (auto tx = transactions.begin() + 1; tx != transactions.end(); ++tx)
+        instance.short_ids.push_back(to_short_id(key, tx->hash()));
+
+    return instance;
+}
+
 compact_block compact_block::factory_from_data(uint32_t version,
     const data_chunk& data)
 {
@@ -76,8 +104,8 @@ void compact_block::reset()
 
 bool compact_block::from_data(uint32_t version, const data_chunk& data)
 {
-    data_source istream(data);
-    return from_data(version, istream);
+    data_reader source(data);
+    return from_data(version, source);
 }
 
 bool compact_block::from_data(uint32_t version, std::istream& stream)
@@ -156,6 +184,86 @@ void compact_block::to_data(uint32_t version, writer& sink) const
         element.to_data(version, sink);
 }
 
+siphash_key compact_block::short_id_key() const
+{
+    data_chunk data;
+    data.reserve(chain::header::satoshi_fixed_size_without_transaction_count()
+        + sizeof(nonce));
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    header.to_data(sink, false);
+    sink.write_8_bytes_little_endian(nonce);
+    ostream.flush();
+    return to_siphash_key(sha256_hash(data));
+}
+
+compact_block::short_id compact_block::to_short_id(const siphash_key& key,
+    const hash_digest& transaction_hash)
+{
+    const auto value = to_little_endian(siphash(key, transaction_hash));
+
+    // Short ids are the low six bytes of the siphash value.
+    short_id id;
+    std::copy(value.begin(), value.begin() + id.size(), id.begin());
+    return id;
+}
+
+bool compact_block::reconstruct(chain::block& out_block,
+    std::vector<uint64_t>& out_missing, const hash_list& candidates,
+    transaction_finder find) const
+{
+    const auto total = short_ids.size() + transactions.size();
+    out_block.header = header;
+    out_block.header.transaction_count = total;
+    out_block.transactions.clear();
+    out_block.transactions.resize(total);
+    out_missing.clear();
+
+    std::vector<bool> filled(total, false);
+    for (const auto& element: transactions)
+    {
+        if (element.index >= total || filled[element.index])
+            return false;
+
+        out_block.transactions[element.index] = element.transaction;
+        filled[element.index] = true;
+    }
+
+    // Short ids occupy the positions not prefilled, in order.
+    std::map<short_id, size_t> positions;
+    auto id = short_ids.begin();
+    for (size_t index = 0; index < total; ++index)
+    {
+        if (filled[index])
+            continue;
+
+        // A short id collision within the block cannot be resolved.
+        if (!positions.emplace(*id++, index).second)
+            return false;
+    }
+
+    const auto key = short_id_key();
+    for (const auto& hash: candidates)
+    {
+        const auto it = positions.find(to_short_id(key, hash));
+
+        if (it == positions.end() || filled[it->second])
+            continue;
+
+        // The candidate may have gone since its hash was listed.
+        if (!find(hash, out_block.transactions[it->second]))
+            continue;
+
+        filled[it->second] = true;
+    }
+
+    for (size_t index = 0; index < total; ++index)
+        if (!filled[index])
+            out_missing.push_back(index);
+
+    return true;
+}
+
 uint64_t compact_block::serialized_size(uint32_t version) const
 {
     uint64_t size = chain::header::satoshi_fixed_size_without_transaction_count() +
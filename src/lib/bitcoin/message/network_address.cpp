@@ -23,6 +23,7 @@
 #include <boost/iostreams/stream.hpp>
 #include <metaverse/bitcoin/utility/container_sink.hpp>
 #include <metaverse/bitcoin/utility/container_source.hpp>
+#include <metaverse/bitcoin/utility/data_reader.hpp>
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
 #include <metaverse/bitcoin/utility/ostream_writer.hpp>
 #include <string.h>
@@ -118,8 +119,8 @@ void network_address::reset()
 bool network_address::from_data(uint32_t version,
     const data_chunk& data, bool with_timestamp)
 {
-    data_source istream(data);
-    return from_data(version, istream, with_timestamp);
+    data_reader source(data);
+    return from_data(version, source, with_timestamp);
 }
 
 bool network_address::from_data(uint32_t version,
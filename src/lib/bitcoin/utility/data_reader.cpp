@@ -0,0 +1,189 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/utility/data_reader.hpp>
+
+#include <algorithm>
+#include <metaverse/bitcoin/constants.hpp>
+#include <metaverse/bitcoin/utility/assert.hpp>
+
+namespace libbitcoin {
+
+data_reader::data_reader(data_slice data)
+  : position_(data.begin()), end_(data.end()), valid_(true)
+{
+}
+
+data_reader::operator bool() const
+{
+    return valid_;
+}
+
+bool data_reader::operator!() const
+{
+    return !valid_;
+}
+
+bool data_reader::is_exhausted() const
+{
+    return valid_ && position_ == end_;
+}
+
+size_t data_reader::remaining() const
+{
+    return static_cast<size_t>(end_ - position_);
+}
+
+bool data_reader::require(size_t size)
+{
+    if (valid_ && size <= remaining())
+        return true;
+
+    valid_ = false;
+    return false;
+}
+
+uint8_t data_reader::read_byte()
+{
+    return require(1) ? *position_++ : 0;
+}
+
+uint16_t data_reader::read_2_bytes_little_endian()
+{
+    return read_little_endian<uint16_t>();
+}
+
+uint32_t data_reader::read_4_bytes_little_endian()
+{
+    return read_little_endian<uint32_t>();
+}
+
+uint64_t data_reader::read_8_bytes_little_endian()
+{
+    return read_little_endian<uint64_t>();
+}
+
+uint64_t data_reader::read_variable_uint_little_endian()
+{
+    const auto length = read_byte();
+    if (length < 0xfd)
+        return length;
+    else if (length == 0xfd)
+        return read_2_bytes_little_endian();
+    else if (length == 0xfe)
+        return read_4_bytes_little_endian();
+
+    // length should be 0xff
+    return read_8_bytes_little_endian();
+}
+
+uint16_t data_reader::read_2_bytes_big_endian()
+{
+    return read_big_endian<uint16_t>();
+}
+
+uint32_t data_reader::read_4_bytes_big_endian()
+{
+    return read_big_endian<uint32_t>();
+}
+
+uint64_t data_reader::read_8_bytes_big_endian()
+{
+    return read_big_endian<uint64_t>();
+}
+
+uint64_t data_reader::read_variable_uint_big_endian()
+{
+    const auto length = read_byte();
+    if (length < 0xfd)
+        return length;
+    else if (length == 0xfd)
+        return read_2_bytes_big_endian();
+    else if (length == 0xfe)
+        return read_4_bytes_big_endian();
+
+    // length should be 0xff
+    return read_8_bytes_big_endian();
+}
+
+// An oversized length read from the wire fails here, before allocating.
+data_chunk data_reader::read_data(size_t size)
+{
+    if (!require(size))
+        return {};
+
+    data_chunk raw_bytes(position_, position_ + size);
+    position_ += size;
+    return raw_bytes;
+}
+
+size_t data_reader::read_data(uint8_t* data, size_t size)
+{
+    const auto read_size = std::min(size, valid_ ? remaining() : 0);
+    std::copy(position_, position_ + read_size, data);
+    position_ += read_size;
+
+    if (read_size != size)
+        valid_ = false;
+
+    return read_size;
+}
+
+data_chunk data_reader::read_data_to_eof()
+{
+    return read_data(valid_ ? remaining() : 0);
+}
+
+hash_digest data_reader::read_hash()
+{
+    return read_bytes<hash_size>();
+}
+
+short_hash data_reader::read_short_hash()
+{
+    return read_bytes<short_hash_size>();
+}
+
+mini_hash data_reader::read_mini_hash()
+{
+    return read_bytes<mini_hash_size>();
+}
+
+std::string data_reader::read_fixed_string(size_t length)
+{
+    if (!require(length))
+        return {};
+
+    std::string result(position_, position_ + length);
+    position_ += length;
+
+    // Removes trailing 0s... Needed for string comparisons
+    return result.c_str();
+}
+
+std::string data_reader::read_string()
+{
+    const auto size = read_variable_uint_little_endian();
+    BITCOIN_ASSERT(size <= bc::max_size_t);
+    const auto read_size = static_cast<size_t>(size);
+    return read_fixed_string(read_size);
+}
+
+} // namespace libbitcoin
@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/utility/inventory_requests.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <metaverse/bitcoin/math/hash.hpp>
+#include <metaverse/bitcoin/utility/asio.hpp>
+
+namespace libbitcoin {
+
+inventory_requests::inventory_requests(const asio::duration& timeout)
+  : timeout_(timeout),
+    next_purge_(asio::steady_clock::now() + timeout)
+{
+}
+
+// private, call under the unique lock.
+// Claims of owners that stay connected but never answer are dropped here.
+void inventory_requests::purge(const asio::time_point& now)
+{
+    if (now < next_purge_)
+        return;
+
+    for (auto it = claims_.begin(); it != claims_.end();)
+    {
+        if (it->second.expires <= now)
+            it = claims_.erase(it);
+        else
+            ++it;
+    }
+
+    next_purge_ = now + timeout_;
+}
+
+bool inventory_requests::claim(const hash_digest& hash, uint64_t owner)
+{
+    const auto now = asio::steady_clock::now();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    purge(now);
+    auto it = claims_.find(hash);
+
+    if (it == claims_.end())
+    {
+        claims_.emplace(hash, claim_entry{ owner, now + timeout_ });
+        return true;
+    }
+
+    // A lapsed claim passes to the new owner, the old one may still answer.
+    if (it->second.expires > now)
+        return false;
+
+    it->second = claim_entry{ owner, now + timeout_ };
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void inventory_requests::release(const hash_digest& hash, uint64_t owner)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    const auto it = claims_.find(hash);
+
+    if (it != claims_.end() && it->second.owner == owner)
+        claims_.erase(it);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void inventory_requests::release(const hash_digest& hash)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    claims_.erase(hash);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void inventory_requests::release_all(uint64_t owner)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    for (auto it = claims_.begin(); it != claims_.end();)
+    {
+        if (it->second.owner == owner)
+            it = claims_.erase(it);
+        else
+            ++it;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t inventory_requests::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return claims_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace libbitcoin
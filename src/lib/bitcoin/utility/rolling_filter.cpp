@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/utility/rolling_filter.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <metaverse/bitcoin/math/siphash.hpp>
+#include <metaverse/bitcoin/utility/random.hpp>
+
+namespace libbitcoin {
+
+static constexpr size_t word_bits = 64;
+
+// Optimal bloom sizing for n entries at false positive rate p.
+static uint64_t to_bit_count(size_t entries, double rate)
+{
+    const auto ln2 = std::log(2.0);
+    const auto bits = -double(entries) * std::log(rate) / (ln2 * ln2);
+    const auto words = std::max<uint64_t>(uint64_t(std::ceil(bits / word_bits)),
+        1);
+    return words * word_bits;
+}
+
+static size_t to_hash_count(size_t entries, uint64_t bit_count)
+{
+    const auto count = std::round(double(bit_count) / entries * std::log(2.0));
+    return std::min<size_t>(std::max<size_t>(size_t(count), 1), 32);
+}
+
+rolling_filter::rolling_filter(size_t capacity, double false_positive_rate)
+  : generation_size_(std::max<size_t>(capacity / 2, 1)),
+    hash_count_(to_hash_count(generation_size_,
+        to_bit_count(generation_size_, false_positive_rate))),
+    bit_count_(to_bit_count(generation_size_, false_positive_rate)),
+    first_key_(pseudo_random(), pseudo_random()),
+    second_key_(pseudo_random(), pseudo_random()),
+    inserted_(0),
+    current_(bit_count_ / word_bits, 0),
+    previous_(bit_count_ / word_bits, 0)
+{
+}
+
+// Double hashing, position i is first + i * step (mod bit count).
+void rolling_filter::positions(const hash_digest& hash, uint64_t& first,
+    uint64_t& step) const
+{
+    first = siphash(first_key_, hash) % bit_count_;
+    step = (siphash(second_key_, hash) % (bit_count_ - 1)) | 1;
+}
+
+bool rolling_filter::test(const bits& generation, uint64_t first,
+    uint64_t step) const
+{
+    auto position = first;
+
+    for (size_t index = 0; index < hash_count_; ++index)
+    {
+        if ((generation[position / word_bits] &
+            (uint64_t(1) << (position % word_bits))) == 0)
+            return false;
+
+        position = (position + step) % bit_count_;
+    }
+
+    return true;
+}
+
+// private, call under the unique lock.
+void rolling_filter::do_insert(uint64_t first, uint64_t step)
+{
+    if (inserted_ == generation_size_)
+    {
+        previous_.swap(current_);
+        std::fill(current_.begin(), current_.end(), 0);
+        inserted_ = 0;
+    }
+
+    auto position = first;
+
+    for (size_t index = 0; index < hash_count_; ++index)
+    {
+        current_[position / word_bits] |= uint64_t(1) << (position % word_bits);
+        position = (position + step) % bit_count_;
+    }
+
+    ++inserted_;
+}
+
+void rolling_filter::insert(const hash_digest& hash)
+{
+    uint64_t first, step;
+    positions(hash, first, step);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    do_insert(first, step);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool rolling_filter::insert_new(const hash_digest& hash)
+{
+    uint64_t first, step;
+    positions(hash, first, step);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_upgrade();
+
+    if (test(current_, first, step) || test(previous_, first, step))
+    {
+        mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return false;
+    }
+
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    mutex_.unlock_upgrade_and_lock();
+    do_insert(first, step);
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return true;
+}
+
+bool rolling_filter::contains(const hash_digest& hash) const
+{
+    uint64_t first, step;
+    positions(hash, first, step);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return test(current_, first, step) || test(previous_, first, step);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void rolling_filter::clear()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    std::fill(current_.begin(), current_.end(), 0);
+    std::fill(previous_.begin(), previous_.end(), 0);
+    inserted_ = 0;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace libbitcoin
@@ -20,10 +20,13 @@
  */
 #include <metaverse/blockchain/block_chain_impl.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <unordered_map>
 #include <boost/filesystem.hpp>
@@ -35,6 +38,7 @@
 #include <metaverse/blockchain/organizer.hpp>
 #include <metaverse/blockchain/settings.hpp>
 #include <metaverse/blockchain/transaction_pool.hpp>
+#include <metaverse/blockchain/validate_block.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
@@ -47,6 +51,19 @@ using namespace boost::interprocess;
 using namespace std::placeholders;
 using boost::filesystem::path;
 
+// Enough for the blocks a syncing peer requests in several get_data rounds.
+static constexpr size_t block_message_cache_capacity = 64 * 1024 * 1024;
+
+// Blocks being checked concurrently before the store falls back to checking
+// on the calling thread, which throttles the network when commits lag.
+static constexpr size_t maximum_checking = 8;
+
+// Blocks organized per database write session, and imports per sync.
+static constexpr size_t maximum_commit_batch = 32;
+
+// Checked blocks waiting to commit before the checking threads wait too.
+static constexpr size_t maximum_queued = 256;
+
 block_chain_impl::block_chain_impl(threadpool& pool,
     const blockchain::settings& chain_settings,
     const database::settings& database_settings)
@@ -56,6 +73,18 @@ block_chain_impl::block_chain_impl(threadpool& pool,
     ////read_dispatch_(pool, NAME),
     ////write_dispatch_(pool, NAME),
     transaction_pool_(pool, *this, chain_settings),
+    block_messages_(block_message_cache_capacity),
+    check_dispatch_(pool, "block_check"),
+    checking_(0),
+    checking_peak_(0),
+    batches_(0),
+    committed_(0),
+    queue_waits_(0),
+    imported_(0),
+    import_rejected_(0),
+    arrivals_(0),
+    queued_peak_(0),
+    committing_(false),
     database_(database_settings)
 {
 }
@@ -113,8 +142,20 @@ bool block_chain_impl::start()
 bool block_chain_impl::stop()
 {
     stopped_ = true;
+
+    // Release stores waiting on a full queue, the committer fails them.
+    {
+        unique_lock lock(store_mutex_);
+    }
+    store_space_.notify_all();
+
     organizer_.stop();
     transaction_pool_.stop();
+
+    // Synchronize the tail of the last run of imports.
+    if (imported_ % maximum_commit_batch != 0)
+        database_.synchronize();
+
     return database_.stop();
 }
 
@@ -250,13 +291,33 @@ bool block_chain_impl::get_transaction(transaction& out_transaction,
 }
 
 // This is safe to call concurrently (but with no other methods).
+// Imported blocks sit below the last checkpoint and their headers are linked
+// to it, so there is no contextual stage. Each sync channel imports on its own
+// thread, so the checks of many blocks overlap one another and the downloads.
 bool block_chain_impl::import(block::ptr block, uint64_t height)
 {
     if (stopped())
         return false;
 
+    // The header is fixed by the checkpoint but the transactions are not.
+    const auto ec = validate_block::check_block_context_free(*block);
+
+    if (ec)
+    {
+        ++import_rejected_;
+        log::warning(LOG_BLOCKCHAIN)
+            << "Rejected imported block #" << height << " ["
+            << encode_hash(block->header.hash()) << "] " << ec.message();
+        return false;
+    }
+
     // THIS IS THE DATABASE BLOCK WRITE AND INDEX OPERATION.
-    database_.push(*block, height);
+    database_.import(*block, height);
+
+    // Synchronize once per batch, a crash loses at most a batch of imports.
+    if (++imported_ % maximum_commit_batch == 0)
+        database_.synchronize();
+
     return true;
 }
 
@@ -291,6 +352,7 @@ bool block_chain_impl::pop_from(block_detail::list& out_blocks,
     for (uint64_t index = top; index >= height; --index)
     {
         const auto block = std::make_shared<block_detail>(database_.pop());
+        block_messages_.remove(block->hash());
         out_blocks.push_back(block);
     }
 
@@ -306,7 +368,7 @@ void block_chain_impl::start_write()
     BITCOIN_ASSERT(result);
 }
 
-// This call is sequential, but we are preserving the callback model for now.
+// Checks are concurrent, commits are batched in arrival order.
 void block_chain_impl::store(message::block_message::ptr block,
     block_store_handler handler)
 {
@@ -316,50 +378,222 @@ void block_chain_impl::store(message::block_message::ptr block,
         return;
     }
 
-    // We moved write to the network thread using a critical section here.
-    // We do not want to give the thread to any other activity at this point.
-    // A flood of valid orphans from multiple peers could tie up the CPU here,
-    // but resolving that cleanly requires removing the orphan pool.
+    // Fail fast if the block is already stored, without taking the writer.
+    bool exists;
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section.
+        shared_lock lock(mutex_);
+        exists = static_cast<bool>(database_.blocks.get(block->header.hash()));
+        ///////////////////////////////////////////////////////////////////////
+    }
 
-    ////write_dispatch_.ordered(
-    ////    std::bind(&block_chain_impl::do_store,
-    ////        this, block, handler));
+    if (exists)
+    {
+        handler(error::duplicate, 0);
+        return;
+    }
 
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section.
-    unique_lock lock(mutex_);
+    const auto detail = std::make_shared<block_detail>(block);
+    const auto sequence = arrivals_++;
+    const auto checking = ++checking_;
 
-    do_store(block, handler);
-    ///////////////////////////////////////////////////////////////////////////
+    // A flood of blocks from multiple peers could tie up the pool here, so
+    // beyond the limit the check runs on the caller's (network) thread.
+    if (checking > maximum_checking)
+    {
+        check_store(sequence, detail, handler);
+        return;
+    }
+
+    auto peak = checking_peak_.load();
+    while (checking > peak && !checking_peak_.compare_exchange_weak(peak,
+        checking));
+
+    check_dispatch_.concurrent(
+        std::bind(&block_chain_impl::check_store,
+            this, sequence, detail, handler));
 }
 
-// This processes the block through the organizer.
-void block_chain_impl::do_store(message::block_message::ptr block,
-    block_store_handler handler)
+// This performs the context-free block checks, in parallel across blocks.
+void block_chain_impl::check_store(uint64_t sequence,
+    block_detail::ptr detail, block_store_handler handler)
 {
-    start_write();
+    const auto ec = validate_block::check_block_context_free(
+        *detail->actual());
+    --checking_;
 
-    // fail fast if the block is already stored...
-    if (database_.blocks.get(block->header.hash()))
+    if (ec)
     {
-        stop_write(handler, error::duplicate, 0);
+        // The failed block gives up its turn so that later ones commit.
+        handler(ec, 0);
+        enqueue_store(sequence, nullptr, nullptr);
         return;
     }
 
-    const auto detail = std::make_shared<block_detail>(block);
+    detail->set_prechecked();
+    enqueue_store(sequence, detail, handler);
+}
+
+// Queue the checked block once all earlier arrivals are checked, then commit
+// unless another thread is committing. Checks finish out of order, so a
+// block is held until its predecessors are queued (or have failed).
+void block_chain_impl::enqueue_store(uint64_t sequence,
+    block_detail::ptr detail, block_store_handler handler)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section.
+    unique_lock lock(store_mutex_);
 
-    // ...or if the block is already orphaned.
-    if (!organizer_.add(detail))
+    // A full queue holds the checking thread until the committer catches up.
+    // The committer itself never waits, a store handler may store again, and
+    // a failed block queues nothing.
+    const auto full = [this]()
     {
-        stop_write(handler, error::duplicate, 0);
+        return committing_ && store_queue_.size() >= maximum_queued;
+    };
+
+    if (detail && full() && committer_ != std::this_thread::get_id())
+    {
+        ++queue_waits_;
+        store_space_.wait(lock, [this, &full]()
+        {
+            return stopped() || !full();
+        });
+    }
+
+    store_order_.push(sequence, pending_store(detail, handler),
+        [this](pending_store&& pending)
+        {
+            if (pending.first)
+                store_queue_.push_back(std::move(pending));
+        });
+
+    queued_peak_ = std::max(queued_peak_, store_queue_.size());
+
+    if (committing_ || store_queue_.empty())
         return;
+
+    committing_ = true;
+    committer_ = std::this_thread::get_id();
+    lock.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    commit_stores();
+}
+
+// Drain the queue in batches, one database write session per batch.
+void block_chain_impl::commit_stores()
+{
+    while (true)
+    {
+        pending_stores batch;
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section.
+        store_mutex_.lock();
+
+        if (store_queue_.empty())
+        {
+            committing_ = false;
+            committer_ = std::thread::id();
+            store_mutex_.unlock();
+            store_space_.notify_all();
+            return;
+        }
+
+        const auto count = std::min(store_queue_.size(), maximum_commit_batch);
+        batch.reserve(count);
+        std::move(store_queue_.begin(), store_queue_.begin() + count,
+            std::back_inserter(batch));
+        store_queue_.erase(store_queue_.begin(), store_queue_.begin() + count);
+
+        store_mutex_.unlock();
+        ///////////////////////////////////////////////////////////////////////
+
+        store_space_.notify_all();
+
+        if (stopped())
+        {
+            for (const auto& pending: batch)
+                pending.second(error::service_stopped, 0);
+
+            continue;
+        }
+
+        std::vector<bool> added(batch.size(), false);
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section.
+        {
+            unique_lock lock(mutex_);
+            do_store(batch, added);
+        }
+        ///////////////////////////////////////////////////////////////////////
+
+        ++batches_;
+        committed_ += batch.size();
+
+        // Handlers are invoked outside of the write lock.
+        for (size_t index = 0; index < batch.size(); ++index)
+        {
+            const auto& detail = batch[index].first;
+            const auto& handler = batch[index].second;
+
+            if (!added[index])
+                handler(error::duplicate, 0);
+            else
+                handler(detail->error(), detail->height());
+        }
+    }
+}
+
+// This processes the batch of blocks through the organizer.
+void block_chain_impl::do_store(const pending_stores& batch,
+    std::vector<bool>& added)
+{
+    start_write();
+
+    // Defer the per-block flush to the end of the batch.
+    database_.begin_batch();
+
+    for (size_t index = 0; index < batch.size(); ++index)
+    {
+        const auto& detail = batch[index].first;
+
+        // Skip if the block is already stored or already orphaned.
+        added[index] = !database_.blocks.get(detail->hash()) &&
+            organizer_.add(detail);
     }
 
-    // Otherwise organize the chain...
+    // Organize the chain once for the whole batch.
     organizer_.organize();
 
-    //...and then get the particular block's status.
-    stop_write(handler, detail->error(), detail->height());
+    database_.end_batch();
+
+    const auto result = database_.end_write();
+    BITCOIN_ASSERT(result);
+}
+
+block_chain_impl::import_statistics block_chain_impl::import_stats() const
+{
+    import_statistics out;
+    out.checking = checking_.load();
+    out.checking_peak = checking_peak_.load();
+    out.batches = batches_.load();
+    out.committed = committed_.load();
+    out.queue_waits = queue_waits_.load();
+    out.imported = imported_.load();
+    out.import_rejected = import_rejected_.load();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section.
+    shared_lock lock(store_mutex_);
+    out.queued = store_queue_.size();
+    out.queued_peak = queued_peak_;
+    ///////////////////////////////////////////////////////////////////////////
+
+    return out;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -689,6 +923,37 @@ void block_chain_impl::fetch_block(const hash_digest& hash,
     blockchain::fetch_block(*this, hash, handler);
 }
 
+void block_chain_impl::fetch_block_message(const hash_digest& hash,
+    uint32_t magic, block_message_fetch_handler handler)
+{
+    const auto cached = block_messages_.find(hash, magic);
+    if (cached)
+    {
+        handler(error::success, cached);
+        return;
+    }
+
+    const auto frame = [this, hash, magic, handler](const code& ec,
+        chain::block::ptr block)
+    {
+        if (ec)
+        {
+            handler(ec, nullptr);
+            return;
+        }
+
+        // The block payload does not depend on the protocol version.
+        const auto wire = std::make_shared<const data_chunk>(
+            message::serialize(block_message::command, block->to_data(),
+                magic));
+
+        block_messages_.store(hash, magic, wire);
+        handler(error::success, wire);
+    };
+
+    fetch_block(hash, frame);
+}
+
 void block_chain_impl::fetch_block_header(uint64_t height,
     block_header_fetch_handler handler)
 {
@@ -1080,6 +1345,8 @@ operation_result block_chain_impl::store_account_address(std::shared_ptr<account
 	const auto hash = get_short_hash(address->get_name());
 	database_.account_addresses.store(hash, *address);
 	database_.account_addresses.sync();
+	database_.link_account_address(address->get_name(), address->get_address());
+	database_.account_transactions.sync();
 	///////////////////////////////////////////////////////////////////////////
 	return operation_result::okay;
 }
@@ -1096,9 +1363,14 @@ operation_result block_chain_impl::delete_account_address(const std::string& nam
 
 	auto hash = get_short_hash(name);
 	auto addr_vec = database_.account_addresses.get(hash);
-	for( auto each : addr_vec )
+	std::vector<std::string> addresses;
+	for( auto each : addr_vec ) {
+		addresses.push_back(each.get_address());
 		database_.account_addresses.delete_last_row(hash);
+	}
 	database_.account_addresses.sync();
+	database_.unlink_account_addresses(name, addresses);
+	database_.account_transactions.sync();
 	///////////////////////////////////////////////////////////////////////////
 	return operation_result::okay;
 }
@@ -1125,6 +1397,38 @@ std::shared_ptr<std::vector<account_address>> block_chain_impl::get_account_addr
 	return sp_addr;
 }
 
+// The transactions of the account newest first, indexed on first use.
+database::account_transaction::list block_chain_impl::get_account_transactions(
+	const std::string& name, uint64_t start_height, uint64_t end_height,
+	uint64_t offset, uint64_t limit, uint64_t& total)
+{
+	const auto hash = get_short_hash(name);
+	{
+		///////////////////////////////////////////////////////////////////////
+		// Critical Section.
+		shared_lock lock(mutex_);
+
+		if (!database_.account_transactions.empty(hash))
+			return database_.account_transactions.get(hash, start_height,
+				end_height, offset, limit, total);
+		///////////////////////////////////////////////////////////////////////
+	}
+
+	std::vector<std::string> addresses;
+	for (const auto& each: database_.account_addresses.get(hash))
+		addresses.push_back(each.get_address());
+
+	///////////////////////////////////////////////////////////////////////////
+	// Critical Section.
+	unique_lock lock(mutex_);
+
+	database_.build_account_transactions(name, addresses);
+	database_.account_transactions.sync();
+	return database_.account_transactions.get(hash, start_height, end_height,
+		offset, limit, total);
+	///////////////////////////////////////////////////////////////////////////
+}
+
 operation_result block_chain_impl::store_account_asset(const asset_detail& detail)
 {
 	if (stopped())
@@ -1714,19 +2018,7 @@ bool block_chain_impl::get_transaction(const hash_digest& hash,
 		tx_height = result.height();
 		ret = true;
 	} else {
-		boost::mutex mutex;
-		transaction_message::ptr tx_ptr = nullptr;
-		
-		mutex.lock();
-		auto f = [&tx_ptr, &mutex](const code& ec, transaction_message::ptr tx_) -> void
-		{
-			if((code)error::success == ec)
-				tx_ptr = tx_;
-			mutex.unlock();
-		};
-			
-		pool().fetch(hash, f);
-		boost::unique_lock<boost::mutex> lock(mutex);
+		const auto tx_ptr = pool().find_transaction(hash);
 		if(tx_ptr) {
 			tx = *(static_cast<std::shared_ptr<chain::transaction>>(tx_ptr));
 			tx_height = 0;
@@ -1757,19 +2049,9 @@ bool block_chain_impl::get_transaction_callback(const hash_digest& hash,
 		handler(error::success, result.transaction());
 		ret = true;
 	} else {
-		transaction_message::ptr tx_ptr = nullptr;
-		
-		auto f = [&tx_ptr, handler](const code& ec, transaction_message::ptr tx_) -> void
-		{
-			if((code)error::success == ec){
-				tx_ptr = tx_;
-				if(tx_ptr)
-					handler(ec, *(static_cast<std::shared_ptr<chain::transaction>>(tx_ptr)));
-			}
-		};
-			
-		pool().fetch(hash, f);
-		if(tx_ptr) {			
+		const auto tx_ptr = pool().find_transaction(hash);
+		if(tx_ptr) {
+			handler(error::success, *tx_ptr);
 			ret = true;
 		}
 	}
@@ -1998,16 +2280,22 @@ void block_chain_impl::safe_store_account(account& acc, std::vector<std::shared_
     if (stopped())
         return;
 
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section.
+    unique_lock lock(mutex_);
+
     for(auto& address:addresses) {
         const auto hash = get_short_hash(address->get_name());
         database_.account_addresses.safe_store(hash, *address);
+        database_.link_account_address(address->get_name(), address->get_address());
     }
 
     const auto hash = get_hash(acc.get_name());
     database_.accounts.store(hash, acc);
     database_.account_addresses.sync();
+    database_.account_transactions.sync();
     database_.accounts.sync();
-
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 
@@ -36,6 +36,7 @@ static constexpr auto orphan_height = 0u;
 block_detail::block_detail(block_ptr actual_block)
   : code_(error::success),
     processed_(false),
+    prechecked_(false),
     height_(orphan_height),
     actual_block_(actual_block),
     is_checked_work_proof_(false)
@@ -63,6 +64,16 @@ bool block_detail::processed() const
     return processed_.load();
 }
 
+void block_detail::set_prechecked()
+{
+    prechecked_.store(true);
+}
+
+bool block_detail::prechecked() const
+{
+    return prechecked_.load();
+}
+
 void block_detail::set_height(uint64_t height)
 {
     BITCOIN_ASSERT(height != orphan_height);
@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/block_message_cache.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+block_message_cache::block_message_cache(size_t capacity)
+  : capacity_(capacity),
+    size_(0)
+{
+}
+
+block_message_cache::message_ptr block_message_cache::find(
+    const hash_digest& hash, uint32_t magic)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    const auto it = index_.find(hash);
+    if (it == index_.end() || it->second->magic != magic)
+        return nullptr;
+
+    // Move the hit to the front, the back is evicted first.
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->message;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void block_message_cache::store(const hash_digest& hash, uint32_t magic,
+    message_ptr message)
+{
+    if (!message || message->size() > capacity_)
+        return;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    const auto it = index_.find(hash);
+    if (it != index_.end())
+        erase(it->second);
+
+    while (!entries_.empty() && size_ + message->size() > capacity_)
+        erase(std::prev(entries_.end()));
+
+    entries_.push_front({ hash, magic, message });
+    index_.emplace(hash, entries_.begin());
+    size_ += message->size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void block_message_cache::remove(const hash_digest& hash)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    const auto it = index_.find(hash);
+    if (it != index_.end())
+        erase(it->second);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t block_message_cache::size() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    return size_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private, requires the exclusive lock.
+void block_message_cache::erase(list::iterator it)
+{
+    size_ -= it->message->size();
+    index_.erase(it->hash);
+    entries_.erase(it);
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -169,7 +169,8 @@ code organizer::verify(uint64_t fork_point,
         orphan_index, height, *current_block, use_testnet_rules_, checkpoints_,
             callback);
 
-    // Checks that are independent of the chain.
+    // Checks that are independent of the chain, unless already prechecked.
+    validate.set_prechecked(orphan_chain[orphan_index]->prechecked());
     auto ec = validate.check_block(static_cast<blockchain::block_chain_impl&>(this->chain_));
 
     if (ec)
@@ -227,10 +227,10 @@ void transaction_pool::fetch(fetch_all_handler handler)
     const auto tx_fetcher = [this, handler]()
     {
 		std::vector<transaction_ptr> transactions;
-		for(auto item : buffer_)
+		for(const auto& item : buffer_)
 		{
 			if(item.tx)
-				transactions.push_back(item.tx);	
+				transactions.push_back(item.thaw());
 		} 
 		handler(error::success, transactions);
     };
@@ -253,7 +253,7 @@ void transaction_pool::delete_tx(const hash_digest& tx_hash)
             if(item->tx->hash() == tx_hash)
             {
                 log::debug(LOG_BLOCKCHAIN) << " delete_tx hash:" << libbitcoin::encode_hash(tx_hash) << " success";
-                buffer_.erase(item);
+                erase(item);
                 break;
             }
         }
@@ -278,7 +278,7 @@ void transaction_pool::fetch(const hash_digest& transaction_hash,
         if (it == buffer_.end())
             handler(error::not_found, {});
         else
-            handler(error::success, it->tx);
+            handler(error::success, it->thaw());
     };
 
     dispatch_.ordered(tx_fetcher);
@@ -404,16 +404,72 @@ void transaction_pool::add(transaction_ptr tx, confirm_handler handler)
     if (maintain_consistency_ && buffer_.size() == buffer_.capacity())
         delete_package(error::pool_filled);
 
-    buffer_.push_back({ tx, handler });
+    const auto frozen = frozen_transaction::freeze(*tx);
+
+    // The stored transaction is handed out while its sender holds it.
+    const auto cache = std::make_shared<thawed>();
+    cache->tx = tx;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    buffer_.push_back({ frozen, tx->originator(), handler, cache });
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+transaction_pool::transaction_ptr transaction_pool::entry::cached() const
+{
+    if (!cache)
+        return nullptr;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    scoped_lock lock(cache->mutex);
+
+    return cache->tx.lock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+transaction_pool::transaction_ptr transaction_pool::entry::thaw() const
+{
+    const auto hit = cached();
+    if (hit)
+        return hit;
+
+    // Parse outside of the cache lock, a concurrent thaw may win the store.
+    const auto out = std::make_shared<message::transaction_message>(
+        tx->thaw());
+    out->set_originator(originator);
+
+    if (!cache)
+        return out;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    scoped_lock lock(cache->mutex);
+
+    const auto stored = cache->tx.lock();
+    if (stored)
+        return stored;
+
+    cache->tx = out;
+    return out;
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 // There has been a reorg, clear the memory pool using the given reason code.
 void transaction_pool::clear(const code& ec)
 {
     for (const auto& entry: buffer_)
-        entry.handle_confirm(ec, entry.tx);
+        entry.handle_confirm(ec, entry.thaw());
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
 
     buffer_.clear();
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 // Delete memory pool txs that are obsoleted by a new block acceptance.
@@ -458,9 +514,9 @@ void transaction_pool::delete_spent_in_blocks(const block_list& blocks)
 void transaction_pool::delete_dependencies(const output_point& point,
     const code& ec)
 {
-    const auto comparitor = [&point](const input& input)
+    const auto comparitor = [&point](const output_point& previous_output)
     {
-        return input.previous_output == point;
+        return previous_output == point;
     };
 
     delete_dependencies(comparitor, ec);
@@ -470,9 +526,9 @@ void transaction_pool::delete_dependencies(const output_point& point,
 void transaction_pool::delete_dependencies(const hash_digest& tx_hash,
     const code& ec)
 {
-    const auto comparitor = [&tx_hash](const input& input)
+    const auto comparitor = [&tx_hash](const output_point& previous_output)
     {
-        return input.previous_output.hash == tx_hash;
+        return previous_output.hash == tx_hash;
     };
 
     delete_dependencies(comparitor, ec);
@@ -486,8 +542,8 @@ void transaction_pool::delete_dependencies(input_compare is_dependency,
 {
     std::vector<entry> dependencies;
     for (const auto& entry: buffer_)
-        for (const auto& input: entry.tx->inputs)
-            if (is_dependency(input))
+        for (size_t index = 0; index < entry.tx->inputs_size(); ++index)
+            if (is_dependency(entry.tx->previous_output(index)))
             {
                 dependencies.push_back(entry);
                 break;
@@ -495,7 +551,8 @@ void transaction_pool::delete_dependencies(input_compare is_dependency,
 
     // We queue deletion to protect the iterator.
     for (const auto& dependency: dependencies)
-        delete_package(dependency.tx, ec);
+        if (delete_single(dependency.tx->hash(), ec))
+            delete_dependencies(dependency.tx->hash(), ec);
 }
 
 void transaction_pool::delete_package(const code& ec)
@@ -506,8 +563,9 @@ void transaction_pool::delete_package(const code& ec)
     // Must copy the entry because it is going to be deleted from the list.
     const auto oldest = buffer_.front();
 
-    oldest.handle_confirm(ec, oldest.tx);
-    delete_package(oldest.tx, ec);
+    oldest.handle_confirm(ec, oldest.thaw());
+    if (delete_single(oldest.tx->hash(), ec))
+        delete_dependencies(oldest.tx->hash(), ec);
 }
 
 void transaction_pool::delete_package(transaction_ptr tx, const code& ec)
@@ -531,8 +589,8 @@ bool transaction_pool::delete_single(const hash_digest& tx_hash, const code& ec)
     if (it == buffer_.end())
         return false;
 
-    it->handle_confirm(ec, it->tx);
-    buffer_.erase(it);
+    it->handle_confirm(ec, it->thaw());
+    erase(it);
 
     while(1){
         const auto it = std::find_if(buffer_.begin(), buffer_.end(), matched);
@@ -540,13 +598,93 @@ bool transaction_pool::delete_single(const hash_digest& tx_hash, const code& ec)
         if (it == buffer_.end())
             break;
 
-        it->handle_confirm(ec, it->tx);
-        buffer_.erase(it);
+        it->handle_confirm(ec, it->thaw());
+        erase(it);
     }
 
     return true;
 }
 
+void transaction_pool::erase(buffer::iterator it)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    buffer_.erase(it);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+transaction_pool::transaction_ptr transaction_pool::find_transaction(
+    const hash_digest& tx_hash) const
+{
+    chain::frozen_transaction::ptr frozen;
+    uint64_t originator = 0;
+    std::shared_ptr<thawed> cache;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+
+    const auto it = find(tx_hash);
+    if (it != buffer_.end())
+    {
+        frozen = it->tx;
+        originator = it->originator;
+        cache = it->cache;
+    }
+
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // The frozen transaction is immutable, so it is thawed outside the lock.
+    if (!frozen)
+        return nullptr;
+
+    return entry{ frozen, originator, nullptr, cache }.thaw();
+}
+
+std::vector<transaction_pool::transaction_ptr> transaction_pool::snapshot() const
+{
+    std::vector<entry> entries;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+
+    entries.reserve(buffer_.size());
+    for (const auto& item: buffer_)
+        entries.push_back({ item.tx, item.originator, nullptr, item.cache });
+
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    std::vector<transaction_ptr> transactions;
+    transactions.reserve(entries.size());
+    for (const auto& item: entries)
+        transactions.push_back(item.thaw());
+
+    return transactions;
+}
+
+hash_list transaction_pool::transaction_hashes() const
+{
+    hash_list hashes;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+
+    hashes.reserve(buffer_.size());
+    for (const auto& item: buffer_)
+        hashes.push_back(item.tx->hash());
+
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return hashes;
+}
+
 bool transaction_pool::find(transaction_ptr& out_tx,
     const hash_digest& tx_hash) const
 {
@@ -554,7 +692,7 @@ bool transaction_pool::find(transaction_ptr& out_tx,
     const auto found = it != buffer_.end();
 
     if (found)
-        out_tx = it->tx;
+        out_tx = it->thaw();
 
     return found;
 }
@@ -567,8 +705,8 @@ bool transaction_pool::find(chain::transaction& out_tx,
 
     if (found)
     {
-        // TRANSACTION COPY
-        out_tx = *(it->tx);
+        const auto hit = it->cached();
+        out_tx = hit ? *hit : it->tx->thaw();
     }
 
     return found;
@@ -590,11 +728,14 @@ transaction_pool::const_iterator transaction_pool::find(
 {
     const auto found = [&assert_name](const entry& entry)
     {
-        for(auto& output : entry.tx->outputs)
+        for(size_t index = 0; index < entry.tx->outputs_size(); ++index)
+        {
+            auto output = entry.tx->output_at(index);
             if(output.is_asset_issue() 
 				&& output.get_asset_symbol() == assert_name){
                 return true;
             } 
+        }
 
         return false;
     };
@@ -632,7 +773,7 @@ bool transaction_pool::is_spent_in_pool(const output_point& outpoint) const
 {
     const auto found = [&outpoint](const entry& entry)
     {
-        return is_spent_by_tx(outpoint, entry.tx);
+        return is_spent_by_tx(outpoint, *entry.tx);
     };
 
     return std::any_of(buffer_.begin(), buffer_.end(), found);
@@ -650,5 +791,15 @@ bool transaction_pool::is_spent_by_tx(const output_point& outpoint,
     return std::any_of(inputs.begin(), inputs.end(), found);
 }
 
+bool transaction_pool::is_spent_by_tx(const output_point& outpoint,
+    const frozen_transaction& tx)
+{
+    for (size_t index = 0; index < tx.inputs_size(); ++index)
+        if (tx.previous_output(index) == outpoint)
+            return true;
+
+    return false;
+}
+
 } // namespace blockchain
 } // namespace libbitcoin
@@ -100,6 +100,7 @@ validate_block::validate_block(size_t height, const block& block, bool testnet,
     height_(height),
     activations_(script_context::none_enabled),
     minimum_version_(0),
+    prechecked_(false),
     current_block_(block),
     checkpoints_(checks),
     stop_callback_(callback)
@@ -194,17 +195,68 @@ bool validate_block::stopped() const
     return stop_callback_();
 }
 
+code validate_block::check_block_context_free(const block& block)
+{
+    // These checks depend on nothing but the block itself, so they may run
+    // on any thread before the block reaches the organizer.
+    const auto& transactions = block.transactions;
+
+    if (transactions.empty() || block.serialized_size() > max_block_size)
+        return error::size_limits;
+
+    unsigned int coinbase_count = 0;
+    for(auto& i : transactions){
+        if(i.is_coinbase()) {
+            if(i.outputs.size() > 1 || const_cast<chain::output&>(i.outputs[0]).is_etp() == false) {
+                return error::first_not_coinbase;
+            }
+            ++coinbase_count;
+        }
+    }
+    if(coinbase_count == 0){
+        return error::first_not_coinbase;
+    }
+
+    for (auto it = transactions.begin() + coinbase_count; it != transactions.end(); ++it)
+    {
+        if (it->is_coinbase())
+            return error::extra_coinbases;
+    }
+
+    if (!is_distinct_tx_set(transactions))
+    {
+        log::warning(LOG_BLOCKCHAIN) << "is_distinct_tx_set!!!";
+        return error::duplicate;
+    }
+
+    const auto sigops = legacy_sigops_count(transactions);
+    if (sigops > max_block_script_sigops)
+        return error::too_many_sigs;
+
+    if (block.header.merkle != block::generate_merkle_root(transactions))
+        return error::merkle_mismatch;
+
+    return error::success;
+}
+
+void validate_block::set_prechecked(bool prechecked)
+{
+    prechecked_ = prechecked;
+}
+
 code validate_block::check_block(blockchain::block_chain_impl& chain) const
 {
     // These are checks that are independent of the blockchain
     // that can be validated before saving an orphan block.
 
-    const auto& transactions = current_block_.transactions;
-
-    if (transactions.empty() ||
-        current_block_.serialized_size() > max_block_size)
-        return error::size_limits;
+    if (!prechecked_)
+    {
+        const auto ec = check_block_context_free(current_block_);
+        if (ec)
+            return ec;
+    }
 
+    const auto& transactions = current_block_.transactions;
     const auto& header = current_block_.header;
 
     if (!is_valid_proof_of_work(header))
@@ -240,27 +292,6 @@ code validate_block::check_block(blockchain::block_chain_impl& chain) const
 
     RETURN_IF_STOPPED();
 
-    unsigned int coinbase_count = 0;
-    for(auto i : transactions){
-        if(i.is_coinbase()) {
-            if(i.outputs.size() > 1 || i.outputs[0].is_etp() == false) {
-                return error::first_not_coinbase;
-            }
-            ++coinbase_count;
-        }
-    }
-    if(coinbase_count == 0){
-        return error::first_not_coinbase;
-    }
-
-    for (auto it = transactions.begin() + coinbase_count; it != transactions.end(); ++it)
-    {
-        RETURN_IF_STOPPED();
-
-        if (it->is_coinbase())
-            return error::extra_coinbases;
-    }
-
     std::set<string> assets;
     for (const auto& tx: transactions)
     {
@@ -280,25 +311,6 @@ code validate_block::check_block(blockchain::block_chain_impl& chain) const
        }
     }
 
-    RETURN_IF_STOPPED();
-
-    if (!is_distinct_tx_set(transactions))
-    {
-        log::warning(LOG_BLOCKCHAIN) << "is_distinct_tx_set!!!";
-        return error::duplicate;
-    }
-
-    RETURN_IF_STOPPED();
-
-    const auto sigops = legacy_sigops_count(transactions);
-    if (sigops > max_block_script_sigops)
-        return error::too_many_sigs;
-
-    RETURN_IF_STOPPED();
-
-    if (header.merkle != block::generate_merkle_root(transactions))
-        return error::merkle_mismatch;
-
     return error::success;
 }
 
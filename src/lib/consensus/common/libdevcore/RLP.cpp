@@ -314,31 +314,6 @@ RLPStream& RLPStream::append(bytesConstRef _s, bool _compact)
 	return *this;
 }
 
-RLPStream& RLPStream::append(bigint _i)
-{
-	if (!_i)
-		m_out.push_back(c_rlpDataImmLenStart);
-	else if (_i < c_rlpDataImmLenStart)
-		m_out.push_back((byte)_i);
-	else
-	{
-		unsigned br = bytesRequired(_i);
-		if (br < c_rlpDataImmLenCount)
-			m_out.push_back((byte)(br + c_rlpDataImmLenStart));
-		else
-		{
-			auto brbr = bytesRequired(br);
-			if (c_rlpDataIndLenZero + brbr > 0xff)
-				BOOST_THROW_EXCEPTION(RLPException() << errinfo_comment("Number too large for RLP"));
-			m_out.push_back((byte)(c_rlpDataIndLenZero + brbr));
-			pushInt(br, brbr);
-		}
-		pushInt(_i, br);
-	}
-	noteAppended();
-	return *this;
-}
-
 void RLPStream::pushCount(size_t _count, byte _base)
 {
 	auto br = bytesRequired(_count);
@@ -114,41 +114,57 @@ bool MinerAux::search(libbitcoin::chain::header& header, std::function<bool (voi
 	return ethashReturn.success;
 }
 
+// Bounds the set of headers whose seal was verified ahead of validation.
+static constexpr size_t c_maxVerifiedSeals = 100000;
+
 bool MinerAux::verifySeal(libbitcoin::chain::header& _header, libbitcoin::chain::header& _parent)
 {
-	Result result;
-	h256 seedHash = HeaderAux::seedHash(_header);
-	h256 headerHash  = HeaderAux::hashHead(_header);
-	Nonce nonce = (Nonce)_header.nonce;
 	if( _header.bits != HeaderAux::calculateDifficulty(_header, _parent))
 	{
 		log::error(LOG_MINER) << _header.number<<" block , verify diffculty failed\n";
 		return false;
 	}
-	DEV_GUARDED(get()->x_fulls)
-	if (FullType dag = get()->m_fulls[seedHash].lock())
-	{
-		result = dag->compute(headerHash, nonce);
-
-		if(result.value <= HeaderAux::boundary(_header) && (result.mixHash).hex() == ((h256)_header.mixhash).hex())
-		{
-			//log::debug(LOG_MINER) << _header.number <<" block has been verified (Full)\n";
-			return true;
-		}
-		return false;
-	}
-	result = get()->get_light(seedHash)->compute(headerHash, nonce);
-	if(result.value <= HeaderAux::boundary(_header) && (result.mixHash).hex() == ((h256)_header.mixhash).hex())
-	{
-		//log::debug(LOG_MINER) << _header.number <<" block has been verified (Light)\n";
+	if (isProofOfWorkVerified(_header.hash()))
+		return true;
+	if (verifyProofOfWork(_header))
 		return true;
-	}
 	log::error(LOG_MINER) << _header.number <<" block  verified failed !\n";
 	return false;
 }
 
+bool MinerAux::verifyProofOfWork(libbitcoin::chain::header& _header)
+{
+	Result result;
+	h256 seedHash = HeaderAux::seedHash(_header);
+	h256 headerHash  = HeaderAux::hashHead(_header);
+	Nonce nonce = (Nonce)_header.nonce;
+	FullType dag;
+	DEV_GUARDED(get()->x_fulls)
+		dag = get()->m_fulls[seedHash].lock();
+	if (dag)
+		result = dag->compute(headerHash, nonce);
+	else
+		result = get()->get_light(seedHash)->compute(headerHash, nonce);
 
+	if (result.value > HeaderAux::boundary(_header) || (result.mixHash).hex() != ((h256)_header.mixhash).hex())
+		return false;
 
+	const auto hash = _header.hash();
+	WriteGuard l(get()->x_verified);
+	if (get()->m_verified.insert(hash).second)
+	{
+		get()->m_verifiedOrder.push_back(hash);
+		if (get()->m_verifiedOrder.size() > c_maxVerifiedSeals)
+		{
+			get()->m_verified.erase(get()->m_verifiedOrder.front());
+			get()->m_verifiedOrder.pop_front();
+		}
+	}
+	return true;
+}
 
-
-
+bool MinerAux::isProofOfWorkVerified(const hash_digest& _hash)
+{
+	ReadGuard l(get()->x_verified);
+	return get()->m_verified.count(_hash) != 0;
+}
@@ -25,6 +25,8 @@
 
 #include <algorithm>
 #include <functional>
+#include <future>
+#include <memory>
 #include <system_error>
 #include <boost/thread.hpp>
 #include <metaverse/consensus/miner/MinerAux.h>
@@ -42,7 +44,7 @@ namespace libbitcoin{
 namespace consensus{
 typedef boost::tuple<double, double, int64_t, miner::transaction_ptr> transaction_priority;
 
-miner::miner(p2p_node& node) : node_(node), state_(state::init_), setting_(node_.chain_impl().chain_settings())
+miner::miner(p2p_node& node) : node_(node), state_(state::init_), work_stale_(false), tip_height_(0), setting_(node_.chain_impl().chain_settings())
 {
     if (setting_.use_testnet_rules){
         bc::HeaderAux::set_as_testnet();
@@ -56,16 +58,7 @@ miner::~miner()
 
 bool miner::get_transaction(std::vector<transaction_ptr>& transactions)
 {
-	boost::mutex mutex;
-	mutex.lock();
-	auto f = [&transactions, &mutex](const error_code& code, const vector<transaction_ptr>& transactions_) -> void
-	{
-		transactions = transactions_;
-		mutex.unlock();
-	};
-	node_.pool().fetch(f);
-
-	boost::unique_lock<boost::mutex> lock(mutex);
+	transactions = node_.pool().snapshot();
 
 	if(transactions.empty() == false) {
 		set<hash_digest> sets;
@@ -510,21 +503,19 @@ unsigned int miner::get_median_time_past(uint64_t height)
 
 uint64_t miner::store_block(block_ptr block)
 {
-	uint64_t height;
-	boost::mutex mutex;
-	mutex.lock();
-	auto f = [&height, &mutex](const error_code& code, boost::uint64_t new_height) -> void
+	// The store handler runs on a pool thread, hand the height back through a promise.
+	auto stored = std::make_shared<std::promise<uint64_t>>();
+	auto f = [stored](const error_code& code, boost::uint64_t new_height) -> void
 	{
 		if(new_height == 0 && code.value() != 0)
 			log::error(LOG_HEADER) << "store_block error_code: " << code.value();
 
-		height = new_height;
-		mutex.unlock();
+		stored->set_value(new_height);
 	};
+	auto height = stored->get_future();
 	node_.chain().store(block, f);
 
-	boost::unique_lock<boost::mutex> lock(mutex);
-	return height;
+	return height.get();
 }
 
 template <class _T>
@@ -619,76 +610,137 @@ bool miner::set_miner_payment_address(const bc::wallet::payment_address& address
 
 miner::block_ptr miner::get_block(bool is_force_create_block)
 {
-	static std::mutex mtx;
-	std::lock_guard<std::mutex> lock(mtx);
+	std::lock_guard<std::mutex> lock(block_mutex_);
+	return refresh_block(is_force_create_block);
+}
+
+// Call with the block mutex held.
+miner::block_ptr miner::refresh_block(bool is_force_create_block)
+{
+	subscribe_reorganize();
 
 	if(is_force_create_block) {
-		new_block_ = create_new_block(pay_address_);
+		set_block(create_new_block(pay_address_));
 		log::debug(LOG_HEADER) << "force create new block";
 		return new_block_;
 	}
 
 	if(!new_block_){
 		if(pay_address_) {
-			new_block_ = create_new_block(pay_address_);
+			set_block(create_new_block(pay_address_));
 		} else {
 			log::error(LOG_HEADER) << "get_block not set pay address";
 		}
-	} else {
-		if(get_height() >= new_block_->header.number){
-			new_block_ = create_new_block(pay_address_);
-		}
+	} else if(work_stale_.exchange(false) || tip_height_ >= new_block_->header.number) {
+		set_block(create_new_block(pay_address_));
 	}
 
 	return new_block_;
 }
 
+// Call with the block mutex held, the work strings are hashed once per template.
+void miner::set_block(block_ptr block)
+{
+	new_block_ = block;
+	if(new_block_) {
+		work_header_hash_ = "0x" + to_string(HeaderAux::hashHead(new_block_->header));
+		work_seed_hash_ = "0x" + to_string(HeaderAux::seedHash(new_block_->header));
+		work_boundary_ = "0x" + to_string(HeaderAux::boundary(new_block_->header));
+	}
+}
+
 bool miner::get_work(std::string& seed_hash, std::string& header_hash, std::string& boundary)
 {
-	block_ptr block = get_block();
-	if(block) {
-		header_hash = "0x" + to_string(HeaderAux::hashHead(new_block_->header));
-		seed_hash = "0x" + to_string(HeaderAux::seedHash(new_block_->header));
-		boundary = "0x" + to_string(HeaderAux::boundary(new_block_->header));
+	std::lock_guard<std::mutex> lock(block_mutex_);
+	if(refresh_block(false)) {
+		header_hash = work_header_hash_;
+		seed_hash = work_seed_hash_;
+		boundary = work_boundary_;
 		return true; 
 	}
 	return false;
 }
 
+void miner::subscribe_work(work_handler handler)
+{
+	{
+		std::lock_guard<std::mutex> lock(work_handlers_mutex_);
+		work_handlers_.push_back(handler);
+	}
+
+	subscribe_reorganize();
+}
+
+// The tip height is read from the store once, then follows the subscription.
+void miner::subscribe_reorganize()
+{
+	std::call_once(work_subscribed_, [this]{
+		node_.subscribe_blockchain(std::bind(&miner::handle_reorganized, this,
+			std::placeholders::_1, std::placeholders::_2,
+			std::placeholders::_3, std::placeholders::_4));
+		tip_height_ = get_height();
+	});
+}
+
+bool miner::handle_reorganized(const code& ec, uint64_t fork_point,
+	const block_ptr_list& new_blocks, const block_ptr_list& old_blocks)
+{
+	if (ec == (code)error::service_stopped)
+		return false;
+
+	if (ec || new_blocks.empty())
+		return true;
+
+	// The template is rebuilt by the next get_work, not on this thread.
+	tip_height_ = fork_point + new_blocks.size();
+	work_stale_ = true;
+
+	std::lock_guard<std::mutex> lock(work_handlers_mutex_);
+	for (const auto& handler: work_handlers_)
+		handler();
+
+	return true;
+}
+
 bool miner::put_result(const std::string& nonce, const std::string& mix_hash, const std::string& header_hash)
 {
-	bool ret = false;
-    if (!get_block()) {
-        return ret;
-    }
-	if(header_hash == "0x"+ to_string(HeaderAux::hashHead(new_block_->header))){
-        auto s_nonce = "0x" + nonce;
-        uint64_t n_nonce;
+	auto s_nonce = "0x" + nonce;
+	uint64_t n_nonce;
 #ifdef MAC_OSX
-        size_t sz = 0;
-        n_nonce = std::stoull(s_nonce, &sz, 16);
+	size_t sz = 0;
+	n_nonce = std::stoull(s_nonce, &sz, 16);
 #else
-        if(sscanf(s_nonce.c_str(), "%lx", &n_nonce) != 1) {
-		    log::error(LOG_HEADER) << "nonce change error\n";
-            return false;
-        }
+	if(sscanf(s_nonce.c_str(), "%lx", &n_nonce) != 1) {
+		log::error(LOG_HEADER) << "nonce change error\n";
+		return false;
+	}
 #endif
-		uint64_t nonce_t = n_nonce ^0x6675636b6d657461;
-		new_block_->header.nonce = (u64) nonce_t;
-		new_block_->header.mixhash = (FixedHash<32>::Arith)h256(mix_hash);
-		uint64_t height = store_block(new_block_);
-		if(height != 0){
-			log::debug(LOG_HEADER) << "put_result nonce:" << nonce << " mix_hash:" << mix_hash << " success with height:" << height;
-			ret = true;
-		} else {
-			get_block(true);
-			log::debug(LOG_HEADER) << "put_result nonce:" << nonce << " mix_hash:" << mix_hash << " fail";
+
+	// Seal a copy under the lock, the template stays shared with other workers.
+	block_ptr block;
+	{
+		std::lock_guard<std::mutex> lock(block_mutex_);
+		if(!refresh_block(false)) {
+			return false;
 		}
-	} else {
-		log::error(LOG_HEADER) << "put_result header_hash check fail. header_hash:" << header_hash << " hashHead:" << to_string(HeaderAux::hashHead(new_block_->header));
+		if(header_hash != work_header_hash_) {
+			log::error(LOG_HEADER) << "put_result header_hash check fail. header_hash:" << header_hash << " hashHead:" << work_header_hash_;
+			return false;
+		}
+		block = std::make_shared<message::block_message>(*new_block_);
+		block->header.nonce = (u64)(n_nonce ^ 0x6675636b6d657461);
+		block->header.mixhash = (FixedHash<32>::Arith)h256(mix_hash);
 	}
 
-	return ret;
+	uint64_t height = store_block(block);
+	if(height != 0){
+		log::debug(LOG_HEADER) << "put_result nonce:" << nonce << " mix_hash:" << mix_hash << " success with height:" << height;
+		return true;
+	}
+
+	get_block(true);
+	log::debug(LOG_HEADER) << "put_result nonce:" << nonce << " mix_hash:" << mix_hash << " fail";
+	return false;
 }
 
 void miner::get_state(uint64_t &height, uint64_t &rate, string& difficulty, bool& is_mining)
@@ -97,40 +97,34 @@ bool data_base::is_higher_database(const path& prefix)
 
 bool data_base::upgrade_database(const settings& settings, const chain::block& genesis)
 {
-	auto metadata_path = default_data_path() / settings.directory / db_metadata::file_name;
+	// The directory is already absolute, see executor::menu.
+	const auto& prefix = settings.directory;
+	auto metadata_path = prefix / db_metadata::file_name;
 	auto metadata = db_metadata();
 	data_base::read_metadata(metadata_path, metadata);
-	auto ret_flag = false;
-	
-	// no need resynchronize blockchain -- blockchain asset structure modified
-	if(metadata.version_<= "0.6.1") {
-		log::info("database") << "The local database is being upgraded, it may take a while to re-synchronize the block data, please wait...";
-		// Create paths.
-		auto prefix = default_data_path() / settings.directory;
-		const blockchain_asset_store paths(prefix);
+
+	// Only the 0.6.3 step runs at start, the 0.6.1 blockchain asset rescan
+	// never did. The version is written once the step succeeded, so that a
+	// failed step is retried on the next start.
+
+	// account transaction index added, accounts are indexed on first use
+	if(metadata.version_ < "0.6.3") {
+		log::info("database") << "The local database is being upgraded with the account transaction index.";
+		const account_transaction_store paths(prefix);
 
 		if (!paths.touch_all())
 			return false;
-		
+
 		data_base instance(settings);
 
-		if (!instance.blockchain_asset_create())
+		if (!instance.account_transaction_create() || !instance.stop())
 			return false;
-		instance.stop();
-		instance.start();
-		//instance.upgrade_address_utxo();
-		instance.upgrade_blockchain_asset();
-		instance.synchronize();
-		// metadata
-		auto metadata_path = default_data_path() / settings.directory / db_metadata::file_name;
-		//auto metadata = db_metadata();
-		//data_base::read_metadata(metadata_path, metadata); // maybe do recover according db version
-		auto metadata = db_metadata(db_metadata::current_version);
-		data_base::write_metadata(metadata_path, metadata);
-		ret_flag = instance.stop();
-	} 
-
-	return ret_flag;
+	}
+
+	// metadata
+	metadata = db_metadata(db_metadata::current_version);
+	data_base::write_metadata(metadata_path, metadata);
+	return true;
 }
 
 void data_base::set_admin(const std::string& name, const std::string& passwd)
@@ -153,6 +147,10 @@ data_base::store::store(const path& prefix)
 	account_assets_rows = prefix / "account_asset_row";
 	account_addresses_lookup = prefix / "account_address_table";
     account_addresses_rows = prefix / "account_address_rows";
+    account_transactions_lookup = prefix / "account_transaction_table";
+    account_transactions_rows = prefix / "account_transaction_rows";
+    address_accounts_lookup = prefix / "address_account_table";
+    address_accounts_rows = prefix / "address_account_rows";
 	/* end database for account, asset, address_asset relationship */
 
     // Height-based (reverse) lookup.
@@ -185,7 +183,11 @@ bool data_base::store::touch_all() const
         touch_file(account_assets_lookup)&&
         touch_file(account_assets_rows)&&
 		touch_file(account_addresses_lookup)&&
-		touch_file(account_addresses_rows);
+		touch_file(account_addresses_rows)&&
+		touch_file(account_transactions_lookup)&&
+		touch_file(account_transactions_rows)&&
+		touch_file(address_accounts_lookup)&&
+		touch_file(address_accounts_rows);
 		/* end database for account, asset, address_asset relationship */
 }
 
@@ -246,6 +248,24 @@ bool data_base::blockchain_asset_store::touch_all() const
 		/* end database for account, asset, address_asset relationship */
 }
 
+data_base::account_transaction_store::account_transaction_store(const path& prefix)
+{
+    account_transactions_lookup = prefix / "account_transaction_table";
+    account_transactions_rows = prefix / "account_transaction_rows";
+    address_accounts_lookup = prefix / "address_account_table";
+    address_accounts_rows = prefix / "address_account_rows";
+}
+
+bool data_base::account_transaction_store::touch_all() const
+{
+    // Return the result of the database file create.
+    return
+        touch_file(account_transactions_lookup) &&
+        touch_file(account_transactions_rows) &&
+        touch_file(address_accounts_lookup) &&
+        touch_file(address_accounts_rows);
+}
+
 data_base::db_metadata::db_metadata():version_("")
 {	
 }
@@ -384,6 +404,7 @@ data_base::data_base(const store& paths, size_t history_height,
     stealth_height_(stealth_height),
     sequential_lock_(0),
     mutex_(std::make_shared<shared_mutex>()),
+    batching_(false),
     blocks(paths.blocks_lookup, paths.blocks_index, mutex_),
     history(paths.history_lookup, paths.history_rows, mutex_),
     stealth(paths.stealth_rows, mutex_),
@@ -394,7 +415,9 @@ data_base::data_base(const store& paths, size_t history_height,
 	assets(paths.assets_lookup, mutex_),
 	address_assets(paths.address_assets_lookup, paths.address_assets_rows, mutex_),
 	account_assets(paths.account_assets_lookup, paths.account_assets_rows, mutex_),
-    account_addresses(paths.account_addresses_lookup, paths.account_addresses_rows, mutex_)
+    account_addresses(paths.account_addresses_lookup, paths.account_addresses_rows, mutex_),
+    account_transactions(paths.account_transactions_lookup, paths.account_transactions_rows,
+        paths.address_accounts_lookup, paths.address_accounts_rows, mutex_)
 	/* end database for account, asset, address_asset relationship */
 {
 }
@@ -454,7 +477,8 @@ bool data_base::create()
 		assets.create()&&
 		address_assets.create()&&
 		account_assets.create()&&
-		account_addresses.create()
+		account_addresses.create()&&
+		account_transactions.create()
 		/* end database for account, asset, address_asset relationship */
 		;
 }
@@ -482,12 +506,17 @@ bool data_base::blockchain_asset_create()
 		/* end database for account, asset, address_asset relationship */
 		;
 }
+bool data_base::account_transaction_create()
+{
+    return account_transactions.create();
+}
 bool data_base::account_db_start()
 {
 	return 
 		accounts.start()&&
 		account_assets.start()&&
-		account_addresses.start();
+		account_addresses.start()&&
+		account_transactions.start();
 }
 
 void data_base::upgrade_blockchain_asset()
@@ -550,7 +579,8 @@ bool data_base::start()
 		assets.start()&&
 		address_assets.start()&&
 		account_assets.start()&&
-		account_addresses.start()
+		account_addresses.start()&&
+		account_transactions.start()
 		/* end database for account, asset, address_asset relationship */
         ;
     const auto end_exclusive = end_write();
@@ -574,6 +604,7 @@ bool data_base::stop()
 	const auto address_assets_stop = address_assets.stop();
 	const auto account_assets_stop = account_assets.stop();
 	const auto account_addresses_stop = account_addresses.stop();
+	const auto account_transactions_stop = account_transactions.stop();
 	/* end database for account, asset, address_asset relationship */
     const auto end_exclusive = end_write();
 
@@ -596,6 +627,7 @@ bool data_base::stop()
 		address_assets_stop &&
 		account_assets_stop &&
 		account_addresses_stop &&
+		account_transactions_stop &&
 		/* end database for account, asset, address_asset relationship */
         end_exclusive;
 }
@@ -614,6 +646,7 @@ bool data_base::close()
 	const auto address_assets_close = address_assets.close();
 	const auto account_assets_close = account_assets.close();
 	const auto account_addresses_close = account_addresses.close();
+	const auto account_transactions_close = account_transactions.close();
 	/* end database for account, asset, address_asset relationship */
 
     // Return the cumulative result of the database closes.
@@ -628,7 +661,8 @@ bool data_base::close()
 		assets_close &&
 		address_assets_close&&
 		account_assets_close&&
-		account_addresses_close
+		account_addresses_close&&
+		account_transactions_close
 		/* end database for account, asset, address_asset relationship */
         ;
 }
@@ -696,6 +730,7 @@ void data_base::synchronize()
 	address_assets.sync();
 	account_assets.sync();
 	account_addresses.sync();
+	account_transactions.sync();
 	/* end database for account, asset, address_asset relationship */
     blocks.sync();
 }
@@ -707,6 +742,15 @@ void data_base::push(const block& block)
 }
 
 void data_base::push(const block& block, uint64_t height)
+{
+    import(block, height);
+
+    // Synchronise everything that was added, unless deferred to the batch.
+    if (!batching_)
+        synchronize();
+}
+
+void data_base::import(const block& block, uint64_t height)
 {
     for (size_t index = 0; index < block.transactions.size(); ++index)
     {
@@ -729,14 +773,25 @@ void data_base::push(const block& block, uint64_t height)
         // Add stealth outputs
         push_stealth(tx_hash, height, tx.outputs);
 
+        // Add to the indexed transactions of accounts
+        push_account_transactions(tx, tx_hash, height);
+
         // Add transaction
         transactions.store(height, index, tx);
     }
 
     // Add block itself.
     blocks.store(block, height);
+}
+
+void data_base::begin_batch()
+{
+    batching_ = true;
+}
 
-    // Synchronise everything that was added.
+void data_base::end_batch()
+{
+    batching_ = false;
     synchronize();
 }
 
@@ -882,6 +937,7 @@ chain::block data_base::pop()
     for (auto tx = txs.rbegin(); tx != txs.rend(); ++tx)
     {
         transactions.remove(tx->hash());
+        pop_account_transactions(*tx, height);
         pop_outputs(tx->outputs, height);
 
         if (!tx->is_coinbase())
@@ -953,6 +1009,142 @@ void data_base::pop_outputs(const output::list& outputs, size_t height)
         }
     }
 }
+/* begin account transaction index */
+
+static short_hash get_short_hash(const std::string& str)
+{
+    const data_chunk data(str.begin(), str.end());
+    return ripemd160_hash(data);
+}
+
+// The rows of the business records, ascending in height, one per transaction.
+static void append_records(account_transaction::list& rows,
+    std::set<hash_digest>& hashes, const business_record::list& records)
+{
+    for (const auto& record: records)
+        if (hashes.insert(record.point.hash).second)
+            rows.push_back({ static_cast<uint32_t>(record.height),
+                record.point.hash, record.data.get_timestamp() });
+}
+
+static void sort_by_height(account_transaction::list& rows)
+{
+    std::stable_sort(rows.begin(), rows.end(),
+        [](const account_transaction& lhs, const account_transaction& rhs)
+        {
+            return lhs.height < rhs.height;
+        });
+}
+
+// The accounts of the addresses the transaction spends from or pays to.
+std::set<short_hash> data_base::transaction_accounts(
+    const chain::transaction& tx) const
+{
+    std::set<short_hash> result;
+    const auto add = [this, &result](const chain::script& script)
+    {
+        const auto address = payment_address::extract(script);
+        if (!address)
+            return;
+
+        for (const auto& account: account_transactions.accounts(
+            get_short_hash(address.encoded())))
+            result.insert(account);
+    };
+
+    if (!tx.is_coinbase())
+        for (const auto& input: tx.inputs)
+            add(input.script);
+
+    for (const auto& output: tx.outputs)
+        add(output.script);
+
+    return result;
+}
+
+void data_base::push_account_transactions(const chain::transaction& tx,
+    const hash_digest& tx_hash, size_t height)
+{
+    // Business records of addresses are kept from the same height.
+    if (height < history_height_)
+        return;
+
+    const account_transaction row{ static_cast<uint32_t>(height), tx_hash,
+        timestamp_ };
+
+    // An account not yet indexed finds the transaction when it is built.
+    for (const auto& account: transaction_accounts(tx))
+        if (!account_transactions.empty(account))
+            account_transactions.store(account, row);
+}
+
+void data_base::pop_account_transactions(const chain::transaction& tx,
+    size_t height)
+{
+    if (height < history_height_)
+        return;
+
+    const auto tx_hash = tx.hash();
+    for (const auto& account: transaction_accounts(tx))
+        account_transactions.remove(account, tx_hash);
+}
+
+void data_base::link_account_address(const std::string& name,
+    const std::string& address)
+{
+    const auto account = get_short_hash(name);
+    if (!account_transactions.link(get_short_hash(address), account))
+        return;
+
+    if (account_transactions.empty(account))
+        return;
+
+    const auto records = address_assets.get(address, 0, 0);
+    if (records->empty())
+        return;
+
+    // A used address joins an indexed account, merge its history in.
+    auto rows = account_transactions.get(account);
+    std::set<hash_digest> hashes;
+    for (const auto& row: rows)
+        hashes.insert(row.hash);
+
+    append_records(rows, hashes, *records);
+    sort_by_height(rows);
+    account_transactions.replace(account, rows);
+}
+
+void data_base::unlink_account_addresses(const std::string& name,
+    const std::vector<std::string>& addresses)
+{
+    const auto account = get_short_hash(name);
+    for (const auto& address: addresses)
+        account_transactions.unlink(get_short_hash(address), account);
+
+    account_transactions.reset(account);
+}
+
+void data_base::build_account_transactions(const std::string& name,
+    const std::vector<std::string>& addresses)
+{
+    const auto account = get_short_hash(name);
+    if (!account_transactions.empty(account))
+        return;
+
+    account_transaction::list rows;
+    std::set<hash_digest> hashes;
+    for (const auto& address: addresses)
+    {
+        account_transactions.link(get_short_hash(address), account);
+        append_records(rows, hashes, *address_assets.get(address, 0, 0));
+    }
+
+    sort_by_height(rows);
+    account_transactions.replace(account, rows);
+}
+
+/* end account transaction index */
+
 /* begin store asset related info into database */
 
 #include <metaverse/bitcoin/config/base16.hpp>
@@ -0,0 +1,380 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/databases/account_transaction_database.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/memory/memory.hpp>
+#include <metaverse/database/primitives/record_multimap_iterable.hpp>
+#include <metaverse/database/primitives/record_multimap_iterator.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace boost::filesystem;
+
+BC_CONSTEXPR size_t number_buckets = 9997;
+BC_CONSTEXPR size_t header_size = record_hash_table_header_size(number_buckets);
+BC_CONSTEXPR size_t initial_lookup_file_size = header_size + minimum_records_size;
+
+BC_CONSTEXPR size_t address_number_buckets = 99991;
+BC_CONSTEXPR size_t address_header_size = record_hash_table_header_size(address_number_buckets);
+BC_CONSTEXPR size_t initial_address_lookup_file_size = address_header_size + minimum_records_size;
+
+BC_CONSTEXPR size_t record_size = hash_table_multimap_record_size<short_hash>();
+
+BC_CONSTEXPR size_t value_size = 4 + 32 + 4; // height, hash, timestamp
+BC_CONSTEXPR size_t row_record_size = hash_table_record_size<hash_digest>(value_size);
+
+BC_CONSTEXPR size_t address_value_size = short_hash_size; // account hash
+BC_CONSTEXPR size_t address_row_record_size = hash_table_record_size<hash_digest>(address_value_size);
+
+account_transaction_database::account_transaction_database(
+    const path& lookup_filename, const path& rows_filename,
+    const path& addresses_lookup_filename, const path& addresses_rows_filename,
+    std::shared_ptr<shared_mutex> mutex)
+  : lookup_file_(lookup_filename, mutex),
+    lookup_header_(lookup_file_, number_buckets),
+    lookup_manager_(lookup_file_, header_size, record_size),
+    lookup_map_(lookup_header_, lookup_manager_),
+    rows_file_(rows_filename, mutex),
+    rows_manager_(rows_file_, 0, row_record_size),
+    rows_list_(rows_manager_),
+    rows_multimap_(lookup_map_, rows_list_),
+    addresses_lookup_file_(addresses_lookup_filename, mutex),
+    addresses_lookup_header_(addresses_lookup_file_, address_number_buckets),
+    addresses_lookup_manager_(addresses_lookup_file_, address_header_size, record_size),
+    addresses_lookup_map_(addresses_lookup_header_, addresses_lookup_manager_),
+    addresses_rows_file_(addresses_rows_filename, mutex),
+    addresses_rows_manager_(addresses_rows_file_, 0, address_row_record_size),
+    addresses_rows_list_(addresses_rows_manager_),
+    addresses_rows_multimap_(addresses_lookup_map_, addresses_rows_list_)
+{
+}
+
+// Close does not call stop because there is no way to detect thread join.
+account_transaction_database::~account_transaction_database()
+{
+    close();
+}
+
+// Create.
+// ----------------------------------------------------------------------------
+
+// Initialize files and start.
+bool account_transaction_database::create()
+{
+    // Resize and create require a started file.
+    if (!lookup_file_.start() ||
+        !rows_file_.start() ||
+        !addresses_lookup_file_.start() ||
+        !addresses_rows_file_.start())
+        return false;
+
+    // These will throw if insufficient disk space.
+    lookup_file_.resize(initial_lookup_file_size);
+    rows_file_.resize(minimum_records_size);
+    addresses_lookup_file_.resize(initial_address_lookup_file_size);
+    addresses_rows_file_.resize(minimum_records_size);
+
+    if (!lookup_header_.create() ||
+        !lookup_manager_.create() ||
+        !rows_manager_.create() ||
+        !addresses_lookup_header_.create() ||
+        !addresses_lookup_manager_.create() ||
+        !addresses_rows_manager_.create())
+        return false;
+
+    // Should not call start after create, already started.
+    return
+        lookup_header_.start() &&
+        lookup_manager_.start() &&
+        rows_manager_.start() &&
+        addresses_lookup_header_.start() &&
+        addresses_lookup_manager_.start() &&
+        addresses_rows_manager_.start();
+}
+
+// Startup and shutdown.
+// ----------------------------------------------------------------------------
+
+bool account_transaction_database::start()
+{
+    return
+        lookup_file_.start() &&
+        rows_file_.start() &&
+        addresses_lookup_file_.start() &&
+        addresses_rows_file_.start() &&
+        lookup_header_.start() &&
+        lookup_manager_.start() &&
+        rows_manager_.start() &&
+        addresses_lookup_header_.start() &&
+        addresses_lookup_manager_.start() &&
+        addresses_rows_manager_.start();
+}
+
+bool account_transaction_database::stop()
+{
+    return
+        lookup_file_.stop() &&
+        rows_file_.stop() &&
+        addresses_lookup_file_.stop() &&
+        addresses_rows_file_.stop();
+}
+
+bool account_transaction_database::close()
+{
+    return
+        lookup_file_.close() &&
+        rows_file_.close() &&
+        addresses_lookup_file_.close() &&
+        addresses_rows_file_.close();
+}
+
+// Address attribution.
+// ----------------------------------------------------------------------------
+
+bool account_transaction_database::link(const short_hash& address,
+    const short_hash& account)
+{
+    const auto linked = accounts(address);
+    if (std::find(linked.begin(), linked.end(), account) != linked.end())
+        return false;
+
+    const auto write = [&account](memory_ptr data)
+    {
+        auto serial = make_serializer(REMAP_ADDRESS(data));
+        serial.write_short_hash(account);
+    };
+    addresses_rows_multimap_.add_row(address, write);
+    return true;
+}
+
+void account_transaction_database::unlink(const short_hash& address,
+    const short_hash& account)
+{
+    auto linked = accounts(address);
+    const auto it = std::find(linked.begin(), linked.end(), account);
+    if (it == linked.end())
+        return;
+
+    // Rows can only be deleted from the last added, the others are restored.
+    for (size_t index = 0; index < linked.size(); ++index)
+        addresses_rows_multimap_.delete_last_row(address);
+
+    linked.erase(it);
+    for (auto each = linked.rbegin(); each != linked.rend(); ++each)
+    {
+        const auto& other = *each;
+        const auto write = [&other](memory_ptr data)
+        {
+            auto serial = make_serializer(REMAP_ADDRESS(data));
+            serial.write_short_hash(other);
+        };
+        addresses_rows_multimap_.add_row(address, write);
+    }
+}
+
+std::vector<short_hash> account_transaction_database::accounts(
+    const short_hash& address) const
+{
+    std::vector<short_hash> result;
+    const auto start = addresses_rows_multimap_.lookup(address);
+    const auto records = record_multimap_iterable(addresses_rows_list_, start);
+
+    for (const auto index: records)
+    {
+        // This obtains a remap safe address pointer against the rows file.
+        const auto record = addresses_rows_list_.get(index);
+        auto deserial = make_deserializer_unsafe(REMAP_ADDRESS(record));
+        result.push_back(deserial.read_short_hash());
+    }
+
+    return result;
+}
+
+// Account transactions.
+// ----------------------------------------------------------------------------
+
+bool account_transaction_database::empty(const short_hash& account) const
+{
+    return rows_multimap_.lookup(account) == rows_list_.empty;
+}
+
+void account_transaction_database::store(const short_hash& account,
+    const account_transaction& row)
+{
+    const auto write = [&row](memory_ptr data)
+    {
+        auto serial = make_serializer(REMAP_ADDRESS(data));
+        serial.write_4_bytes_little_endian(row.height); // 4
+        serial.write_hash(row.hash); // 32
+        serial.write_4_bytes_little_endian(row.timestamp); // 4
+    };
+    rows_multimap_.add_row(account, write);
+}
+
+// The marker is the first row, so it stays below the transactions.
+void account_transaction_database::replace(const short_hash& account,
+    const account_transaction::list& rows)
+{
+    reset(account);
+    store(account, { 0, null_hash, 0 });
+
+    for (const auto& row: rows)
+        store(account, row);
+}
+
+void account_transaction_database::reset(const short_hash& account)
+{
+    while (!empty(account))
+        rows_multimap_.delete_last_row(account);
+}
+
+void account_transaction_database::remove(const short_hash& account,
+    const hash_digest& hash)
+{
+    const auto start = rows_multimap_.lookup(account);
+    if (start == rows_list_.empty)
+        return;
+
+    // The transaction is normally the last one added, as blocks pop in reverse.
+    hash_digest last;
+    {
+        // The remap pointer is freed before rows are written, which may remap.
+        const auto record = rows_list_.get(start);
+        auto deserial = make_deserializer_unsafe(REMAP_ADDRESS(record));
+        deserial.read_4_bytes_little_endian();
+        last = deserial.read_hash();
+    }
+
+    if (last == hash)
+    {
+        rows_multimap_.delete_last_row(account);
+        return;
+    }
+
+    // Rows of one block built from history may be in another order.
+    auto rows = get(account);
+    const auto it = std::find_if(rows.begin(), rows.end(),
+        [&hash](const account_transaction& row) { return row.hash == hash; });
+    if (it == rows.end())
+        return;
+
+    rows.erase(it);
+    replace(account, rows);
+}
+
+account_transaction::list account_transaction_database::get(
+    const short_hash& account) const
+{
+    uint64_t total;
+    auto result = get(account, 0, 0, 0, 0, total);
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+account_transaction::list account_transaction_database::get(
+    const short_hash& account, uint64_t start_height, uint64_t end_height,
+    uint64_t offset, uint64_t limit, uint64_t& total) const
+{
+    // Read the height value from the row.
+    const auto read_height = [](uint8_t* data)
+    {
+        return from_little_endian_unsafe<uint32_t>(data);
+    };
+
+    // The marker of an indexed account holds no transaction.
+    const auto is_marker = [](uint8_t* data)
+    {
+        return std::equal(null_hash.begin(), null_hash.end(), data + 4);
+    };
+
+    // Read a row from the data for the transaction list.
+    const auto read_row = [](uint8_t* data)
+    {
+        auto deserial = make_deserializer_unsafe(data);
+        const auto height = deserial.read_4_bytes_little_endian();
+        const auto hash = deserial.read_hash();
+        const auto timestamp = deserial.read_4_bytes_little_endian();
+        return account_transaction{ height, hash, timestamp };
+    };
+
+    const auto all = (start_height == 0 && end_height == 0);
+    account_transaction::list result;
+    total = 0;
+
+    const auto start = rows_multimap_.lookup(account);
+    const auto records = record_multimap_iterable(rows_list_, start);
+
+    for (const auto index: records)
+    {
+        // This obtains a remap safe address pointer against the rows file.
+        const auto record = rows_list_.get(index);
+        const auto address = REMAP_ADDRESS(record);
+
+        if (is_marker(address))
+            continue;
+
+        // Rows are in descending height, the range ends at start_height.
+        if (!all)
+        {
+            const auto height = read_height(address);
+            if (height >= end_height)
+                continue;
+            if (height < start_height)
+                break;
+        }
+
+        if (total++ < offset)
+            continue;
+
+        if (limit == 0 || result.size() < limit)
+            result.push_back(read_row(address));
+    }
+
+    return result;
+}
+
+void account_transaction_database::sync()
+{
+    lookup_manager_.sync();
+    rows_manager_.sync();
+    addresses_lookup_manager_.sync();
+    addresses_rows_manager_.sync();
+}
+
+account_transaction_statinfo account_transaction_database::statinfo() const
+{
+    return
+    {
+        lookup_header_.size(),
+        lookup_manager_.count(),
+        rows_manager_.count()
+    };
+}
+
+} // namespace database
+} // namespace libbitcoin
@@ -130,23 +130,59 @@ console_result dispatch_command(int argc, const char* argv[],
     return command->invoke(out, err);
 }
 
-console_result dispatch_command(int argc, const char* argv[],
-    Json::Value& jv_output, 
+// Invoke a parsed command against the node.
+static console_result invoke_command(command& command, Json::Value& jv_output,
     libbitcoin::server::server_node& node, uint8_t api_version)
 {
-    std::istringstream input;
     std::ostringstream output;
+    command.set_api_version(api_version);
 
-    const std::string target(argv[0]);
+    if (command.category(ctgy_extension))
+    {
+
+        // fixme. is_blockchain_sync has some problem.
+        // if (command->category(ctgy_online) && node.is_blockchain_sync()) {
+        if (command.category(ctgy_online) &&
+            !node.chain_impl().chain_settings().use_testnet_rules) {
+       	    uint64_t height{0};
+            node.chain_impl().get_last_height(height);
+            if (!command.is_block_height_fullfilled(height))
+                throw block_sync_required_exception{"This command is unavailable because of the height < 610000."};
+        }                                                                       
+
+        return static_cast<commands::command_extension&>(command).invoke(jv_output, node);
+
+    }else{
+        command.set_api_version(1); // only compatible for v1
+        auto retcode = command.invoke(output, output);
+        jv_output = output.str();
+        return retcode;
+    }
+}
+
+static std::shared_ptr<command> find_command(const std::string& target)
+{
     const auto command = find(target);
 
     if (!command)
     {
+        std::ostringstream output;
         const std::string superseding(formerly(target));
         display_invalid_command(output, target, superseding);
         throw invalid_command_exception{ output.str() };
     }
 
+    return command;
+}
+
+console_result dispatch_command(int argc, const char* argv[],
+    Json::Value& jv_output, 
+    libbitcoin::server::server_node& node, uint8_t api_version)
+{
+    std::istringstream input;
+    std::ostringstream output;
+
+    const auto command = find_command(argv[0]);
     auto& in = get_command_input(*command, input);
 
     parser metadata(*command);
@@ -165,29 +201,36 @@ console_result dispatch_command(int argc, const char* argv[],
         return console_result::okay;
     }
 
-    command->set_api_version(api_version);
+    return invoke_command(*command, jv_output, node, api_version);
+}
 
-    if (command->category(ctgy_extension))
-    {
+console_result dispatch_command(const std::string& symbol,
+    const Json::Value& params, Json::Value& jv_output,
+    libbitcoin::server::server_node& node, uint8_t api_version)
+{
+    std::istringstream input;
+    std::ostringstream output;
 
-        // fixme. is_blockchain_sync has some problem.
-        // if (command->category(ctgy_online) && node.is_blockchain_sync()) {
-        if (command->category(ctgy_online) &&
-            !node.chain_impl().chain_settings().use_testnet_rules) {
-       	    uint64_t height{0};
-            node.chain_impl().get_last_height(height);
-            if (!command->is_block_height_fullfilled(height))
-                throw block_sync_required_exception{"This command is unavailable because of the height < 610000."};
-        }                                                                       
+    const auto command = find_command(symbol);
+    auto& in = get_command_input(*command, input);
 
-        return static_cast<commands::command_extension*>(command.get())->invoke(jv_output, node);
+    parser metadata(*command);
+    std::string error_message;
 
-    }else{
-        command->set_api_version(1); // only compatible for v1
-        auto retcode = command->invoke(output, output);
+    if (!metadata.parse(error_message, in, params))
+    {
+        display_invalid_parameter(output, error_message);
+        throw command_params_exception{ output.str() };
+    }
+
+    if (metadata.help())
+    {
+        command->write_help(output);
         jv_output = output.str();
-        return retcode;
+        return console_result::okay;
     }
+
+    return invoke_command(*command, jv_output, node, api_version);
 }
 
 
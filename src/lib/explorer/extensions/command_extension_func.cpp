@@ -19,10 +19,12 @@
  */
 
 
+#include <algorithm>
+#include <cstring>
 #include <functional>
-#include <memory>    
-#include <string>    
-#include <array>     
+#include <memory>
+#include <string>
+#include <vector>
 
 #include <metaverse/explorer/command.hpp>                
 #include <metaverse/explorer/dispatch.hpp>
@@ -91,201 +93,156 @@ namespace libbitcoin {
 namespace explorer {
 
 
-void broadcast_extension(const function<void(shared_ptr<command>)> func)
+using namespace std;
+using namespace commands;
+
+typedef shared_ptr<command> (*command_factory)(const string& symbol);
+
+template <typename Command>
+shared_ptr<command> make_command(const string&)
 {
-    using namespace std;
-    using namespace commands;
+    return make_shared<Command>();
+}
 
-    // account
-    func(make_shared<getnewaccount>());
-    func(make_shared<getnewaddress>());
-    func(make_shared<getaccount>());
-    func(make_shared<deleteaccount>());
-    func(make_shared<listaddresses>());
-    func(make_shared<dumpkeyfile>());
-    func(make_shared<importkeyfile>());
-    func(make_shared<importaccount>());
-    func(make_shared<changepasswd>());
+// The command behaves differently when invoked by this alias.
+template <typename Command>
+shared_ptr<command> make_renamed(const string& symbol)
+{
+    return make_shared<Command>(symbol);
+}
 
-    // wallet
-    func(make_shared<getheight>());
-    func(make_shared<getblock>());
-    func(make_shared<getblockheader>());
-    func(make_shared<fetchheaderext>());
-    func(make_shared<shutdown>());
-    func(make_shared<startmining>());
-    func(make_shared<stopmining>());
-    func(make_shared<setminingaccount>());
-    func(make_shared<getmininginfo>());
-    func(make_shared<getinfo>());
-    func(make_shared<getpeerinfo>());
-    func(make_shared<getaddressetp>());
-    func(make_shared<addnode>());
-    func(make_shared<gettx>());
-    func(make_shared<getwork>());
-    func(make_shared<submitwork>());
-    func(make_shared<getmemorypool>());
+struct registration
+{
+    const char* symbol;
+    command_factory factory;
+    bool alias;
+};
 
-    // etp
-    func(make_shared<validateaddress>());
-    func(make_shared<listbalances>());
-    func(make_shared<getbalance>());
-    func(make_shared<listtxs>());
-    func(make_shared<deposit>());
-    func(make_shared<send>());
-    func(make_shared<sendmore>());
-    func(make_shared<sendfrom>());
+// Every extension command and alias, in display order.
+static const vector<registration>& definitions()
+{
+    static const vector<registration> table
+    {
+        // account
+        { getnewaccount::symbol(), make_command<getnewaccount>, false },
+        { getnewaddress::symbol(), make_command<getnewaddress>, false },
+        { getaccount::symbol(), make_command<getaccount>, false },
+        { deleteaccount::symbol(), make_command<deleteaccount>, false },
+        { listaddresses::symbol(), make_command<listaddresses>, false },
+        { dumpkeyfile::symbol(), make_command<dumpkeyfile>, false },
+        { "exportaccountasfile", make_command<dumpkeyfile>, true },
+        { importkeyfile::symbol(), make_command<importkeyfile>, false },
+        { "importaccountfromfile", make_command<importkeyfile>, true },
+        { importaccount::symbol(), make_command<importaccount>, false },
+        { changepasswd::symbol(), make_command<changepasswd>, false },
+
+        // wallet
+        { getheight::symbol(), make_command<getheight>, false },
+        { "fetch-height", make_renamed<getheight>, true },
+        { getblock::symbol(), make_command<getblock>, false },
+        { getblockheader::symbol(), make_command<getblockheader>, false },
+        { "fetch-header", make_command<getblockheader>, true },
+        { "getbestblockheader", make_command<getblockheader>, true },
+        { "getbestblockhash", make_renamed<getblockheader>, true },
+        { fetchheaderext::symbol(), make_command<fetchheaderext>, false },
+        { shutdown::symbol(), make_command<shutdown>, false },
+        { startmining::symbol(), make_command<startmining>, false },
+        { "start", make_command<startmining>, true },
+        { stopmining::symbol(), make_command<stopmining>, false },
+        { "stop", make_command<stopmining>, true },
+        { setminingaccount::symbol(), make_command<setminingaccount>, false },
+        { getmininginfo::symbol(), make_command<getmininginfo>, false },
+        { getinfo::symbol(), make_command<getinfo>, false },
+        { getpeerinfo::symbol(), make_command<getpeerinfo>, false },
+        { getaddressetp::symbol(), make_command<getaddressetp>, false },
+        { "fetch-balance", make_command<getaddressetp>, true },
+        { addnode::symbol(), make_command<addnode>, false },
+        { gettx::symbol(), make_command<gettx>, false },
+        { "gettransaction", make_command<gettx>, true },
+        { "fetch-tx", make_renamed<gettx>, true },
+        { getwork::symbol(), make_command<getwork>, false },
+        { submitwork::symbol(), make_command<submitwork>, false },
+        { getmemorypool::symbol(), make_command<getmemorypool>, false },
+
+        // etp
+        { validateaddress::symbol(), make_command<validateaddress>, false },
+        { listbalances::symbol(), make_command<listbalances>, false },
+        { getbalance::symbol(), make_command<getbalance>, false },
+        { listtxs::symbol(), make_command<listtxs>, false },
+        { deposit::symbol(), make_command<deposit>, false },
+        { send::symbol(), make_command<send>, false },
+        { sendmore::symbol(), make_command<sendmore>, false },
+        { sendfrom::symbol(), make_command<sendfrom>, false },
+
+        // asset
+        { listassets::symbol(), make_command<listassets>, false },
+        { getasset::symbol(), make_command<getasset>, false },
+        { getaddressasset::symbol(), make_command<getaddressasset>, false },
+        { getaccountasset::symbol(), make_command<getaccountasset>, false },
+        { createasset::symbol(), make_command<createasset>, false },
+        { deletelocalasset::symbol(), make_command<deletelocalasset>, false },
+        { "deleteasset", make_command<deletelocalasset>, true },
+        { issue::symbol(), make_command<issue>, false },
+        { issuefrom::symbol(), make_command<issuefrom>, false },
+        { sendasset::symbol(), make_command<sendasset>, false },
+        { sendassetfrom::symbol(), make_command<sendassetfrom>, false },
+
+        // multi-sig
+        { getpublickey::symbol(), make_command<getpublickey>, false },
+        { createmultisigtx::symbol(), make_command<createmultisigtx>, false },
+        { getnewmultisig::symbol(), make_command<getnewmultisig>, false },
+        { listmultisig::symbol(), make_command<listmultisig>, false },
+        { deletemultisig::symbol(), make_command<deletemultisig>, false },
+        { signmultisigtx::symbol(), make_command<signmultisigtx>, false },
+
+        // raw
+        { createrawtx::symbol(), make_command<createrawtx>, false },
+        { decoderawtx::symbol(), make_command<decoderawtx>, false },
+        { signrawtx::symbol(), make_command<signrawtx>, false },
+        { sendrawtx::symbol(), make_command<sendrawtx>, false },
+    };
+
+    return table;
+}
 
-    // asset
-    func(make_shared<listassets>());
-    func(make_shared<getasset>());
-    func(make_shared<getaddressasset>());
-    func(make_shared<getaccountasset>());
-    func(make_shared<createasset>());
-    func(make_shared<deletelocalasset>());
-    func(make_shared<issue>());
-    func(make_shared<issuefrom>());
-    func(make_shared<sendasset>());
-    func(make_shared<sendassetfrom>());
+static bool symbol_less(const registration* left, const registration* right)
+{
+    return strcmp(left->symbol, right->symbol) < 0;
+}
+
+// The definitions sorted by symbol, built once and searched by bisection.
+static const vector<const registration*>& registry()
+{
+    static const auto sorted = []()
+    {
+        vector<const registration*> table;
+        for (const auto& entry: definitions())
+            table.push_back(&entry);
 
-    // multi-sig
-    func(make_shared<getpublickey>());
-    func(make_shared<createmultisigtx>());
-    func(make_shared<getnewmultisig>());
-    func(make_shared<listmultisig>());
-    func(make_shared<deletemultisig>());
-    func(make_shared<signmultisigtx>());
+        sort(table.begin(), table.end(), symbol_less);
+        return table;
+    }();
 
-    // raw
-    func(make_shared<createrawtx>());
-    func(make_shared<decoderawtx>());
-    func(make_shared<signrawtx>());
-    func(make_shared<sendrawtx>());
+    return sorted;
+}
+
+void broadcast_extension(const function<void(shared_ptr<command>)> func)
+{
+    for (const auto& entry: definitions())
+        if (!entry.alias)
+            func(entry.factory(entry.symbol));
 }
 
 shared_ptr<command> find_extension(const string& symbol)
 {
-    using namespace std;
-    using namespace commands;
-    if (symbol == stopmining::symbol() || symbol == "stop")
-        return make_shared<stopmining>();
-    if (symbol == startmining::symbol() || symbol == "start")
-        return make_shared<startmining>();
-    if (symbol == getinfo::symbol())
-        return make_shared<getinfo>();
-    if (symbol == getheight::symbol())
-        return make_shared<getheight>();
-    if (symbol == "fetch-height")
-        return make_shared<getheight>(symbol);
-    if (symbol == getpeerinfo::symbol())
-        return make_shared<getpeerinfo>();
-    if (symbol == getaddressetp::symbol() || symbol == "fetch-balance")
-        return make_shared<getaddressetp>();
-    if (symbol == addnode::symbol())
-        return make_shared<addnode>();
-    if (symbol == getmininginfo::symbol())
-        return make_shared<getmininginfo>();
-    if (symbol == gettx::symbol() || symbol == "gettransaction")
-        return make_shared<gettx>();
-    if (symbol == "fetch-tx")
-        return make_shared<gettx>(symbol);
-    if (symbol == dumpkeyfile::symbol() || symbol == "exportaccountasfile")
-        return make_shared<dumpkeyfile>();
-    if (symbol == importkeyfile::symbol() || symbol == "importaccountfromfile")
-        return make_shared<importkeyfile>();
-    if (symbol == importaccount::symbol())
-        return make_shared<importaccount>();
-    if (symbol == getnewaccount::symbol())
-        return make_shared<getnewaccount>();
-    if (symbol == getaccount::symbol())
-        return make_shared<getaccount>();
-    if (symbol == deleteaccount::symbol())
-        return make_shared<deleteaccount>();
-    if (symbol == listaddresses::symbol())
-        return make_shared<listaddresses>();
-    if (symbol == getnewaddress::symbol())
-        return make_shared<getnewaddress>();
-    if (symbol == getpublickey::symbol())
-        return make_shared<getpublickey>();
-    if (symbol == getblock::symbol())
-        return make_shared<getblock>();
-    if (symbol == validateaddress::symbol())
-        return make_shared<validateaddress>();
-    if (symbol == listbalances::symbol())
-        return make_shared<listbalances>();
-    if (symbol == getbalance::symbol())
-        return make_shared<getbalance>();
-    if (symbol == "getbestblockhash")
-        return make_shared<getblockheader>(symbol);
-    if (symbol == getblockheader::symbol() || symbol == "fetch-header" || symbol == "getbestblockheader")
-        return make_shared<getblockheader>();
-    if (symbol == fetchheaderext::symbol())
-        return make_shared<fetchheaderext>();
-    if (symbol == listtxs::symbol())
-        return make_shared<listtxs>();
-    if (symbol == deposit::symbol())
-        return make_shared<deposit>();
-    if (symbol == send::symbol())
-        return make_shared<send>();
-    if (symbol == sendmore::symbol())
-        return make_shared<sendmore>();
-    if (symbol == sendfrom::symbol())
-        return make_shared<sendfrom>();
-    if (symbol == listassets::symbol())
-        return make_shared<listassets>();
-    if (symbol == getasset::symbol())
-        return make_shared<getasset>();
-    if (symbol == getaccountasset::symbol())
-        return make_shared<getaccountasset>();
-    if (symbol == createasset::symbol())
-        return make_shared<createasset>();
-    if (symbol == deletelocalasset::symbol() || symbol == "deleteasset" )
-        return make_shared<deletelocalasset>();
-    if (symbol == issue::symbol())
-        return make_shared<issue>();
-    if (symbol == issuefrom::symbol())
-        return make_shared<issuefrom>();
-    if (symbol == sendasset::symbol())
-        return make_shared<sendasset>();
-    if (symbol == sendassetfrom::symbol())
-        return make_shared<sendassetfrom>();
-    if (symbol == getwork::symbol())
-        return make_shared<getwork>();
-    if (symbol == submitwork::symbol())
-        return make_shared<submitwork>();
-    if (symbol == setminingaccount::symbol())
-        return make_shared<setminingaccount>();
-    if (symbol == changepasswd::symbol())
-        return make_shared<changepasswd>();
-    if (symbol == getnewmultisig::symbol())
-        return make_shared<getnewmultisig>();
-    if (symbol == listmultisig::symbol())
-        return make_shared<listmultisig>();
-    if (symbol == deletemultisig::symbol())
-        return make_shared<deletemultisig>();
-    if (symbol == createmultisigtx::symbol())
-        return make_shared<createmultisigtx>();
-    if (symbol == signmultisigtx::symbol())
-        return make_shared<signmultisigtx>();
-    if (symbol == createrawtx::symbol())
-        return make_shared<createrawtx>();
-    if (symbol == decoderawtx::symbol())
-        return make_shared<decoderawtx>();
-    if (symbol == signrawtx::symbol())
-        return make_shared<signrawtx>();
-    if (symbol == sendrawtx::symbol())
-        return make_shared<sendrawtx>();
-    if (symbol == issuefrom::symbol())
-        return make_shared<issuefrom>();
-    if (symbol == sendassetfrom::symbol())
-        return make_shared<sendassetfrom>();
-    if (symbol == shutdown::symbol())
-        return make_shared<shutdown>();
-    if (symbol == getmemorypool::symbol())
-        return make_shared<getmemorypool>();
-    if (symbol == getaddressasset::symbol())
-        return make_shared<getaddressasset>();
-    return nullptr;
+    const auto& table = registry();
+    const registration key{ symbol.c_str(), nullptr, false };
+    const auto it = lower_bound(table.begin(), table.end(), &key, symbol_less);
+
+    if (it == table.end() || symbol != (*it)->symbol)
+        return nullptr;
+
+    return (*it)->factory(symbol);
 }
 
 std::string formerly_extension(const string& former)
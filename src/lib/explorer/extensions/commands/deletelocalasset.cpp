@@ -43,16 +43,7 @@ console_result deletelocalasset::invoke (Json::Value& jv_output,
     if(blockchain.get_issued_asset(option_.symbol))
         throw asset_issued_not_delete{"Cannot delete asset " + option_.symbol + " which has been issued."};
 
-    std::promise<code> p;
-    std::vector<libbitcoin::blockchain::transaction_pool::transaction_ptr> txs;
-    blockchain.pool().fetch([&txs, &p](const code& ec, const std::vector<libbitcoin::blockchain::transaction_pool::transaction_ptr>& tx){
-        if (!ec)
-        {
-            txs = tx;
-        }
-        p.set_value(ec);
-    });
-    p.get_future().get();
+    const auto txs = blockchain.pool().snapshot();
 
     for(auto& tx : txs)
     {
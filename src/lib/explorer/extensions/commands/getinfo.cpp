@@ -59,6 +59,81 @@ console_result getinfo::invoke (Json::Value& jv_output,
     jv["is-mining"] = is_solo_mining; 
     jv["hash-rate"] = rate; 
 
+    // Initial block download throughput, while block sync is running.
+    Json::Value sync;
+    node::reservations::sync_statistics statistics;
+    sync["synchronizing"] = node.sync_statistics(statistics);
+    if (sync["synchronizing"].asBool())
+    {
+        sync["active-slots"] = static_cast<uint64_t>(statistics.active_count);
+        sync["imported"] = static_cast<uint64_t>(statistics.imported);
+        sync["in-flight"] = static_cast<uint64_t>(statistics.in_flight);
+        sync["remaining"] = static_cast<uint64_t>(statistics.remaining);
+        sync["blocks-per-second"] = statistics.blocks_per_second;
+        sync["average-blocks-per-second"] =
+            statistics.average_blocks_per_second;
+        sync["database-ratio"] = statistics.database_ratio;
+    }
+    jv["sync"] = sync;
+
+    // Block store pipeline occupancy and commit throughput.
+    Json::Value import;
+    const auto stats = blockchain.import_stats();
+    import["checking"] = static_cast<uint64_t>(stats.checking);
+    import["checking-peak"] = static_cast<uint64_t>(stats.checking_peak);
+    import["queued"] = static_cast<uint64_t>(stats.queued);
+    import["queued-peak"] = static_cast<uint64_t>(stats.queued_peak);
+    import["batches"] = stats.batches;
+    import["committed"] = stats.committed;
+    import["queue-waits"] = stats.queue_waits;
+    import["imported"] = stats.imported;
+    import["rejected"] = stats.import_rejected;
+    jv["import"] = import;
+
+    // Rpc execution pool occupancy.
+    Json::Value rpc;
+    const auto rpc_stats = node.rpc_statistics();
+    rpc["threads"] = static_cast<uint64_t>(rpc_stats.threads);
+    rpc["queued"] = static_cast<uint64_t>(rpc_stats.queued);
+    rpc["queued-peak"] = static_cast<uint64_t>(rpc_stats.queued_peak);
+    rpc["running"] = static_cast<uint64_t>(rpc_stats.running);
+    rpc["completed"] = rpc_stats.completed;
+    rpc["rejected"] = rpc_stats.rejected;
+    rpc["timed-out"] = rpc_stats.timed_out;
+    rpc["undelivered"] = rpc_stats.undelivered;
+
+    // Rpc result cache, empty unless server.rpc_cache_entries is set.
+    Json::Value cache;
+    const auto cache_stats = node.rpc_cache_statistics();
+    const auto lookups = cache_stats.hits + cache_stats.misses;
+    cache["entries"] = static_cast<uint64_t>(cache_stats.entries);
+    cache["bytes"] = static_cast<uint64_t>(cache_stats.bytes);
+    cache["hits"] = cache_stats.hits;
+    cache["misses"] = cache_stats.misses;
+    cache["evictions"] = cache_stats.evictions;
+    cache["invalidations"] = cache_stats.invalidations;
+    cache["hit-rate"] = lookups == 0 ? 0.0 : double(cache_stats.hits) / lookups;
+    rpc["cache"] = cache;
+    jv["rpc"] = rpc;
+
+    // Zmq query latency of each queried method, in microseconds.
+    Json::Value query(Json::arrayValue);
+    for (const auto& method : node.query_latency().snapshot())
+    {
+        if (method.count == 0)
+            continue;
+
+        Json::Value item;
+        item["method"] = method.name;
+        item["pool"] = method.heavy ? "history" : "worker";
+        item["count"] = method.count;
+        item["mean"] = method.mean_microseconds;
+        item["p50"] = method.p50_microseconds;
+        item["p99"] = method.p99_microseconds;
+        item["max"] = method.max_microseconds;
+        query.append(item);
+    }
+    jv["query"] = query;
 
     return console_result::okay;
 }
@@ -40,32 +40,19 @@ console_result getmemorypool::invoke (Json::Value& jv_output,
     administrator_required_checker(node, auth_.name, auth_.auth);
     auto json = option_.json;
 
-    using transaction_ptr = message::transaction_message::ptr ;
     auto& blockchain = node.chain_impl();
-    std::promise<code> p;
-    blockchain.pool().fetch([&jv_output, &p, &json, this](const code& ec, const std::vector<transaction_ptr>& txs){
-        if (ec)
-        {
-            p.set_value(ec);
-            return;
-        }
-        std::vector<config::transaction> txs1;
-        txs1.reserve(txs.size());
-        for (auto tp:txs) {
-            txs1.push_back(*tp);
-        }
+    const auto txs = blockchain.pool().snapshot();
 
-        if(json) {
-             jv_output =  config::json_helper(get_api_version()).prop_tree(txs1, true);
-        } else {
-             jv_output =  config::json_helper(get_api_version()).prop_tree(txs1, false);
-        }
-        p.set_value(ec);
-    });
+    std::vector<config::transaction> txs1;
+    txs1.reserve(txs.size());
+    for (auto tp:txs) {
+        txs1.push_back(*tp);
+    }
 
-    auto result = p.get_future().get();
-    if(result){
-        throw tx_fetch_exception{result.message()};
+    if(json) {
+         jv_output =  config::json_helper(get_api_version()).prop_tree(txs1, true);
+    } else {
+         jv_output =  config::json_helper(get_api_version()).prop_tree(txs1, false);
     }
     return console_result::okay;
 }
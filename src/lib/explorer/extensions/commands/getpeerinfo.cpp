@@ -49,6 +49,17 @@ console_result getpeerinfo::invoke (Json::Value& jv_output,
     }
     root["peers"] = array;
 
+    Json::Value outbound;
+    for(auto channel : node.connections_ptr()->channel_list()) {
+        Json::Value item;
+        item["address"] = channel->authority().to_string();
+        item["queued_bytes"] = static_cast<uint64_t>(channel->outbound_bytes());
+        item["flushes"] = channel->outbound_flushes();
+        item["bytes_sent"] = channel->outbound_bytes_sent();
+        outbound.append(item);
+    }
+    root["outbound"] = outbound;
+
     return console_result::okay;
 }
 
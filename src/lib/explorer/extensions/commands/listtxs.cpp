@@ -92,33 +92,6 @@ console_result listtxs::invoke (Json::Value& jv_output,
         return const_cast<tx_block_info&>(lhs).get_height() > const_cast<tx_block_info&>(rhs).get_height(); 
     };
     
-    auto sh_txs = std::make_shared<std::vector<tx_block_info>>();
-    auto sh_addr_vec = std::make_shared<std::vector<std::string>>();
-
-    // collect address
-    if(argument_.address.empty()) { 
-        auto pvaddr = blockchain.get_account_addresses(auth_.name);
-        if(!pvaddr) 
-            throw address_invalid_exception{"nullptr for address list"};
-        
-        for (auto& elem: *pvaddr) {
-            sh_addr_vec->push_back(elem.get_address());
-        }
-    } else { // address exist in command
-        sh_addr_vec->push_back(argument_.address);
-    }
-
-    // scan all addresses business record
-    for (auto& each: *sh_addr_vec) {
-        auto sh_vec = blockchain.get_address_business_record(each, argument_.symbol,
-                option_.height.first(), option_.height.second(), 0, 0);
-        for(auto& elem : *sh_vec)
-            sh_txs->push_back(tx_block_info(elem.height, elem.data.get_timestamp(), elem.point.hash));
-    }
-    std::sort (sh_txs->begin(), sh_txs->end());
-    sh_txs->erase(std::unique(sh_txs->begin(), sh_txs->end()), sh_txs->end());
-    std::sort (sh_txs->begin(), sh_txs->end(), sort_by_height);
-
     // page limit & page index paramenter check
     if(!argument_.index) 
         throw argument_legality_exception{"page index parameter must not be zero"};    
@@ -127,27 +100,56 @@ console_result listtxs::invoke (Json::Value& jv_output,
     if(argument_.limit > 100)
         throw argument_legality_exception{"page record limit must not be bigger than 100."};
 
-    uint64_t start, end, total_page, tx_count;
-    if(argument_.index && argument_.limit) {
-        start = (argument_.index - 1)*argument_.limit;
-        end = (argument_.index)*argument_.limit;
-        if(start >= sh_txs->size() || !sh_txs->size())
-            throw argument_legality_exception{"no record in this page"};
+    uint64_t start = (argument_.index - 1)*argument_.limit;
+    uint64_t end = (argument_.index)*argument_.limit;
+    uint64_t total_count = 0;
+    std::vector<tx_block_info> result;
 
-        total_page = sh_txs->size() % argument_.limit ? (sh_txs->size()/argument_.limit + 1) : (sh_txs->size()/argument_.limit);
-        tx_count = end >=sh_txs->size()? (sh_txs->size() - start) : argument_.limit ;
-        
-    } else if(!argument_.index && !argument_.limit) { // all tx records
-        start = 0;
-        tx_count = sh_txs->size();
-        argument_.index = 1;
-        total_page = 1;
+    if(argument_.address.empty() && argument_.symbol.empty()) {
+        // the account transaction index holds the page in height order
+        auto rows = blockchain.get_account_transactions(auth_.name,
+                option_.height.first(), option_.height.second(), start, argument_.limit, total_count);
+        for(auto& row : rows)
+            result.push_back(tx_block_info(row.height, row.timestamp, row.hash));
     } else {
-        throw argument_legality_exception{"invalid limit or index parameter"};
+        auto sh_txs = std::make_shared<std::vector<tx_block_info>>();
+        auto sh_addr_vec = std::make_shared<std::vector<std::string>>();
+
+        // collect address
+        if(argument_.address.empty()) { 
+            auto pvaddr = blockchain.get_account_addresses(auth_.name);
+            if(!pvaddr) 
+                throw address_invalid_exception{"nullptr for address list"};
+            
+            for (auto& elem: *pvaddr) {
+                sh_addr_vec->push_back(elem.get_address());
+            }
+        } else { // address exist in command
+            sh_addr_vec->push_back(argument_.address);
+        }
+
+        // scan all addresses business record
+        for (auto& each: *sh_addr_vec) {
+            auto sh_vec = blockchain.get_address_business_record(each, argument_.symbol,
+                    option_.height.first(), option_.height.second(), 0, 0);
+            for(auto& elem : *sh_vec)
+                sh_txs->push_back(tx_block_info(elem.height, elem.data.get_timestamp(), elem.point.hash));
+        }
+        std::sort (sh_txs->begin(), sh_txs->end());
+        sh_txs->erase(std::unique(sh_txs->begin(), sh_txs->end()), sh_txs->end());
+        std::sort (sh_txs->begin(), sh_txs->end(), sort_by_height);
+
+        // records of this page
+        total_count = sh_txs->size();
+        if(start < total_count)
+            result.assign(sh_txs->begin() + start, sh_txs->begin() + std::min(end, total_count));
     }
 
-    // sort by height
-    std::vector<tx_block_info> result(sh_txs->begin() + start, sh_txs->begin() + start + tx_count);
+    if(start >= total_count || !total_count)
+        throw argument_legality_exception{"no record in this page"};
+
+    uint64_t total_page = total_count % argument_.limit ? (total_count/argument_.limit + 1) : (total_count/argument_.limit);
+    uint64_t tx_count = end >= total_count ? (total_count - start) : argument_.limit;
 
     // fetch tx according its hash
     std::vector<std::string> vec_ip_addr; // input addr
@@ -52,50 +52,148 @@ std::ostream& operator<<(std::ostream& out, unsigned char c) {
     return out;
 }
 
+// The string form of a value, shared by the operators below. Streamed members
+// call it directly: the operator+ template cannot take an integer, and +value
+// on an integer or a multiprecision number yields the number, not its text.
 template <typename Value>
-Json::Value& operator+=(Json::Value& a, const Value& b)
+static std::string text(const Value& value)
 {
     std::ostringstream ss;
-    ss << b;
-    a = ss.str();
+    ss << value;
+    return ss.str();
+}
+
+template <typename Value>
+Json::Value& operator+=(Json::Value& a, const Value& b)
+{
+    a = text(b);
     return a;
 }
 
 template <typename Value>
 std::string operator+(const Value& value)
 {
-    std::ostringstream ss;
-    ss << value;
-    return ss.str();
+    return text(value);
 }
 
-Json::Value json_helper::prop_list(const header& header)
+// Fills a tree with the visited members.
+class tree_fields
 {
-    const chain::header& block_header = header;
+public:
+    tree_fields(Json::Value& tree, uint8_t version)
+      : tree_(tree), stringify_(version == 1)
+    {
+    }
 
-    Json::Value tree;
+    void member(const char* name, const std::string& value)
+    {
+        tree_[name] = value;
+    }
 
-    tree["hash"] += hash256(block_header.hash());
-    tree["merkle_tree_hash"] += hash256(block_header.merkle);
-    tree["previous_block_hash"] += hash256(block_header.previous_block_hash);
-    tree["bits"] += block_header.bits;
-    tree["mixhash"] += block_header.mixhash;
-    tree["nonce"] += block_header.nonce;
+    // A string for v1, a number otherwise.
+    template <typename Value>
+    void number(const char* name, Value value)
+    {
+        if (stringify_)
+            tree_[name] = text(value);
+        else
+            tree_[name] = value;
+    }
 
-    if (version_ == 1) {
-        tree["time_stamp"] += block_header.timestamp;
-        tree["version"] += block_header.version;
-        tree["number"] += block_header.number;
-        tree["transaction_count"] += block_header.transaction_count;
-    } else {
-        tree["time_stamp"] = block_header.timestamp;
-        tree["version"] = block_header.version;
-        tree["number"] = block_header.number;
-        tree["transaction_count"] = block_header.transaction_count;
+    template <typename Values, typename Render>
+    void list(const char* name, const Values& values, const Json::Value& empty,
+        Render render)
+    {
+        auto& list = tree_[name];
+        if (values.empty()) {
+            list = empty;
+            return;
+        }
+
+        for (const auto& value: values)
+            list.append(render(value));
+    }
+
+private:
+    Json::Value& tree_;
+    const bool stringify_;
+};
+
+// Writes the visited members to a stream, values of a list one at a time.
+class writer_fields
+{
+public:
+    writer_fields(json_writer& writer, uint8_t version)
+      : writer_(writer), stringify_(version == 1)
+    {
+    }
+
+    void member(const char* name, const std::string& value)
+    {
+        writer_.member(name, value);
     }
 
+    template <typename Value>
+    void number(const char* name, Value value)
+    {
+        if (stringify_)
+            writer_.member(name, text(value));
+        else
+            writer_.member(name, value);
+    }
+
+    template <typename Values, typename Render>
+    void list(const char* name, const Values& values, const Json::Value& empty,
+        Render render)
+    {
+        writer_.key(name);
+        if (values.empty()) {
+            writer_.value(empty);
+            return;
+        }
+
+        writer_.begin_array();
+        for (const auto& value: values)
+            writer_.value(render(value));
+        writer_.end_array();
+    }
+
+private:
+    json_writer& writer_;
+    const bool stringify_;
+};
+
+template <typename Fields>
+void json_helper::visit(Fields& fields, const chain::header& header)
+{
+    fields.member("bits", text(header.bits));
+    fields.member("hash", text(hash256(header.hash())));
+    fields.member("merkle_tree_hash", text(hash256(header.merkle)));
+    fields.member("mixhash", text(header.mixhash));
+    fields.member("nonce", text(header.nonce));
+    fields.number("number", header.number);
+    fields.member("previous_block_hash", text(hash256(header.previous_block_hash)));
+    fields.number("time_stamp", header.timestamp);
+    fields.number("transaction_count", header.transaction_count);
+    fields.number("version", header.version);
+}
+
+Json::Value json_helper::prop_list(const header& header)
+{
+    Json::Value tree;
+    tree_fields fields(tree, version_);
+    visit(fields, header);
     return tree;
 }
+
+void json_helper::prop_list(json_writer& writer, const header& header)
+{
+    writer_fields fields(writer, version_);
+    writer.begin_object();
+    visit(fields, header);
+    writer.end_object();
+}
+
 Json::Value json_helper::prop_tree(const header& header)
 {
     Json::Value tree;
@@ -471,24 +569,40 @@ Json::Value json_helper::prop_list(const transaction& transaction, bool json)
     }
     return tree;
 }
-Json::Value json_helper::prop_list(const transaction& transaction, uint64_t tx_height, bool json)
+// An empty list is null, or "" for v1 outputs.
+template <typename Fields>
+void json_helper::visit(Fields& fields, const tx_type& tx, uint64_t tx_height)
 {
-    const tx_type& tx = transaction;
+    uint32_t index = 0;
+    const auto no_outputs = version_ == 1 ? Json::Value("") : Json::Value();
+
+    fields.member("hash", text(hash256(tx.hash())));
+    fields.number("height", tx_height);
+    fields.list("inputs", tx.inputs, Json::Value(),
+        [this](const tx_input_type& input) { return prop_list(input); });
+    fields.member("lock_time", text(tx.locktime));
+    fields.list("outputs", tx.outputs, no_outputs,
+        [this, &index](const tx_output_type& output) { return prop_list(output, index++); });
+    fields.member("version", text(tx.version));
+}
 
+Json::Value json_helper::prop_list(const transaction& transaction, uint64_t tx_height, bool json)
+{
     Json::Value tree;
-    tree["hash"] += hash256(tx.hash());
-    if (version_ == 1) {
-        tree["height"] += tx_height;
-    } else {
-        tree["height"] = tx_height;
-    }
-    tree["inputs"] = prop_tree_list("input", tx.inputs, json);
-    tree["lock_time"] += tx.locktime;
-    tree["outputs"] = prop_tree(tx.outputs, json); // only used for output to add new field "index"
-    tree["version"] += tx.version;
+    tree_fields fields(tree, version_);
+    visit(fields, transaction, tx_height);
     return tree;
 }
 
+void json_helper::prop_list(json_writer& writer, const transaction& transaction,
+    uint64_t tx_height, bool json)
+{
+    writer_fields fields(writer, version_);
+    writer.begin_object();
+    visit(fields, transaction, tx_height);
+    writer.end_object();
+}
+
 Json::Value json_helper::prop_tree(const transaction& transaction, bool json)
 {
     Json::Value tree;
@@ -0,0 +1,268 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse-explorer.
+ *
+ * metaverse-explorer is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/explorer/json_writer.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+
+namespace libbitcoin {
+namespace explorer {
+namespace config {
+
+json_writer::json_writer(std::ostream& stream)
+  : stream_(stream), keyed_(false)
+{
+}
+
+// Emit the comma between values of an object or array.
+void json_writer::separate()
+{
+    if (keyed_)
+    {
+        keyed_ = false;
+        return;
+    }
+
+    if (written_.empty())
+        return;
+
+    if (written_.back())
+        stream_.put(',');
+
+    written_.back() = true;
+}
+
+json_writer& json_writer::begin_object()
+{
+    separate();
+    stream_.put('{');
+    written_.push_back(false);
+    return *this;
+}
+
+json_writer& json_writer::end_object()
+{
+    written_.pop_back();
+    stream_.put('}');
+    return *this;
+}
+
+json_writer& json_writer::begin_array()
+{
+    separate();
+    stream_.put('[');
+    written_.push_back(false);
+    return *this;
+}
+
+json_writer& json_writer::end_array()
+{
+    written_.pop_back();
+    stream_.put(']');
+    return *this;
+}
+
+json_writer& json_writer::key(const std::string& name)
+{
+    separate();
+    write_string(name.data(), name.size());
+    stream_.put(':');
+    keyed_ = true;
+    return *this;
+}
+
+json_writer& json_writer::null()
+{
+    separate();
+    stream_.write("null", 4);
+    return *this;
+}
+
+json_writer& json_writer::raw(const std::string& json)
+{
+    separate();
+    stream_.write(json.data(), json.size());
+    return *this;
+}
+
+json_writer& json_writer::value(bool value)
+{
+    separate();
+    if (value)
+        stream_.write("true", 4);
+    else
+        stream_.write("false", 5);
+    return *this;
+}
+
+json_writer& json_writer::value(int32_t value)
+{
+    return this->value(static_cast<int64_t>(value));
+}
+
+json_writer& json_writer::value(uint32_t value)
+{
+    return this->value(static_cast<uint64_t>(value));
+}
+
+json_writer& json_writer::value(int64_t value)
+{
+    separate();
+    char buffer[24];
+    const auto size = std::snprintf(buffer, sizeof(buffer), "%lld",
+        static_cast<long long>(value));
+    stream_.write(buffer, size);
+    return *this;
+}
+
+json_writer& json_writer::value(uint64_t value)
+{
+    separate();
+    char buffer[24];
+    const auto size = std::snprintf(buffer, sizeof(buffer), "%llu",
+        static_cast<unsigned long long>(value));
+    stream_.write(buffer, size);
+    return *this;
+}
+
+json_writer& json_writer::value(double value)
+{
+    // Json has no representation for these.
+    if (!std::isfinite(value))
+        return null();
+
+    separate();
+    char buffer[32];
+    const auto size = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    stream_.write(buffer, size);
+    return *this;
+}
+
+json_writer& json_writer::value(const char* value)
+{
+    separate();
+    write_string(value, std::char_traits<char>::length(value));
+    return *this;
+}
+
+json_writer& json_writer::value(const std::string& value)
+{
+    separate();
+    write_string(value.data(), value.size());
+    return *this;
+}
+
+json_writer& json_writer::value(const Json::Value& tree)
+{
+    switch (tree.type())
+    {
+        case Json::nullValue:
+            return null();
+        case Json::intValue:
+            return value(static_cast<int64_t>(tree.asLargestInt()));
+        case Json::uintValue:
+            return value(static_cast<uint64_t>(tree.asLargestUInt()));
+        case Json::realValue:
+            return value(tree.asDouble());
+        case Json::booleanValue:
+            return value(tree.asBool());
+        case Json::stringValue:
+        {
+            const char* begin = nullptr;
+            const char* end = nullptr;
+            separate();
+            if (tree.getString(&begin, &end))
+                write_string(begin, end - begin);
+            else
+                write_string("", 0);
+            return *this;
+        }
+        case Json::arrayValue:
+        {
+            begin_array();
+            for (const auto& item: tree)
+                value(item);
+            return end_array();
+        }
+        case Json::objectValue:
+        {
+            // Object iteration is in key order, as toStyledString writes.
+            begin_object();
+            for (auto it = tree.begin(); it != tree.end(); ++it)
+                key(it.name()).value(*it);
+            return end_object();
+        }
+    }
+
+    return *this;
+}
+
+void json_writer::write_string(const char* data, size_t size)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    stream_.put('"');
+
+    // Copy runs of characters needing no escape in one write.
+    size_t run = 0;
+    for (size_t index = 0; index < size; ++index)
+    {
+        const auto character = static_cast<unsigned char>(data[index]);
+        if (character >= 0x20 && character != '"' && character != '\\')
+            continue;
+
+        stream_.write(data + run, index - run);
+        run = index + 1;
+
+        switch (character)
+        {
+            case '"': stream_.write("\\\"", 2); break;
+            case '\\': stream_.write("\\\\", 2); break;
+            case '\b': stream_.write("\\b", 2); break;
+            case '\f': stream_.write("\\f", 2); break;
+            case '\n': stream_.write("\\n", 2); break;
+            case '\r': stream_.write("\\r", 2); break;
+            case '\t': stream_.write("\\t", 2); break;
+            default:
+            {
+                const char escape[] = { '\\', 'u', '0', '0',
+                    hex[character >> 4], hex[character & 0x0f] };
+                stream_.write(escape, sizeof(escape));
+                break;
+            }
+        }
+    }
+
+    stream_.write(data + run, size - run);
+    stream_.put('"');
+}
+
+std::string write_compact(const Json::Value& tree)
+{
+    std::ostringstream stream;
+    json_writer(stream).value(tree);
+    return stream.str();
+}
+
+} // namespace config
+} // namespace explorer
+} // namespace libbitcoin
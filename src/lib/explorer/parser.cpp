@@ -79,15 +79,102 @@ void parser::load_command_variables(variables_map& variables,
         instance_.load_fallbacks(input, variables);
 }
 
+// Named options are taken from the first object in params and positional
+// arguments from the other values, as converted to argv for /rpc/v2. Values
+// are stored against the command's own metadata without tokenizing.
+void parser::load_json_variables(variables_map& variables,
+    std::istream& input, const Json::Value& params)
+{
+    const auto options = load_options();
+    const auto arguments = load_arguments();
+    po::parsed_options parsed(&options);
+
+    const auto add = [&parsed](const std::string& key, int position,
+        const Json::Value& value)
+    {
+        po::option option;
+        option.string_key = key;
+        option.position_key = position;
+        if (!value.empty())
+            option.value.push_back(value.asString());
+        option.original_tokens.push_back(key);
+        parsed.options.push_back(option);
+    };
+
+    auto named = false;
+    auto position = 0;
+    for (const auto& param: params)
+    {
+        if (!param.isObject())
+        {
+            if (position >= static_cast<int>(arguments.max_total_count()))
+                throw po::too_many_positional_options_error();
+
+            const auto& name = arguments.name_for_position(position);
+            add(name, position++, param);
+            continue;
+        }
+
+        if (named)
+            continue;
+
+        named = true;
+        for (const auto& key: param.getMemberNames())
+        {
+            const auto definition = options.find_nothrow(key, false);
+            if (definition == nullptr)
+                throw po::unknown_option(key);
+
+            const auto& name = definition->long_name().empty() ? key :
+                definition->long_name();
+            const auto& value = param[key];
+
+            if (!value.isArray())
+            {
+                add(name, -1, value);
+                continue;
+            }
+
+            for (const auto& member: value)
+                add(name, -1, member);
+        }
+    }
+
+    store(parsed, variables);
+
+    // Don't load rest if help is specified.
+    // For variable with stdin or file fallback load the input stream.
+    if (!get_option(variables, BX_HELP_VARIABLE))
+        instance_.load_fallbacks(input, variables);
+}
+
 bool parser::parse(std::string& out_error, std::istream& input,
     int argc, const char* argv[])
+{
+    return parse(out_error, [&](variables_map& variables)
+    {
+        load_command_variables(variables, input, argc, argv);
+    });
+}
+
+bool parser::parse(std::string& out_error, std::istream& input,
+    const Json::Value& params)
+{
+    return parse(out_error, [&](variables_map& variables)
+    {
+        load_json_variables(variables, input, params);
+    });
+}
+
+bool parser::parse(std::string& out_error,
+    std::function<void(variables_map&)> load_command)
 {
     try
     {
         variables_map variables;
 
         // Must store before environment in order for commands to supercede.
-        load_command_variables(variables, input, argc, argv);
+        load_command(variables);
 
         // Don't load rest if help is specified.
         if (!get_option(variables, BX_HELP_VARIABLE))
@@ -25,6 +25,7 @@
 #include <iostream>
 #include <memory>
 #include <metaverse/bitcoin.hpp>
+#include <metaverse/network/ban_table.hpp>
 #include <metaverse/network/channel.hpp>
 #include <metaverse/network/proxy.hpp>
 #include <metaverse/network/settings.hpp>
@@ -149,9 +150,20 @@ void acceptor::handle_accept(const boost_code& ec, socket::ptr socket,
 {
     // This is the end of the accept sequence.
     if (ec)
+    {
         handler(error::boost_to_error_code(ec), nullptr);
-    else
-        handler(error::success, new_channel(socket));
+        return;
+    }
+
+    // Drop banned addresses before paying for a channel.
+    if (ban_table::instance().banned(socket->get_authority()))
+    {
+        socket->close();
+        handler(error::address_blocked, nullptr);
+        return;
+    }
+
+    handler(error::success, new_channel(socket));
 }
 
 std::shared_ptr<channel> acceptor::new_channel(socket::ptr socket)
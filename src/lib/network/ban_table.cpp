@@ -0,0 +1,240 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/network/ban_table.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <boost/functional/hash.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/utility/time.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+// Bound the shared table under a flood of misbehaving addresses.
+static constexpr size_t default_capacity = 65536;
+static constexpr uint32_t default_ban_seconds = 24 * 60 * 60;
+
+ban_table& ban_table::instance()
+{
+    static ban_table table(default_capacity, default_ban_seconds);
+    return table;
+}
+
+ban_table::shard::shard()
+  : wheel(wheel_slots), cursor(0)
+{
+}
+
+size_t ban_table::key_hash::operator()(const key& value) const
+{
+    return boost::hash_range(value.begin(), value.end());
+}
+
+ban_table::ban_table(size_t capacity, uint32_t ban_seconds)
+  : shard_capacity_(std::max<size_t>(capacity / shard_count, 1)),
+    ban_seconds_(ban_seconds),
+    slot_milliseconds_(std::max<int64_t>(
+        int64_t(ban_seconds) * 1000 / wheel_slots, 1000))
+{
+}
+
+ban_table::shard& ban_table::find_shard(const key& address)
+{
+    return shards_[key_hash()(address) % shard_count];
+}
+
+const ban_table::shard& ban_table::find_shard(const key& address) const
+{
+    return shards_[key_hash()(address) % shard_count];
+}
+
+size_t ban_table::slot_index(int64_t millisecond) const
+{
+    return static_cast<size_t>(millisecond / slot_milliseconds_) %
+        wheel_slots;
+}
+
+void ban_table::ban(const config::authority& authority)
+{
+    ban(authority, ban_seconds_);
+}
+
+void ban_table::ban(const config::authority& authority, uint32_t seconds)
+{
+    const auto address = authority.ip();
+    const auto now = unix_millisecond();
+    const auto expiry = now + int64_t(seconds) * 1000;
+    auto& shard = find_shard(address);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(shard.mutex);
+
+    sweep(shard, now);
+
+    auto it = shard.expiries.find(address);
+    if (it != shard.expiries.end())
+    {
+        // A repeat offense extends but never shortens the ban.
+        if (expiry <= it->second)
+            return;
+
+        // Move the entry, so the wheel holds each address once.
+        unschedule(shard, address, it->second);
+        it->second = expiry;
+    }
+    else
+    {
+        if (shard.expiries.size() >= shard_capacity_)
+            evict(shard);
+
+        shard.expiries.emplace(address, expiry);
+    }
+
+    shard.wheel[slot_index(expiry)].push_back(address);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool ban_table::banned(const config::authority& authority) const
+{
+    const auto address = authority.ip();
+    const auto& shard = find_shard(address);
+    int64_t expiry;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        shared_lock lock(shard.mutex);
+        const auto it = shard.expiries.find(address);
+        if (it == shard.expiries.end())
+            return false;
+
+        expiry = it->second;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    return expiry > unix_millisecond();
+}
+
+size_t ban_table::size() const
+{
+    size_t count = 0;
+
+    for (const auto& shard: shards_)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        shared_lock lock(shard.mutex);
+        count += shard.expiries.size();
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return count;
+}
+
+// private, call under the shard's unique lock.
+// Remove the wheel entry of an address from the slot of its expiry.
+void ban_table::unschedule(shard& shard, const key& address, int64_t expiry)
+{
+    auto& slot = shard.wheel[slot_index(expiry)];
+    const auto it = std::find(slot.begin(), slot.end(), address);
+
+    if (it != slot.end())
+    {
+        *it = slot.back();
+        slot.pop_back();
+    }
+}
+
+// private, call under the shard's unique lock.
+// Visit each slot passed since the last sweep, dropping expired entries.
+// A slot may hold entries for a later rotation, so each is compared to its
+// expiry.
+void ban_table::sweep(shard& shard, int64_t now)
+{
+    const auto tick = now / slot_milliseconds_;
+    if (shard.cursor == 0)
+        shard.cursor = tick;
+
+    const auto steps = std::min<int64_t>(tick - shard.cursor, wheel_slots);
+
+    for (int64_t step = 0; step < steps; ++step)
+    {
+        auto& slot = shard.wheel[(shard.cursor + step) % wheel_slots];
+        const auto expired = [&shard, now](const key& address)
+        {
+            const auto it = shard.expiries.find(address);
+            if (it == shard.expiries.end())
+                return true;
+
+            if (it->second > now)
+                return false;
+
+            shard.expiries.erase(it);
+            return true;
+        };
+
+        slot.erase(std::remove_if(slot.begin(), slot.end(), expired),
+            slot.end());
+    }
+
+    shard.cursor = tick;
+}
+
+// private, call under the shard's unique lock.
+// Drop the entry nearest to expiry, scanning forward from the cursor. The
+// cursor slot also holds the bans of a full duration (a whole rotation
+// ahead), so expiries are compared, and the scan ends once no later slot can
+// hold an earlier expiry.
+void ban_table::evict(shard& shard)
+{
+    auto nearest = shard.expiries.end();
+
+    for (int64_t step = 0; step < int64_t(wheel_slots); ++step)
+    {
+        const auto tick = shard.cursor + step;
+
+        if (nearest != shard.expiries.end() &&
+            nearest->second < tick * slot_milliseconds_)
+            break;
+
+        for (const auto& address: shard.wheel[tick % wheel_slots])
+        {
+            const auto it = shard.expiries.find(address);
+
+            if (it != shard.expiries.end() &&
+                (nearest == shard.expiries.end() ||
+                    it->second < nearest->second))
+                nearest = it;
+        }
+    }
+
+    if (nearest == shard.expiries.end())
+        return;
+
+    unschedule(shard, nearest->first, nearest->second);
+    shard.expiries.erase(nearest);
+}
+
+} // namespace network
+} // namespace libbitcoin
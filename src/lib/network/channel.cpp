@@ -48,6 +48,10 @@ static deadline::ptr alarm(threadpool& pool, const asio::duration& duration)
 // On handshake send peer version.maxiumum and on receipt of protocol_peer
 // if it is below protocol_minimum drop the channel, otherwise set
 // protocol_version to the lesser of protocol_maximum and protocol_peer.
+// The most recent inventory the peer is remembered to have.
+static constexpr size_t known_inventory_capacity = 10000;
+static constexpr double known_inventory_false_positive_rate = 0.000001;
+
 channel::channel(threadpool& pool, socket::ptr socket,
     const settings& settings)
   : proxy(pool, socket, settings.identifier, settings.protocol),
@@ -55,6 +59,8 @@ channel::channel(threadpool& pool, socket::ptr socket,
     nonce_(0),
     expiration_(alarm(pool, settings.channel_expiration())),
     inactivity_(alarm(pool, settings.channel_inactivity())),
+    known_inventory_(known_inventory_capacity,
+        known_inventory_false_positive_rate),
     CONSTRUCT_TRACK(channel)
 {
 }
@@ -101,6 +107,16 @@ void channel::set_nonce(uint64_t value)
     nonce_ = value;
 }
 
+void channel::set_known(const hash_digest& hash)
+{
+    known_inventory_.insert(hash);
+}
+
+bool channel::known(const hash_digest& hash) const
+{
+    return known_inventory_.contains(hash);
+}
+
 void channel::set_protocol_start_handler(std::function<void()> handler)
 {
     protocol_start_handler_ = std::move(handler);
@@ -114,6 +114,11 @@ config::authority::list connections::authority_list()
 	return address_list;
 }
 
+connections::list connections::channel_list() const
+{
+    return safe_copy();
+}
+
 bool connections::safe_remove(channel::ptr channel)
 {
     // Critical Section
@@ -45,6 +45,12 @@ const_buffer::const_buffer(const data_chunk& data)
 {
 }
 
+const_buffer::const_buffer(std::shared_ptr<const data_chunk> data)
+  : data_(data),
+    buffer_(boost::asio::buffer(*data_))
+{
+}
+
 size_t const_buffer::size() const
 {
     return data_->size();
@@ -115,36 +115,43 @@ void message_subscriber::broadcast(const code& ec)
 
 code message_subscriber::load(message_type type, uint32_t version,
     std::istream& stream) const
+{
+    istream_reader source(stream);
+    return load(type, version, source);
+}
+
+code message_subscriber::load(message_type type, uint32_t version,
+    reader& source) const
 {
     switch (type)
     {
-        CASE_RELAY_MESSAGE(stream, version, address);
-        CASE_RELAY_MESSAGE(stream, version, alert);
-        CASE_HANDLE_MESSAGE(stream, version, block_message);
-        CASE_RELAY_MESSAGE(stream, version, block_transactions);
-        CASE_RELAY_MESSAGE(stream, version, compact_block);
-        CASE_RELAY_MESSAGE(stream, version, fee_filter);
-        CASE_RELAY_MESSAGE(stream, version, filter_add);
-        CASE_RELAY_MESSAGE(stream, version, filter_clear);
-        CASE_RELAY_MESSAGE(stream, version, filter_load);
-        CASE_RELAY_MESSAGE(stream, version, get_address);
-        CASE_RELAY_MESSAGE(stream, version, get_blocks);
-        CASE_RELAY_MESSAGE(stream, version, get_block_transactions);
-        CASE_RELAY_MESSAGE(stream, version, get_data);
-        CASE_RELAY_MESSAGE(stream, version, get_headers);
-        CASE_RELAY_MESSAGE(stream, version, headers);
-        CASE_RELAY_MESSAGE(stream, version, inventory);
-        CASE_RELAY_MESSAGE(stream, version, memory_pool);
-        CASE_RELAY_MESSAGE(stream, version, merkle_block);
-        CASE_RELAY_MESSAGE(stream, version, not_found);
-        CASE_RELAY_MESSAGE(stream, version, ping);
-        CASE_RELAY_MESSAGE(stream, version, pong);
-        CASE_RELAY_MESSAGE(stream, version, reject);
-        CASE_RELAY_MESSAGE(stream, version, send_headers);
-        CASE_RELAY_MESSAGE(stream, version, send_compact_blocks);
-        CASE_RELAY_MESSAGE(stream, version, transaction_message);
-        CASE_RELAY_MESSAGE(stream, version, verack);
-        CASE_HANDLE_MESSAGE(stream, version, version);
+        CASE_RELAY_MESSAGE(source, version, address);
+        CASE_RELAY_MESSAGE(source, version, alert);
+        CASE_HANDLE_MESSAGE(source, version, block_message);
+        CASE_RELAY_MESSAGE(source, version, block_transactions);
+        CASE_RELAY_MESSAGE(source, version, compact_block);
+        CASE_RELAY_MESSAGE(source, version, fee_filter);
+        CASE_RELAY_MESSAGE(source, version, filter_add);
+        CASE_RELAY_MESSAGE(source, version, filter_clear);
+        CASE_RELAY_MESSAGE(source, version, filter_load);
+        CASE_RELAY_MESSAGE(source, version, get_address);
+        CASE_RELAY_MESSAGE(source, version, get_blocks);
+        CASE_RELAY_MESSAGE(source, version, get_block_transactions);
+        CASE_RELAY_MESSAGE(source, version, get_data);
+        CASE_RELAY_MESSAGE(source, version, get_headers);
+        CASE_RELAY_MESSAGE(source, version, headers);
+        CASE_RELAY_MESSAGE(source, version, inventory);
+        CASE_RELAY_MESSAGE(source, version, memory_pool);
+        CASE_RELAY_MESSAGE(source, version, merkle_block);
+        CASE_RELAY_MESSAGE(source, version, not_found);
+        CASE_RELAY_MESSAGE(source, version, ping);
+        CASE_RELAY_MESSAGE(source, version, pong);
+        CASE_RELAY_MESSAGE(source, version, reject);
+        CASE_RELAY_MESSAGE(source, version, send_headers);
+        CASE_RELAY_MESSAGE(source, version, send_compact_blocks);
+        CASE_RELAY_MESSAGE(source, version, transaction_message);
+        CASE_RELAY_MESSAGE(source, version, verack);
+        CASE_HANDLE_MESSAGE(source, version, version);
         case message_type::unknown:
         default:
             return error::not_found;
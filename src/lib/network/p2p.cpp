@@ -54,6 +54,13 @@ namespace network {
 
 using namespace std::placeholders;
 
+// Inventory requested or received across all channels, to skip lookups.
+static constexpr size_t recent_inventory_capacity = 100000;
+static constexpr double recent_inventory_false_positive_rate = 0.000001;
+
+// A peer that does not answer a request in this time loses its claim on it.
+static const asio::seconds requested_inventory_timeout(60);
+
 #ifdef USE_UPNP
 static std::atomic<size_t> out_address_use_count_ = { 0 };
 bc::atomic<config::authority::ptr> upnp_out;
@@ -63,6 +70,10 @@ p2p::p2p(const settings& settings)
     : settings_(settings),
     stopped_(true),
     height_(0),
+    recent_inventory_(recent_inventory_capacity,
+        recent_inventory_false_positive_rate),
+    requested_inventory_(requested_inventory_timeout),
+    high_bandwidth_peers_(0),
     hosts_(std::make_shared<hosts>(threadpool_, settings_)),
     connections_(std::make_shared<connections>()),
     stop_subscriber_(std::make_shared<stop_subscriber>(threadpool_, NAME "_stop_sub")),
@@ -329,6 +340,21 @@ threadpool& p2p::thread_pool()
     return threadpool_;
 }
 
+rolling_filter& p2p::recent_inventory()
+{
+    return recent_inventory_;
+}
+
+inventory_requests& p2p::requested_inventory()
+{
+    return requested_inventory_;
+}
+
+std::atomic<size_t>& p2p::high_bandwidth_peers()
+{
+    return high_bandwidth_peers_;
+}
+
 // Subscriptions.
 // ----------------------------------------------------------------------------
 
@@ -51,6 +51,16 @@ uint64_t protocol::nonce() const
     return channel_->nonce();
 }
 
+void protocol::set_known(const hash_digest& hash)
+{
+    channel_->set_known(hash);
+}
+
+bool protocol::known(const hash_digest& hash) const
+{
+    return channel_->known(hash);
+}
+
 message::version protocol::peer_version() const
 {
     return channel_->version();
@@ -66,6 +76,11 @@ uint32_t protocol::peer_start_height()
 	return channel_->peer_start_height();
 }
 
+uint32_t protocol::protocol_magic() const
+{
+    return channel_->protocol_magic();
+}
+
 threadpool& protocol::pool()
 {
     return pool_;
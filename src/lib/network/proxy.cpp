@@ -28,6 +28,7 @@
 #include <functional>
 #include <memory>
 #include <metaverse/bitcoin.hpp>
+#include <metaverse/network/ban_table.hpp>
 #include <metaverse/network/const_buffer.hpp>
 #include <metaverse/network/define.hpp>
 #include <metaverse/network/socket.hpp>
@@ -80,6 +81,13 @@ std::shared_ptr<traffic> traffic::instance_ = nullptr;
 
 #define NAME "proxy"
 
+// A channel is stopped when its peer does not drain the outbound queue.
+static constexpr size_t max_outbound_messages = 500;
+static constexpr size_t max_outbound_bytes = 64 * 1024 * 1024;
+
+// Queued messages are coalesced into vectored writes of up to this size.
+static constexpr size_t max_batch_bytes = 256 * 1024;
+
 using namespace message;
 using namespace std::placeholders;
 
@@ -96,7 +104,10 @@ proxy::proxy(threadpool& pool, socket::ptr socket, uint32_t protocol_magic,
     peer_protocol_version_(message::version::level::maximum),
     message_subscriber_(pool),
     stop_subscriber_(std::make_shared<stop_subscriber>(pool, NAME)),
-    has_sent_{true},
+    sending_(false),
+    outbound_bytes_(0),
+    outbound_flushes_(0),
+    outbound_bytes_sent_(0),
     misbehaving_{0}
 {
 }
@@ -277,29 +288,23 @@ void proxy::handle_read_payload(const boost_code& ec, size_t payload_size,
         return;
     }
     
-    ///////////////////////////////////////////////////////////////////////////
-    // TODO: we aren't getting a stream benefit if we read the full payload
-    // before parsing the message. Should just make this a message parse.
-    ///////////////////////////////////////////////////////////////////////////
-
     handle_request(payload_buffer_, peer_protocol_version_.load(), head, payload_size);
 
     handle_activity();
     read_heading();
 }
 
-void proxy::handle_request(data_chunk payload_buffer, uint32_t peer_protocol_version, heading head, size_t payload_size)
+void proxy::handle_request(const data_chunk& payload_buffer, uint32_t peer_protocol_version, const heading& head, size_t payload_size)
 {
     bool succeed = false;
 
-    // Notify subscribers of the new message.
-    payload_source source(payload_buffer);
-    payload_stream istream(source);
+    // Notify subscribers of the new message, parsed in place from the buffer.
+    data_reader source(payload_buffer);
     const auto version = peer_protocol_version;
 
-    const auto code = message_subscriber_.load(head.type(), version, istream);
+    const auto code = message_subscriber_.load(head.type(), version, source);
 
-    const auto consumed = istream.peek() == std::istream::traits_type::eof();
+    const auto consumed = source.is_exhausted();
 
     if (code)
     {
@@ -328,6 +333,37 @@ void proxy::handle_request(data_chunk payload_buffer, uint32_t peer_protocol_ver
 // Message send sequence.
 // ----------------------------------------------------------------------------
 
+void proxy::send_buffer(const std::string& command, const_buffer buffer,
+    result_handler handler)
+{
+    do_send(command, buffer, handler);
+}
+
+uint32_t proxy::protocol_version() const
+{
+    return protocol_version_;
+}
+
+uint32_t proxy::protocol_magic() const
+{
+    return protocol_magic_;
+}
+
+size_t proxy::outbound_bytes() const
+{
+    return outbound_bytes_;
+}
+
+uint64_t proxy::outbound_flushes() const
+{
+    return outbound_flushes_;
+}
+
+uint64_t proxy::outbound_bytes_sent() const
+{
+    return outbound_bytes_sent_;
+}
+
 void proxy::do_send(const std::string& command, const_buffer buffer,
     result_handler handler)
 {
@@ -337,111 +373,115 @@ void proxy::do_send(const std::string& command, const_buffer buffer,
         return;
     }
 
-    if (command == "headers") {
-    	log::trace(LOG_NETWORK) << "";
-    }
-
     //thin log network
 	log::trace(LOG_NETWORK)
 		<< "Sending " << command << " to [" << authority() << "] ("
 		<< buffer.size() << " bytes)";
 
-    // Critical Section (protect socket)
+    size_t outbound_size;
+    size_t queued_bytes;
+
+    // Critical Section (protect socket and outbound queue)
     ///////////////////////////////////////////////////////////////////////////
-    // The socket is locked until async_write returns.
-#define QUEUE_REQUEST
-#ifdef QUEUE_REQUEST
-    bool is_ok_to_send{false};
-    uint32_t outbound_size{0};
-    request_callback h{nullptr};
     {
-        auto pThis = shared_from_this();
-        auto f = [this, pThis, buffer, handler](){
-            if (stopped())
-            {
-                handler(error::channel_stopped);
-                return;
-            }
-            const auto socket = socket_->get_socket();
-			auto& native_socket = socket->get();
-            async_write(native_socket, buffer,
-                    std::bind(&proxy::handle_send,
-                    		shared_from_this(), _1, buffer, handler));
-        };
         const auto socket = socket_->get_socket();
+        outbound_queue_.push_back({ buffer, handler });
         outbound_size = outbound_queue_.size();
-        bool is_empty{outbound_queue_.empty()};
-        bool in_sending{!has_sent_.load()};
-        is_ok_to_send = (is_empty && !in_sending);
-        if (is_ok_to_send)
-        {
-            h = std::move(f);
-            has_sent_.store(false);
-        }
-        else{
-            outbound_queue_.push(std::move(f));
-        }
+        queued_bytes = (outbound_bytes_ += buffer.size());
+
+        // The socket is locked until async_write returns.
+        if (!sending_)
+            write_batch(socket);
     }
+    ///////////////////////////////////////////////////////////////////////////
 
-    if (outbound_size > 500) {
+    if (outbound_size > max_outbound_messages ||
+        queued_bytes > max_outbound_bytes)
+    {
+        log::debug(LOG_NETWORK)
+            << "Outbound queue of [" << authority() << "] exceeded ("
+            << outbound_size << " messages, " << queued_bytes << " bytes)";
         stop(error::size_limits);
-        return;
     }
+}
+
+// Must be called with the socket locked and no write in progress.
+void proxy::write_batch(locked_socket::ptr socket)
+{
+    if (outbound_queue_.empty())
+        return;
+
+    const auto batch = std::make_shared<std::vector<outbound>>();
+    std::vector<asio::const_buffer> buffers;
+    size_t batch_bytes = 0;
 
-    if (is_ok_to_send)
+    // Always take at least one message, however large.
+    while (!outbound_queue_.empty() && (batch->empty() ||
+        batch_bytes + outbound_queue_.front().buffer.size() <= max_batch_bytes))
     {
-        h();
+        auto& next = outbound_queue_.front();
+        batch_bytes += next.buffer.size();
+        buffers.insert(buffers.end(), next.buffer.begin(), next.buffer.end());
+        batch->push_back(std::move(next));
+        outbound_queue_.pop_front();
     }
-#else
-    const auto socket = socket_->get_socket();
 
-    // The shared buffer is kept in scope until the handler is invoked.
-    using namespace boost::asio;
-    async_write(socket->get(), buffer,
+    sending_ = true;
+    ++outbound_flushes_;
+
+    // The batch keeps the shared buffers in scope until the handler runs.
+    async_write(socket->get(), buffers,
         std::bind(&proxy::handle_send,
-            shared_from_this(), _1, buffer, handler));
-#endif
-    // The shared buffer is kept in scope until the handler is invoked.
-    ///////////////////////////////////////////////////////////////////////////
+            shared_from_this(), _1, _2, batch));
 }
 
-void proxy::handle_send(const boost_code& ec, const_buffer buffer,
-    result_handler handler)
+void proxy::handle_send(const boost_code& ec, size_t bytes,
+    outbound_batch batch)
 {
     const auto error = code(error::boost_to_error_code(ec));
 
+    size_t batch_bytes = 0;
+    for (const auto& message: *batch)
+        batch_bytes += message.buffer.size();
+
+    outbound_bytes_ -= batch_bytes;
+
     if (error)
         log::trace(LOG_NETWORK)
-            << "Failure sending " << buffer.size() << " byte message to ["
-            << authority() << "] " << error.message();
-    else{
+            << "Failure sending " << batch_bytes << " bytes in "
+            << batch->size() << " messages to [" << authority() << "] "
+            << error.message();
+    else
+    {
+        outbound_bytes_sent_ += bytes;
 #ifndef NDEBUG
-        traffic::instance().tx(buffer.size());
+        traffic::instance().tx(bytes);
 #endif
     }
 
-    handler(error);
-#ifdef QUEUE_REQUEST
-    if(error){
-    	const auto socket = socket_->get_socket();
-    	std::queue<request_callback>{}.swap(outbound_queue_);
-        return;
-    }
+    for (const auto& message: *batch)
+        message.handler(error);
 
-    has_sent_.store(true);
+    outbound_queue failed;
 
-    request_callback h{nullptr};
+    // Critical Section (protect socket and outbound queue)
+    ///////////////////////////////////////////////////////////////////////////
     {
         const auto socket = socket_->get_socket();
-        if(outbound_queue_.empty())
-            return;
-        log::trace(LOG_NETWORK) << "channel:" << reinterpret_cast<int64_t>(this) << " outbound size," << outbound_queue_.size();
-        h = std::move(outbound_queue_.front());
-        outbound_queue_.pop();
-        has_sent_.store(false);
+        sending_ = false;
+
+        if (error || stopped())
+            failed.swap(outbound_queue_);
+        else
+            write_batch(socket);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    for (const auto& message: failed)
+    {
+        outbound_bytes_ -= message.buffer.size();
+        message.handler(error ? error : code(error::channel_stopped));
     }
-    h();
-#endif
 }
 
 // Stop sequence.
@@ -467,20 +507,23 @@ void proxy::stop(const code& ec)
 
     // Give channel opportunity to terminate timers.
     handle_stopping();
+    outbound_queue unsent;
     {
 		const auto socket = socket_->get_socket();
-		std::queue<request_callback>{}.swap(outbound_queue_);
+		unsent.swap(outbound_queue_);
     }
 
-    // The socket_ is internally guarded against concurrent use.
-    socket_->close();
+    for (const auto& message: unsent)
     {
-        if (error::bad_magic != ec.value())
-            return;
-        boost::detail::spinlock::scoped_lock guard{proxy::spinlock_};
-        auto millissecond = unix_millisecond();
-        banned_.insert({authority(), millissecond + 24 * 3600 * 1000});
+        outbound_bytes_ -= message.buffer.size();
+        message.handler(error::channel_stopped);
     }
+
+    // The socket_ is internally guarded against concurrent use.
+    socket_->close();
+
+    if (ec.value() == error::bad_magic)
+        ban_table::instance().ban(authority());
 }
 
 void proxy::stop(const boost_code& ec)
@@ -493,25 +536,9 @@ bool proxy::stopped() const
     return stopped_;
 }
 
-std::map<config::authority, int64_t> proxy::banned_;
-boost::detail::spinlock proxy::spinlock_;
-
 bool proxy::blacklisted(const config::authority& authority)
 {
-    int64_t ms{0};
-    {
-        boost::detail::spinlock::scoped_lock guard{proxy::spinlock_};
-        auto it = banned_.find(authority);
-        if(it == banned_.end())
-            return false;
-        ms = it->second;
-    }
-    auto millissecond = unix_millisecond();
-    if (ms >= millissecond)
-    {
-        return true;
-    }
-    return false;
+    return ban_table::instance().banned(authority);
 }
 
 
@@ -520,11 +547,7 @@ bool proxy::misbehaving(int32_t howmuch)
     misbehaving_ += howmuch;
     if (misbehaving_.load() >= 100)
     {
-        {
-            boost::detail::spinlock::scoped_lock guard{proxy::spinlock_};
-            auto millissecond = unix_millisecond();
-            banned_.insert({authority(), millissecond + 24 * 3600 * 1000});
-        }
+        ban_table::instance().ban(authority());
         log::debug(LOG_NETWORK) << "channel misbehave trigger," << authority();
         stop(error::bad_stream);
         return true;
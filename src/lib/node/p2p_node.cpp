@@ -116,6 +116,7 @@ void p2p_node::handle_headers_synchronized(const code& ec,
 
     // The instance is retained by the stop handler (i.e. until shutdown).
     const auto block_sync = attach_block_sync_session();
+    block_sync_.store(block_sync);
 
     // This is invoked on a new thread.
     block_sync->start(
@@ -125,6 +126,9 @@ void p2p_node::handle_headers_synchronized(const code& ec,
 
 void p2p_node::handle_running(const code& ec, result_handler handler)
 {
+    // Block sync is complete, stop reporting its statistics.
+    block_sync_.store(nullptr);
+
     if (stopped())
     {
         handler(error::service_stopped);
@@ -271,6 +275,17 @@ transaction_pool& p2p_node::pool()
 // Subscriptions.
 // ----------------------------------------------------------------------------
 
+bool p2p_node::sync_statistics(reservations::sync_statistics& out) const
+{
+    const auto block_sync = block_sync_.load();
+
+    if (!block_sync)
+        return false;
+
+    out = block_sync->statistics();
+    return true;
+}
+
 void p2p_node::subscribe_blockchain(reorganize_handler handler)
 {
     chain().subscribe_reorganize(handler);
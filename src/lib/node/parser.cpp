@@ -142,7 +142,7 @@ options_metadata parser::load_settings()
     (
         "network.protocol",
         value<uint32_t>(&configured.network.protocol),
-        "The network protocol version, defaults to 70012."
+        "The network protocol version, defaults to 70014."
     )
     (
         "network.identifier",
@@ -41,10 +41,14 @@ using namespace std::placeholders;
 static constexpr auto perpetual_timer = true;
 static const auto get_blocks_interval = asio::seconds(100);
 
+// Peers asked to push new blocks unsolicited as compact blocks (bip152).
+static constexpr size_t high_bandwidth_limit = 3;
+
 protocol_block_in::protocol_block_in(p2p& network, channel::ptr channel,
     block_chain& blockchain)
   : protocol_timer(network, channel, perpetual_timer, NAME),
     blockchain_(blockchain),
+    recent_(network.recent_inventory()),
     last_locator_top_(null_hash),
     current_chain_top_(null_hash),
 
@@ -52,6 +56,13 @@ protocol_block_in::protocol_block_in(p2p& network, channel::ptr channel,
     headers_from_peer_(peer_version().value >= version::level::bip130),
     headers_batch_size_{0},
 
+    // Compact blocks are only decodable if both sides negotiated bip152.
+    compact_from_peer_(network.network_settings().protocol >=
+        version::level::bip152 &&
+        peer_version().value >= version::level::bip152),
+    high_bandwidth_peers_(network.high_bandwidth_peers()),
+    high_bandwidth_(false),
+
     CONSTRUCT_TRACK(protocol_block_in)
 {
 }
@@ -66,7 +77,16 @@ protocol_block_in::ptr protocol_block_in::do_subscribe()
 
     SUBSCRIBE2(inventory, handle_receive_inventory, _1, _2);
     SUBSCRIBE2(block_message, handle_receive_block, _1, _2);
+
+    if (compact_from_peer_)
+    {
+        SUBSCRIBE2(compact_block, handle_receive_compact_block, _1, _2);
+        SUBSCRIBE2(block_transactions, handle_receive_block_transactions,
+            _1, _2);
+    }
+
     protocol_timer::start(get_blocks_interval, BIND1(get_block_inventory, _1));
+    SUBSCRIBE_STOP1(handle_stop, _1);
     return std::dynamic_pointer_cast<protocol_block_in>(protocol::shared_from_this());
 }
 
@@ -84,6 +104,14 @@ void protocol_block_in::start()
 //        SEND2(send_headers(), handle_send, _1, send_headers::command);
     }
 
+    if (compact_from_peer_)
+    {
+        // A few peers push new blocks to us as compact blocks, the others
+        // announce them and we request only what we lack.
+        const send_compact_blocks request{ take_high_bandwidth(), 1 };
+        SEND2(request, handle_send, _1, request.command);
+    }
+
     // Subscribe to block acceptance notifications (for gap fill redundancy).
     blockchain_.subscribe_reorganize(
         BIND4(handle_reorganized, _1, _2, _3, _4));
@@ -253,11 +281,29 @@ bool protocol_block_in::handle_receive_inventory(const code& ec,
 
     const auto response = std::make_shared<get_data>();
     message->reduce(response->inventories, inventory::type_id::block);
-    if(response->inventories.empty())
+    auto& inventories = response->inventories;
+
+    // The peer has what it announces, and blocks recently stored from any
+    // peer need neither an orphan pool nor a database lookup.
+    const auto seen = [this](const inventory_vector& inventory)
+    {
+        set_known(inventory.hash);
+        return recent_.contains(inventory.hash);
+    };
+
+    inventories.erase(std::remove_if(inventories.begin(), inventories.end(),
+        seen), inventories.end());
+
+    if(inventories.empty())
     {
         return true;
     }
 
+    // A new block announced by a low bandwidth compact peer is requested as
+    // a compact block, get_blocks batches are requested in full.
+    if (compact_from_peer_ && !high_bandwidth_ && inventories.size() == 1)
+        inventories.front().type = inventory::type_id::compact_block;
+
     // Remove block hashes found in the orphan pool.
     blockchain_.filter_orphans(response,
         BIND2(handle_filter_orphans, _1, response));
@@ -299,12 +345,25 @@ void protocol_block_in::send_get_data(const code& ec, get_data_ptr message)
         return;
     }
 
-    headers_batch_size_ += message->inventories.size();
+    // Only full blocks count toward the get_blocks batch.
+    const auto& inventories = message->inventories;
+    headers_batch_size_ += std::count_if(inventories.begin(),
+        inventories.end(), [](const inventory_vector& inventory)
+        {
+            return inventory.type == inventory::type_id::block;
+        });
 
     // inventory|headers->get_data[blocks]
     SEND2(*message, handle_send, _1, message->command);
 }
 
+void protocol_block_in::send_get_block(const hash_digest& hash)
+{
+    const auto request = std::make_shared<get_data>();
+    request->inventories.push_back({ inventory::type_id::block, hash });
+    send_get_data(error::success, request);
+}
+
 // Receive not_found sequence.
 //-----------------------------------------------------------------------------
 
@@ -371,6 +430,7 @@ bool protocol_block_in::handle_receive_block(const code& ec, block_ptr message)
 
     // We will pick this up in handle_reorganized.
     message->set_originator(nonce());
+    set_known(message->header.hash());
 
     log::trace(LOG_NODE) << "from " << authority() << ",receive block hash," << encode_hash(message->header.hash()) << ",tx-size," << message->header.transaction_count << ",number," << message->header.number ;
 
@@ -378,6 +438,160 @@ bool protocol_block_in::handle_receive_block(const code& ec, block_ptr message)
     return true;
 }
 
+// Receive compact block sequence.
+//-----------------------------------------------------------------------------
+
+// The block is rebuilt from the prefilled transactions and the memory pool.
+// Missing transactions are requested with get_block_transactions, and any
+// inconsistency falls back to requesting the full block.
+bool protocol_block_in::handle_receive_compact_block(const code& ec,
+    compact_block_ptr message)
+{
+    if (stopped())
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting compact block from [" << authority() << "] "
+            << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    reset_timer();
+
+    const auto hash = message->header.hash();
+    auto& blockchain = static_cast<block_chain_impl&>(blockchain_);
+    set_known(hash);
+
+    uint64_t height;
+    if (blockchain.get_height(height, hash))
+        return true;
+
+    auto& pool = blockchain.pool();
+    const auto find = [&pool](const hash_digest& tx_hash,
+        chain::transaction& out_transaction)
+    {
+        // The transaction may have left the pool since the hashes were read.
+        const auto tx = pool.find_transaction(tx_hash);
+        if (!tx)
+            return false;
+
+        out_transaction = *tx;
+        return true;
+    };
+
+    const auto block = std::make_shared<block_message>();
+    std::vector<uint64_t> missing;
+
+    if (!message->reconstruct(*block, missing, pool.transaction_hashes(),
+        find))
+    {
+        send_get_block(hash);
+        return true;
+    }
+
+    if (missing.empty())
+    {
+        store_compact_block(block);
+        return true;
+    }
+
+    log::trace(LOG_NODE)
+        << "Compact block [" << encode_hash(hash) << "] from ["
+        << authority() << "] missing " << missing.size() << " of "
+        << block->transactions.size() << " transactions.";
+
+    const get_block_transactions request{ hash, missing };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    compact_mutex_.lock();
+
+    // A newer announcement supersedes any block still awaiting transactions.
+    compact_pending_ = block;
+    compact_missing_ = std::move(missing);
+
+    compact_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    SEND2(request, handle_send, _1, request.command);
+    return true;
+}
+
+bool protocol_block_in::handle_receive_block_transactions(const code& ec,
+    block_transactions_ptr message)
+{
+    if (stopped())
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting block transactions from [" << authority()
+            << "] " << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    block_ptr block;
+    std::vector<uint64_t> missing;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    compact_mutex_.lock();
+
+    if (compact_pending_ &&
+        compact_pending_->header.hash() == message->block_hash)
+    {
+        block.swap(compact_pending_);
+        missing.swap(compact_missing_);
+    }
+
+    compact_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Ignore transactions for a block we are no longer waiting on.
+    if (!block)
+        return true;
+
+    if (message->transactions.size() != missing.size())
+    {
+        send_get_block(message->block_hash);
+        return true;
+    }
+
+    for (size_t index = 0; index < missing.size(); ++index)
+        block->transactions[missing[index]] = message->transactions[index];
+
+    store_compact_block(block);
+    return true;
+}
+
+void protocol_block_in::store_compact_block(block_ptr block)
+{
+    const auto hash = block->header.hash();
+
+    // A short id matched the wrong pool transaction, get the full block.
+    if (chain::block::generate_merkle_root(block->transactions) !=
+        block->header.merkle)
+    {
+        log::trace(LOG_NODE)
+            << "Compact block [" << encode_hash(hash) << "] from ["
+            << authority() << "] failed reconstruction.";
+        send_get_block(hash);
+        return;
+    }
+
+    // We will pick this up in handle_reorganized.
+    block->set_originator(nonce());
+
+    log::trace(LOG_NODE) << "from " << authority() << ",receive compact block hash," << encode_hash(hash) << ",tx-size," << block->header.transaction_count << ",number," << block->header.number ;
+
+    blockchain_.store(block, BIND2(handle_store_block, _1, block));
+}
+
 void protocol_block_in::handle_store_block(const code& ec, block_ptr message)
 {
     if (stopped() || ec == (code)error::service_stopped)
@@ -386,6 +600,7 @@ void protocol_block_in::handle_store_block(const code& ec, block_ptr message)
     // Ignore the block that we already have, a common result.
     if (ec == (code)error::duplicate)
     {
+        recent_.insert(message->header.hash());
         log::trace(LOG_NODE)
             << "Redundant block from [" << authority() << "] "
             << ec.message();
@@ -456,14 +671,64 @@ bool protocol_block_in::handle_reorganized(const code& ec, size_t fork_point,
 
     // Report the blocks that originated from this peer.
     // If originating peer is dropped there will be no report here.
+    // These are also remembered as recent, once, by the originating channel.
     for (const auto block: incoming)
-        if (block->originator() == nonce())
-            log::trace(LOG_NODE)
-                << "Block [" << encode_hash(block->header.hash()) << "] from ["
-                << authority() << "].";
+    {
+        if (block->originator() != nonce())
+            continue;
+
+        const auto hash = block->header.hash();
+        recent_.insert(hash);
+        log::trace(LOG_NODE)
+            << "Block [" << encode_hash(hash) << "] from ["
+            << authority() << "].";
+
+        // A peer that delivers new blocks takes a slot another one vacated.
+        if (compact_from_peer_ && !high_bandwidth_ && take_high_bandwidth())
+        {
+            const send_compact_blocks request{ true, 1 };
+            SEND2(request, handle_send, _1, request.command);
+        }
+    }
 
     return true;
 }
 
+// High bandwidth slots.
+//-----------------------------------------------------------------------------
+
+bool protocol_block_in::take_high_bandwidth()
+{
+    auto peers = high_bandwidth_peers_.load();
+
+    do
+    {
+        if (peers >= high_bandwidth_limit)
+            return false;
+    } while (!high_bandwidth_peers_.compare_exchange_weak(peers, peers + 1));
+
+    high_bandwidth_ = true;
+
+    // The stop handler may already have run, so it cannot release the slot.
+    if (channel_stopped())
+    {
+        release_high_bandwidth();
+        return false;
+    }
+
+    return true;
+}
+
+void protocol_block_in::release_high_bandwidth()
+{
+    if (high_bandwidth_.exchange(false))
+        --high_bandwidth_peers_;
+}
+
+void protocol_block_in::handle_stop(const code&)
+{
+    release_high_bandwidth();
+}
+
 } // namespace node
 } // namespace libbitcoin
@@ -44,6 +44,9 @@ using namespace std::placeholders;
 // for the exponential back-off algorithm.
 static constexpr auto locator_allowance = 12u;
 
+// Larger announcements (catching up after a reorg) use headers or inventory.
+static constexpr size_t compact_announcement_limit = 3;
+
 protocol_block_out::protocol_block_out(p2p& network, channel::ptr channel,
     block_chain& blockchain)
   : protocol_events(network, channel, NAME),
@@ -55,6 +58,12 @@ protocol_block_out::protocol_block_out(p2p& network, channel::ptr channel,
     headers_to_peer_(network.network_settings().protocol >=
         version::level::bip130),
 
+    // Compact blocks are only decodable if both sides negotiated bip152.
+    compact_capable_(network.network_settings().protocol >=
+        version::level::bip152 &&
+        peer_version().value >= version::level::bip152),
+    compact_to_peer_(false),
+
     CONSTRUCT_TRACK(protocol_block_out)
 {
 }
@@ -73,6 +82,14 @@ protocol_block_out::ptr protocol_block_out::do_subscribe()
     SUBSCRIBE2(get_blocks, handle_receive_get_blocks, _1, _2);
     SUBSCRIBE2(get_data, handle_receive_get_data, _1, _2);
 
+    if (compact_capable_)
+    {
+        SUBSCRIBE2(send_compact_blocks, handle_receive_send_compact_blocks,
+            _1, _2);
+        SUBSCRIBE2(get_block_transactions,
+            handle_receive_get_block_transactions, _1, _2);
+    }
+
     protocol_events::start(BIND1(handle_stop, _1));
     return std::dynamic_pointer_cast<protocol_block_out>(protocol::shared_from_this());
 }
@@ -119,6 +136,34 @@ bool protocol_block_out::handle_receive_send_headers(const code& ec,
     return false;
 }
 
+// Receive send_compact_blocks.
+//-----------------------------------------------------------------------------
+
+bool protocol_block_out::handle_receive_send_compact_blocks(const code& ec,
+    send_compact_blocks_ptr message)
+{
+    if (stopped())
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting send_compact_blocks from [" << authority()
+            << "] " << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    // Only version 1 short ids are supported, other versions are ignored.
+    if (message->version != 1)
+        return true;
+
+    // Block annoucements will be pushed as compact blocks (high bandwidth).
+    // The peer may toggle this at any time, so remain subscribed.
+    compact_to_peer_.store(message->high_bandwidth_mode);
+    return true;
+}
+
 // Receive get_headers sequence.
 //-----------------------------------------------------------------------------
 
@@ -312,24 +357,31 @@ bool protocol_block_out::handle_receive_get_data(const code& ec,
         return false;
     }
 
-    // TODO: these must return message objects or be copied!
+    auto& blockchain = static_cast<block_chain_impl&>(blockchain_);
+    const auto magic = protocol_magic();
+
+    // Blocks are served as framed wire messages, shared across channels.
     // Ignore non-block inventory requests in this protocol.
     for (const auto& inventory: message->inventories)
     {
         if (inventory.type == inventory::type_id::block)
-            blockchain_.fetch_block(inventory.hash,
+            blockchain.fetch_block_message(inventory.hash, magic,
                 BIND3(send_block, _1, _2, inventory.hash));
         else if (inventory.type == inventory::type_id::filtered_block)
             blockchain_.fetch_merkle_block(inventory.hash,
                 BIND3(send_merkle_block, _1, _2, inventory.hash));
+        else if (compact_capable_ &&
+            inventory.type == inventory::type_id::compact_block)
+            blockchain_.fetch_block(inventory.hash,
+                BIND3(send_compact_block, _1, _2, inventory.hash));
     }
 
     return true;
 }
 
 // TODO: move not_found to derived class protocol_block_out_70001.
-void protocol_block_out::send_block(const code& ec, chain::block::ptr block,
-    const hash_digest& hash)
+void protocol_block_out::send_block(const code& ec,
+    block_message_cache::message_ptr message, const hash_digest& hash)
 {
     if (stopped() || ec == (code)error::service_stopped)
     {
@@ -355,8 +407,9 @@ void protocol_block_out::send_block(const code& ec, chain::block::ptr block,
         return;
     }
 
-    // TODO: eliminate copy.
-    SEND2(block_message(*block), handle_send, _1, block_message::command);
+    set_known(hash);
+    SEND_BUFFER2(block_message::command, const_buffer(message), handle_send,
+        _1, block_message::command);
 }
 
 // TODO: move filtered_block to derived class protocol_block_out_70001.
@@ -388,9 +441,147 @@ void protocol_block_out::send_merkle_block(const code& ec,
     SEND2(*message, handle_send, _1, message->command);
 }
 
+// A low bandwidth peer requests the compact block of a block we announced.
+void protocol_block_out::send_compact_block(const code& ec,
+    chain::block::ptr block, const hash_digest& hash)
+{
+    if (stopped() || ec == (code)error::service_stopped)
+        return;
+
+    if (ec == (code)error::not_found)
+    {
+        log::trace(LOG_NODE)
+            << "Compact block requested by [" << authority() << "] not found."
+            << encode_hash(hash);
+
+        const not_found reply{ { inventory::type_id::compact_block, hash } };
+        SEND2(reply, handle_send, _1, reply.command);
+        return;
+    }
+
+    if (ec)
+    {
+        log::error(LOG_NODE)
+            << "Internal failure locating compact block requested by ["
+            << authority() << "] " << ec.message();
+        stop(ec);
+        return;
+    }
+
+    set_known(hash);
+    const auto response = compact_block::from_block(*block, pseudo_random());
+    SEND2(response, handle_send, _1, response.command);
+}
+
+// Receive get_block_transactions sequence.
+//-----------------------------------------------------------------------------
+
+bool protocol_block_out::handle_receive_get_block_transactions(
+    const code& ec, get_block_transactions_ptr message)
+{
+    if (stopped())
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting get_block_transactions from ["
+            << authority() << "] " << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    blockchain_.fetch_block(message->block_hash,
+        BIND3(send_block_transactions, _1, _2, message));
+    return true;
+}
+
+void protocol_block_out::send_block_transactions(const code& ec,
+    chain::block::ptr block, get_block_transactions_ptr request)
+{
+    if (stopped() || ec == (code)error::service_stopped)
+        return;
+
+    if (ec == (code)error::not_found)
+    {
+        log::trace(LOG_NODE)
+            << "Compact block transactions requested by [" << authority()
+            << "] not found." << encode_hash(request->block_hash);
+
+        const not_found reply{ { inventory::type_id::block,
+            request->block_hash } };
+        SEND2(reply, handle_send, _1, reply.command);
+        return;
+    }
+
+    if (ec)
+    {
+        log::error(LOG_NODE)
+            << "Internal failure locating block requested by ["
+            << authority() << "] " << ec.message();
+        stop(ec);
+        return;
+    }
+
+    block_transactions response;
+    response.block_hash = request->block_hash;
+    response.transactions.reserve(request->indexes.size());
+
+    for (const auto index: request->indexes)
+    {
+        if (index >= block->transactions.size())
+        {
+            log::debug(LOG_NODE)
+                << "Invalid get_block_transactions index (" << index
+                << ") from [" << authority() << "] ";
+            stop(error::channel_stopped);
+            return;
+        }
+
+        response.transactions.push_back(block->transactions[index]);
+    }
+
+    SEND2(response, handle_send, _1, response.command);
+}
+
 // Subscription.
 //-----------------------------------------------------------------------------
 
+// Push each new block as a compact block, the coinbase is always prefilled.
+// Returns false if the announcement must fall back to headers or inventory.
+bool protocol_block_out::announce_compact_blocks(
+    const block_ptr_list& incoming)
+{
+    if (!compact_to_peer_ || incoming.size() > compact_announcement_limit)
+        return false;
+
+    // A peer far from our top cannot connect these, so announce nothing.
+    auto& blockchain = static_cast<block_chain_impl&>(blockchain_);
+    uint64_t top;
+    auto is_got = blockchain.get_last_height(top);
+    int64_t block_interval = 20000;
+    auto res = std::abs(static_cast<int64_t>(top) - static_cast<int64_t>(peer_start_height()));
+    if (!is_got || res > block_interval)
+        return true;
+
+    for (const auto& block: incoming)
+    {
+        const auto hash = block->header.hash();
+
+        if (block->originator() == nonce() || known(hash) ||
+            block->transactions.empty())
+            continue;
+
+        set_known(hash);
+
+        const auto announcement = compact_block::from_block(*block,
+            pseudo_random());
+        SEND2(announcement, handle_send, _1, announcement.command);
+    }
+
+    return true;
+}
+
 // TODO: make sure we are announcing older blocks first here.
 // We never announce or inventory an orphan, only indexed blocks.
 bool protocol_block_out::handle_reorganized(const code& ec, size_t fork_point,
@@ -417,13 +608,17 @@ bool protocol_block_out::handle_reorganized(const code& ec, size_t fork_point,
     BITCOIN_ASSERT(max_size_t - fork_point >= incoming.size());
     current_chain_height_.store(fork_point + incoming.size());
 
+    if (announce_compact_blocks(incoming))
+        return true;
+
     // TODO: move announce headers to a derived class protocol_block_in_70012.
     if (headers_to_peer_)
     {
         headers announcement;
 
         for (const auto block: incoming)
-            if (block->originator() != nonce())
+            if (block->originator() != nonce() &&
+                !known(block->header.hash()))
                 announcement.elements.push_back(block->header);
 
         if (!announcement.elements.empty())
@@ -437,6 +632,9 @@ bool protocol_block_out::handle_reorganized(const code& ec, size_t fork_point,
 			{
 				return true;
 			}
+            for (const auto& header: announcement.elements)
+                set_known(header.hash());
+
             SEND2(announcement, handle_send, _1, announcement.command);
         }
         return true;
@@ -446,8 +644,11 @@ bool protocol_block_out::handle_reorganized(const code& ec, size_t fork_point,
     inventory announcement;
 
     for (const auto block: incoming)
-        if (block->originator() != nonce())
-            announcement.inventories.push_back( { id, block->header.hash() });
+    {
+        const auto hash = block->header.hash();
+        if (block->originator() != nonce() && !known(hash))
+            announcement.inventories.push_back( { id, hash });
+    }
 
     if (!announcement.inventories.empty())
     {
@@ -460,6 +661,10 @@ bool protocol_block_out::handle_reorganized(const code& ec, size_t fork_point,
 		{
 			return true;
 		}
+
+        for (const auto& inventory: announcement.inventories)
+            set_known(inventory.hash);
+
         SEND2(announcement, handle_send, _1, announcement.command);
     }
     return true;
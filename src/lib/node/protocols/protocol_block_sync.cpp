@@ -128,7 +128,15 @@ bool protocol_block_sync::handle_receive(const code& ec, block_ptr message,
     }
 
     // Add the block to the blockchain store.
-    reservation_->import(message);
+    // A block that fails its checks is requested again on a new channel.
+    if (!reservation_->import(message))
+    {
+        log::trace(LOG_NODE)
+            << "Restarting slot (" << reservation_->slot()
+            << ") after a failed import.";
+        complete(error::channel_stopped);
+        return false;
+    }
 
     if (reservation_->toggle_partitioned())
     {
@@ -24,6 +24,7 @@
 #include <cstddef>
 #include <functional>
 #include <metaverse/network.hpp>
+#include <metaverse/consensus/miner/MinerAux.h>
 #include <metaverse/node/p2p_node.hpp>
 #include <metaverse/node/utility/header_queue.hpp>
 
@@ -44,12 +45,16 @@ static constexpr size_t max_header_response = 500;
 // The interval in which header download rate is measured and tested.
 static const asio::seconds expiry_interval(5);
 
+// The number of headers verified by one pool job, a light ethash compute each.
+static constexpr size_t headers_per_slice = 50;
+
 // This class requires protocol version 31800.
 protocol_header_sync::protocol_header_sync(p2p& network,
     channel::ptr channel, header_queue& hashes, uint32_t minimum_rate,
     const checkpoint& last)
   : protocol_timer(network, channel, true, NAME),
     hashes_(hashes),
+    dispatch_(network.thread_pool(), NAME),
     current_second_(0),
     minimum_rate_(minimum_rate),
     start_size_(hashes.size()),
@@ -133,13 +138,90 @@ bool protocol_header_sync::handle_receive(const code& ec, headers_ptr message,
         return false;
     }
 
+    // The seals are verified on the pool, the merge resumes in handle_verified.
+    verify_headers(message, complete);
+    return true;
+}
+
+// Verify the seal of each header before it is accepted into the queue.
+void protocol_header_sync::verify_headers(headers_ptr message,
+    event_handler complete)
+{
+    const auto count = message->elements.size();
+    const auto slices = (count + headers_per_slice - 1) / headers_per_slice;
+
+    if (slices == 0)
+    {
+        handle_verified(error::success, message, complete);
+        return;
+    }
+
+    // The first failure terminates the synchronizer and returns its code.
+    const auto verified = synchronize(
+        BIND3(handle_verified, _1, message, complete), slices, NAME, false);
+
+    for (size_t first = 0; first < count; first += headers_per_slice)
+    {
+        const auto last = std::min(first + headers_per_slice, count);
+        dispatch_.concurrent(
+            BIND4(verify_slice, message, first, last, verified));
+    }
+}
+
+// The light cache of each epoch is shared, so slices only contend on compute.
+void protocol_header_sync::verify_slice(headers_ptr message, size_t first,
+    size_t last, event_handler verified)
+{
+    auto& elements = message->elements;
+
+    for (auto index = first; index < last; ++index)
+    {
+        if (stopped())
+        {
+            verified(error::channel_stopped);
+            return;
+        }
+
+        auto& header = elements[index];
+
+        // The parent of the first header in the batch is not available here,
+        // so its difficulty is checked when the block itself is validated.
+        const auto valid = index == 0 ?
+            MinerAux::verifyProofOfWork(header) :
+            MinerAux::verifySeal(header, elements[index - 1]);
+
+        if (!valid)
+        {
+            log::warning(LOG_NODE)
+                << "Invalid proof of work for header [" << header.number
+                << "] from [" << authority() << "]";
+            verified(error::proof_of_work);
+            return;
+        }
+    }
+
+    verified(error::success);
+}
+
+void protocol_header_sync::handle_verified(const code& ec,
+    headers_ptr message, event_handler complete)
+{
+    if (stopped())
+        return;
+
+    if (ec)
+    {
+        complete(ec);
+        return;
+    }
+
     // A merge failure includes automatic rollback to last trust point.
     if (!hashes_.enqueue(message))
     {
         log::warning(LOG_NODE)
             << "Failure merging headers from [" << authority() << "]";
         complete(error::previous_block_invalid);
-        return false;
+        return;
     }
 
     const auto next = next_height();
@@ -153,7 +235,7 @@ bool protocol_header_sync::handle_receive(const code& ec, headers_ptr message,
     {
     	log::trace(LOG_NODE) << "protocol header sync handle receive complete";
         complete(error::success);
-        return false;
+        return;
     }
 
     // If we received fewer than 2000 the peer is exhausted, try another.
@@ -161,12 +243,11 @@ bool protocol_header_sync::handle_receive(const code& ec, headers_ptr message,
     {
     	log::trace(LOG_NODE) << "protocol header sync handle receive message size < max header response";
         complete(error::operation_failed);
-        return false;
+        return;
     }
 
     // This peer has more headers.
     send_get_headers(complete);
-    return true;
 }
 
 // This is fired by the base timer and stop handler.
@@ -20,6 +20,7 @@
  */
 #include <metaverse/node/protocols/protocol_transaction_in.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <functional>
 #include <memory>
@@ -36,13 +37,21 @@ using namespace bc::message;
 using namespace bc::network;
 using namespace std::placeholders;
 
+// Announced transactions claimed by another channel are retried this often.
+static const asio::seconds retry_interval(15);
+
+// Bound the announcements held for retry, the rest are left to other peers.
+static constexpr size_t max_deferred = 5000;
+
 // TODO: derive from protocol_session_node abstract intermediate base class.
 // TODO: Pass p2p_node on construct, obtaining node configuration settings.
 protocol_transaction_in::protocol_transaction_in(p2p& network,
     channel::ptr channel, block_chain& blockchain, transaction_pool& pool)
-  : protocol_events(network, channel, NAME),
+  : protocol_timer(network, channel, true, NAME),
     blockchain_(blockchain),
     pool_(pool),
+    recent_(network.recent_inventory()),
+    requested_(network.requested_inventory()),
 
     // TODO: move relay to a derived class protocol_transaction_in_70001.
     relay_from_peer_(network.network_settings().relay_transactions),
@@ -60,7 +69,8 @@ protocol_transaction_in::ptr protocol_transaction_in::do_subscribe()
 {
     SUBSCRIBE2(inventory, handle_receive_inventory, _1, _2);
     SUBSCRIBE2(transaction_message, handle_receive_transaction, _1, _2);
-    protocol_events::start(BIND1(handle_stop, _1));
+    SUBSCRIBE2(not_found, handle_receive_not_found, _1, _2);
+    protocol_timer::start(retry_interval, BIND1(handle_event, _1));
     return std::dynamic_pointer_cast<protocol_transaction_in>(protocol::shared_from_this());
 }
 
@@ -120,6 +130,22 @@ bool protocol_transaction_in::handle_receive_inventory(const code& ec,
         return false;
     }
 
+    auto& inventories = response->inventories;
+
+    // The peer has what it announces, and anything requested or received
+    // recently from any peer needs neither a pool nor a database lookup.
+    const auto seen = [this](const inventory_vector& inventory)
+    {
+        set_known(inventory.hash);
+        return recent_.contains(inventory.hash);
+    };
+
+    inventories.erase(std::remove_if(inventories.begin(), inventories.end(),
+        seen), inventories.end());
+
+    if (inventories.empty())
+        return true;
+
     auto hash = message->inventories.empty() ? "" : encode_hash(message->inventories[0].hash);
     log::trace(LOG_NODE) << "protocol_transaction_in::handle_receive_inventory pool filter," << hash;
     // This is returned on a new thread.
@@ -164,6 +190,25 @@ void protocol_transaction_in::send_get_data(const code& ec,
         stop(ec);
         return;
     }
+    auto& inventories = message->inventories;
+
+    // Another channel may have requested the same transaction meanwhile.
+    // Keep it to retry here in case that channel never delivers it.
+    const auto requested = [this](const inventory_vector& inventory)
+    {
+        if (requested_.claim(inventory.hash, nonce()))
+            return false;
+
+        defer(inventory.hash);
+        return true;
+    };
+
+    inventories.erase(std::remove_if(inventories.begin(), inventories.end(),
+        requested), inventories.end());
+
+    if (inventories.empty())
+        return;
+
     log::trace(LOG_NODE) << "protocol_transaction_in::send_get_data";
     // inventory->get_data[transaction]
     SEND2(*message, handle_send, _1, message->command);
@@ -197,8 +242,13 @@ bool protocol_transaction_in::handle_receive_transaction(const code& ec,
         return false;
     }
 
+    const auto hash = message->hash();
+    set_known(hash);
+    recent_.insert(hash);
+    requested_.release(hash);
+
     log::debug(LOG_NODE)
-        << "Potential transaction from [" << authority() << "]." << encode_hash(message->hash());
+        << "Potential transaction from [" << authority() << "]." << encode_hash(hash);
 
     pool_.store(message,
         BIND2(handle_store_confirmed, _1, _2),
@@ -206,6 +256,81 @@ bool protocol_transaction_in::handle_receive_transaction(const code& ec,
     return true;
 }
 
+// The peer does not have (or will not give) transactions it was asked for.
+bool protocol_transaction_in::handle_receive_not_found(const code& ec,
+    not_found_ptr message)
+{
+    if (stopped())
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting transaction not_found from [" << authority()
+            << "] " << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    hash_list hashes;
+    message->to_hashes(hashes, inventory::type_id::transaction);
+
+    // Let a channel that also announced them request them now.
+    for (const auto& hash: hashes)
+        requested_.release(hash, nonce());
+
+    return true;
+}
+
+// Retry sequence.
+//-----------------------------------------------------------------------------
+
+void protocol_transaction_in::defer(const hash_digest& hash)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    scoped_lock lock(deferred_mutex_);
+
+    if (deferred_.size() < max_deferred)
+        deferred_.insert(hash);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Request the announced transactions whose claim elsewhere has been released
+// or has lapsed, skipping those that have arrived in the meantime.
+void protocol_transaction_in::send_deferred()
+{
+    hash_set deferred;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    deferred_mutex_.lock();
+    deferred.swap(deferred_);
+    deferred_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    const auto request = std::make_shared<get_data>();
+    auto& inventories = request->inventories;
+
+    for (const auto& hash: deferred)
+    {
+        if (recent_.contains(hash))
+            continue;
+
+        if (requested_.claim(hash, nonce()))
+            inventories.push_back({ inventory::type_id::transaction, hash });
+        else
+            defer(hash);
+    }
+
+    if (inventories.empty())
+        return;
+
+    log::trace(LOG_NODE) << "protocol_transaction_in::send_deferred "
+        << inventories.size();
+    SEND2(*request, handle_send, _1, request->command);
+}
+
 // The transaction has been saved to the memory pool (or not).
 // This will be picked up by subscription in transaction_out and will cause
 // the transaction to be announced to non-originating relay-accepting peers.
@@ -265,13 +390,37 @@ bool protocol_transaction_in::handle_reorganized(const code& ec, size_t,
     return true;
 }
 
-// Stop.
+// Timer and stop.
 //-----------------------------------------------------------------------------
 
+// This is fired by the callback (i.e. base timer and stop handler).
+void protocol_transaction_in::handle_event(const code& ec)
+{
+    if (stopped())
+    {
+        handle_stop(ec);
+        return;
+    }
+
+    if (ec && ec != (code)error::channel_timeout)
+    {
+        log::trace(LOG_NODE)
+            << "Failure in transaction timer for [" << authority() << "] "
+            << ec.message();
+        stop(ec);
+        return;
+    }
+
+    send_deferred();
+}
+
 void protocol_transaction_in::handle_stop(const code&)
 {
     log::trace(LOG_NETWORK)
         << "Stopped transaction_in protocol";
+
+    // Requests this channel can no longer answer go to the other announcers.
+    requested_.release_all(nonce());
     blockchain_.fired();
 }
 
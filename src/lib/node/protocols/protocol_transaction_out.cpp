@@ -138,6 +138,7 @@ bool protocol_transaction_out::handle_receive_memory_pool(const code& ec,
         hashes.reserve(txs.size());
         for(auto& t:txs) {
             hashes.push_back(t->hash());
+            set_known(hashes.back());
         }
         send<protocol_transaction_out>(inventory{hashes, inventory::type_id::transaction}, &protocol_transaction_out::handle_send, _1, inventory::command);
     });
@@ -213,7 +214,8 @@ void protocol_transaction_out::send_transaction(const code& ec,
         return;
     }
 
-    log::trace(LOG_NODE) << "send transaction " << encode_hash(transaction.hash()) << ", to " << authority();
+    log::trace(LOG_NODE) << "send transaction " << encode_hash(hash) << ", to " << authority();
+    set_known(hash);
 
     // TODO: eliminate copy.
     SEND2(transaction_message(transaction), handle_send, _1,
@@ -244,12 +246,19 @@ bool protocol_transaction_out::handle_floated(const code& ec,
     // TODO: implement fee computation.
     const uint64_t fee = 0;
 
+    const auto hash = message->hash();
+
+    // Skip peers that sent, announced or were already sent the transaction.
+    if (message->originator() == nonce() || known(hash))
+        return true;
+
     // Transactions are discovered and announced individually.
-    if (message->originator() != nonce() && fee >= minimum_fee_.load())
+    if (fee >= minimum_fee_.load())
     {
+        set_known(hash);
         static const auto id = inventory::type_id::transaction;
-        const inventory announcement{ { id, message->hash() } };
-        log::trace(LOG_NODE) << "handle floated send transaction hash," << encode_hash(message->hash()) ;
+        const inventory announcement{ { id, hash } };
+        log::trace(LOG_NODE) << "handle floated send transaction hash," << encode_hash(hash) ;
         SEND2(announcement, handle_send, _1, announcement.command);
     }
 
@@ -66,6 +66,11 @@ void session_block_sync::start(result_handler handler)
     session::start(CONCURRENT2(handle_started, _1, handler));
 }
 
+reservations::sync_statistics session_block_sync::statistics() const
+{
+    return reservations_.statistics();
+}
+
 void session_block_sync::handle_started(const code& ec, result_handler handler)
 {
     if (ec)
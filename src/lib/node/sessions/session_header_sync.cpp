@@ -50,6 +50,12 @@ static constexpr float back_off_factor = 0.75f;
 // The starting minimum header download rate, exponentially backs off.
 static constexpr uint32_t headers_per_second = 10000;
 
+// The number of checkpoint partitions downloaded concurrently.
+static constexpr size_t maximum_parallel_segments = 8;
+
+// The segment index of a channel that was not assigned a segment.
+static constexpr size_t no_segment = max_size_t;
+
 // Sort is required here but not in configuration settings.
 session_header_sync::session_header_sync(p2p& network, header_queue& hashes,
     simple_chain& blockchain, const checkpoint::list& checkpoints)
@@ -60,6 +66,7 @@ session_header_sync::session_header_sync(p2p& network, header_queue& hashes,
     checkpoints_(checkpoint::sort(checkpoints)),
 	try_count_{0},
 	synced_{false},
+    merged_(0),
     CONSTRUCT_TRACK(session_header_sync)
 {
     static_assert(back_off_factor < 1.0, "invalid back-off factor");
@@ -85,8 +92,18 @@ void session_header_sync::handle_started(const code& ec,
     if (!initialize(handler))
         return;
 
+    size_t count;
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        shared_lock lock(mutex_);
+        count = std::min(segments_.size(), maximum_parallel_segments);
+        ///////////////////////////////////////////////////////////////////////
+    }
+
     // This is the end of the start sequence.
-    new_connection(create_connector(), handler);
+    for (size_t channel = 0; channel < count; ++channel)
+        new_connection(create_connector(), handler);
 }
 
 // Header sync sequence.
@@ -119,16 +136,32 @@ void session_header_sync::handle_connect(const code& ec, channel::ptr channel,
         	handler(ec);
 			return;
 		}
-        handle_channel_stop(ec, connect, handler);
+        handle_channel_stop(ec, connect, no_segment, handler);
+        return;
+    }
+
+    size_t index;
+    std::shared_ptr<header_queue> hashes;
+    checkpoint stop;
+
+    // Another channel may have taken the last segment while connecting.
+    if (!reserve_segment(index, hashes, stop))
+    {
+        log::debug(LOG_NODE)
+            << "No header segment for channel [" << channel->authority()
+            << "]";
+        channel->stop(error::channel_stopped);
         return;
     }
 
     log::debug(LOG_NODE)
-        << "Connected to header sync channel [" << channel->authority() << "]";
+        << "Connected to header sync channel [" << channel->authority()
+        << "] for headers " << hashes->last_height() + 1 << "-"
+        << stop.height();
 
     register_channel(channel,
-        BIND4(handle_channel_start, _1, connect, channel, handler),
-        BIND3(handle_channel_stop, _1, connect, handler));
+        BIND5(handle_channel_start, _1, connect, channel, index, handler),
+        BIND4(handle_channel_stop, _1, connect, index, handler));
 }
 
 void session_header_sync::attach_handshake_protocols(channel::ptr channel,
@@ -138,34 +171,55 @@ void session_header_sync::attach_handshake_protocols(channel::ptr channel,
 }
 
 void session_header_sync::handle_channel_start(const code& ec,
-    connector::ptr connect, channel::ptr channel, result_handler handler)
+    connector::ptr connect, channel::ptr channel, size_t index,
+    result_handler handler)
 {
     // Treat a start failure just like a completion failure.
     if (ec)
     {
-        handle_complete(ec, channel, connect, handler);
+        handle_complete(ec, channel, connect, index, handler);
         return;
     }
     try_count_.store(0);
-    attach_protocols(channel, connect, handler);
+    attach_protocols(channel, connect, index, handler);
 }
 
 void session_header_sync::attach_protocols(channel::ptr channel,
-    connector::ptr connect, result_handler handler)
+    connector::ptr connect, size_t index, result_handler handler)
 {
+    std::shared_ptr<header_queue> hashes;
+    checkpoint stop;
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        shared_lock lock(mutex_);
+        hashes = segments_[index].hashes;
+        stop = segments_[index].stop;
+        ///////////////////////////////////////////////////////////////////////
+    }
+
     attach<protocol_ping>(channel)->start();
 	attach<protocol_address>(channel)->start();
-	attach<protocol_header_sync>(channel, hashes_, minimum_rate_, last_)
-		->start(BIND4(handle_complete, _1, channel, connect, handler));
+	attach<protocol_header_sync>(channel, *hashes, minimum_rate_.load(), stop)
+		->start(BIND5(handle_complete, _1, channel, connect, index, handler));
 }
 
 void session_header_sync::handle_complete(const code& ec, channel::ptr channel,
-    network::connector::ptr connect, result_handler handler)
+    network::connector::ptr connect, size_t index, result_handler handler)
 {
-	channel->stop(error::channel_stopped);
     if (!ec)
     {
-    	synced_.store(true);
+        // Mark the segment before the stop so that it is not reassigned.
+        const auto all = complete_segment(index);
+
+        if (all)
+            synced_.store(true);
+
+        channel->stop(error::channel_stopped);
+
+        if (!all)
+            return;
+
     	log::debug(LOG_NODE)
     	    	<< "header sync handle complete successfully," << ec.message() ;
         // This is the end of the header sync sequence.
@@ -173,6 +227,8 @@ void session_header_sync::handle_complete(const code& ec, channel::ptr channel,
         return;
     }
 
+	channel->stop(error::channel_stopped);
+
     // Reduce the rate minimum so that we don't get hung up.
     minimum_rate_ = static_cast<uint32_t>(minimum_rate_ * back_off_factor);
 
@@ -183,19 +239,29 @@ void session_header_sync::handle_complete(const code& ec, channel::ptr channel,
 //    new_connection(connect, handler);
 }
 
-void session_header_sync::handle_channel_stop(const code& ec, network::connector::ptr connect, result_handler handler)
+void session_header_sync::handle_channel_stop(const code& ec,
+    network::connector::ptr connect, size_t index, result_handler handler)
 {
     log::debug(LOG_NODE)
         << "Header sync channel stopped: " << ec.message();
+
+    // The segment keeps its progress and resumes on the next channel.
+    const auto failed = release_segment(index);
+
     if(!synced_)
     {
-    	++try_count_;
-		if (try_count_ == 10)
+		// A channel that completed its segment is not a failed try.
+		if (failed && ++try_count_ == 10)
 		{
 			log::info(LOG_NETWORK) << "session header sync handle connect try count reach 10";
 			handler(error::network_unreachable);
 			return;
 		}
+
+        // Each remaining segment is already being downloaded.
+        if (!unassigned())
+            return;
+
 		new_connection(connect, handler);
     }
 }
@@ -240,9 +306,136 @@ bool session_header_sync::initialize(result_handler handler)
         << "Getting headers " << first_height << "-" << stop_height << ".";
 
     hashes_.initialize(seed);
+    partition(seed);
     return true;
 }
 
+// Split the range at each checkpoint within it, so that every segment has
+// a trusted start and stop hash and is linked to its neighbors by them.
+void session_header_sync::partition(const checkpoint& seed)
+{
+    const auto add = [this](const checkpoint& start, const checkpoint& stop)
+    {
+        const auto hashes = std::make_shared<header_queue>(checkpoints_);
+        hashes->initialize(start, stop);
+        segments_.push_back({ start, stop, hashes, false, false });
+    };
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    segments_.clear();
+    merged_ = 0;
+    auto start = seed;
+
+    for (const auto& check: checkpoints_)
+    {
+        if (check.height() <= start.height() ||
+            check.height() >= last_.height())
+            continue;
+
+        add(start, check);
+        start = check;
+    }
+
+    add(start, last_);
+    ///////////////////////////////////////////////////////////////////////////
+
+    log::info(LOG_NODE)
+        << "Getting headers in " << segments_.size() << " segment(s).";
+}
+
+// Assign the lowest unassigned segment, so that merging is not held back.
+bool session_header_sync::reserve_segment(size_t& out_index,
+    std::shared_ptr<header_queue>& out_hashes, checkpoint& out_stop)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    for (size_t index = merged_; index < segments_.size(); ++index)
+    {
+        auto& segment = segments_[index];
+
+        if (segment.active || segment.complete)
+            continue;
+
+        segment.active = true;
+        out_index = index;
+        out_hashes = segment.hashes;
+        out_stop = segment.stop;
+        return true;
+    }
+
+    return false;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool session_header_sync::release_segment(size_t index)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (index >= segments_.size())
+        return false;
+
+    segments_[index].active = false;
+    return !segments_[index].complete;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool session_header_sync::unassigned() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    for (size_t index = merged_; index < segments_.size(); ++index)
+        if (!segments_[index].active && !segments_[index].complete)
+            return true;
+
+    return false;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Mark the segment complete and merge completed segments in height order.
+// Returns true when every segment has been merged into the shared queue.
+bool session_header_sync::complete_segment(size_t index)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    BITCOIN_ASSERT(index < segments_.size());
+    segments_[index].active = false;
+    segments_[index].complete = true;
+
+    while (merged_ < segments_.size() && segments_[merged_].complete)
+    {
+        auto& segment = segments_[merged_];
+
+        // Linkage is guaranteed by the checkpoints, so this is unexpected.
+        if (!hashes_.append(*segment.hashes))
+        {
+            log::error(LOG_NODE)
+                << "Failure merging headers " << segment.start.height()
+                << "-" << segment.stop.height() << ", restarting segment.";
+            segment.hashes->initialize(segment.start, segment.stop);
+            segment.complete = false;
+            return false;
+        }
+
+        // Release the segment's hashes, they now live in the shared queue.
+        segment.hashes = std::make_shared<header_queue>(checkpoints_);
+        ++merged_;
+    }
+
+    return merged_ == segments_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 // Get the block hashes that bracket the range to download.
 code session_header_sync::get_range(checkpoint& out_seed, checkpoint& out_stop)
 {
@@ -118,6 +118,58 @@ void header_queue::initialize(const hash_digest& hash, size_t height)
     ///////////////////////////////////////////////////////////////////////////
 }
 
+void header_queue::initialize(const checkpoint& start, const checkpoint& stop)
+{
+    BITCOIN_ASSERT(stop.height() >= start.height());
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    list_.clear();
+    list_.reserve(stop.height() - start.height() + 1);
+    list_.emplace_back(start.hash());
+    head_ = list_.begin();
+    height_ = start.height();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_queue::append(const header_queue& segment)
+{
+    size_t segment_height;
+    hash_list hashes;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        shared_lock lock(segment.mutex_);
+
+        if (segment.is_empty())
+            return true;
+
+        segment_height = segment.height_;
+        hash_list::const_iterator first = segment.head_;
+        hashes.assign(first, segment.list_.end());
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // The segment must begin where we end, its first hash is already here.
+    if (is_empty() || segment_height != last() ||
+        hashes.front() != list_.back())
+        return false;
+
+    list_.erase(list_.begin(), head_);
+    list_.reserve(list_.size() + hashes.size() - 1);
+    list_.insert(list_.end(), hashes.begin() + 1, hashes.end());
+    head_ = list_.begin();
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 void header_queue::invalidate(size_t first_height, size_t count)
 {
     // Critical Section
@@ -260,7 +312,7 @@ bool header_queue::enqueue(headers::ptr message)
 // private
 //-----------------------------------------------------------------------------
 
-// TODO: add PoW validation to reduce importance of intermediate checkpoints.
+// Header seals are verified by protocol_header_sync before the merge.
 bool header_queue::merge(const header::list& headers)
 {
     // If we exceed capacity the header pointer becomes invalid, so prevent.
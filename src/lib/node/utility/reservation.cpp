@@ -19,11 +19,13 @@
  */
 #include <metaverse/node/utility/reservation.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <utility>
+#include <vector>
 #include <boost/format.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/node/utility/performance.hpp>
@@ -49,6 +51,16 @@ static constexpr size_t minimum_history = 3;
 // Simple conversion factor, since we trace in micro and report in seconds.
 static constexpr size_t micro_per_second = 1000 * 1000;
 
+// The in-flight window covers this many seconds of measured download.
+static constexpr double window_seconds = 5.0;
+
+// The window bounds, the initial window applies until a rate is measured.
+static constexpr size_t minimum_window = 16;
+static constexpr size_t initial_window = 128;
+
+// Above this share of time in the store a deeper window only adds backlog.
+static constexpr double maximum_store_share = 0.75;
+
 reservation::reservation(reservations& reservations, size_t slot,
     uint32_t block_timeout_seconds)
   : rate_({ true, 0, 0, 0 }),
@@ -251,6 +263,44 @@ size_t reservation::size() const
     ///////////////////////////////////////////////////////////////////////////
 }
 
+size_t reservation::in_flight() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(hash_mutex_);
+
+    return requested_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t reservation::unrequested() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(hash_mutex_);
+
+    return heights_.size() - requested_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Size the window to keep the peer busy for the window period at its
+// measured rate, scaled down as the database becomes the bottleneck.
+size_t reservation::window() const
+{
+    const auto maximum = reservations_.max_request();
+    const auto record = rate();
+
+    if (record.idle)
+        return std::min(initial_window, maximum);
+
+    // The normal rate excludes store time, so it measures the peer.
+    const auto peer_rate = record.normal() * micro_per_second;
+    const auto store_share = std::min(record.ratio(), maximum_store_share);
+    const auto blocks = peer_rate * window_seconds * (1.0 - store_share);
+    const auto window = static_cast<size_t>(blocks);
+    return std::max(minimum_window, std::min(window, maximum));
+}
+
 bool reservation::stopped() const
 {
     // Critical Section (stop)
@@ -261,7 +311,7 @@ bool reservation::stopped() const
     ///////////////////////////////////////////////////////////////////////////
 }
 
-// Obtain and clear the outstanding blocks request.
+// Obtain the next outstanding blocks request, up to the window.
 message::get_data reservation::request(bool new_channel)
 {
     message::get_data packet;
@@ -270,29 +320,48 @@ message::get_data reservation::request(bool new_channel)
     if (new_channel)
         reset();
 
+    // The rate has its own lock, so size the window before taking ours.
+    const auto limit = window();
+
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
     hash_mutex_.lock_upgrade();
 
-    if (!new_channel && !pending_)
+    // A new channel must request everything, prior requests are lost.
+    const auto in_flight = new_channel ? 0 : requested_.size();
+
+    // Top up once half of the window has arrived, avoiding tiny requests.
+    if (!new_channel && (!pending_ || in_flight > limit / 2))
     {
         hash_mutex_.unlock_upgrade();
         //---------------------------------------------------------------------
         return packet;
     }
 
-    // Build get_blocks request message.
-    for (auto height = heights_.right.begin(); height != heights_.right.end();
-        ++height)
+    std::vector<uint32_t> heights;
+
+    // Build get_blocks request message, lowest heights first.
+    for (auto height = heights_.right.begin(); height != heights_.right.end()
+        && in_flight + heights.size() < limit; ++height)
     {
+        if (!new_channel && requested_.count(height->first) != 0)
+            continue;
+
         static const auto id = message::inventory::type_id::block;
         const message::inventory_vector inventory{ id, height->second };
         packet.inventories.emplace_back(inventory);
+        heights.push_back(height->first);
     }
 
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     hash_mutex_.unlock_upgrade_and_lock();
-    pending_ = false;
+
+    if (new_channel)
+        requested_.clear();
+
+    requested_.insert(heights.begin(), heights.end());
+    pending_ = requested_.size() < heights_.size();
+
     hash_mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
@@ -318,7 +387,7 @@ void reservation::insert(const hash_digest& hash, size_t height)
     ///////////////////////////////////////////////////////////////////////////
 }
 
-void reservation::import(block::ptr block)
+bool reservation::import(block::ptr block)
 {
     uint32_t height;
     const auto hash = block->header.hash();
@@ -329,7 +398,7 @@ void reservation::import(block::ptr block)
         log::debug(LOG_NODE)
             << "Ignoring unsolicited block (" << slot() << ") ["
             << encoded << "]";
-        return;
+        return true;
     }
 
     bool success;
@@ -355,12 +424,21 @@ void reservation::import(block::ptr block)
     }
     else
     {
+        // Keep the hash so that it is requested again (of another peer).
+        insert(hash, height);
         log::debug(LOG_NODE)
-            << "Stopped before importing block (" << slot() << ") ["
+            << "Failed to import block (" << slot() << ") ["
             << encoded << "]";
+        return false;
     }
 
     populate();
+
+    // Take unrequested work from a slow row rather than waiting on it.
+    if (!empty() && unrequested() == 0)
+        reservations_.steal(shared_from_this());
+
+    return true;
 }
 
 void reservation::populate()
@@ -429,6 +507,7 @@ bool reservation::partition(reservation::ptr minimal)
     // TODO: move the range in a single command.
     for (size_t index = 0; index < offset; ++index)
     {
+        requested_.erase(it->first);
         minimal->heights_.right.insert(std::move(*it));
         it = heights_.right.erase(it);
     }
@@ -459,6 +538,57 @@ bool reservation::partition(reservation::ptr minimal)
     return populated;
 }
 
+// Give the fast row ~ half of our unrequested hashes, taken from the top so
+// that the blocks this channel is downloading remain with it.
+bool reservation::surrender(reservation::ptr fast)
+{
+    typedef std::pair<hash_digest, uint32_t> hash_height;
+    std::vector<hash_height> moved;
+
+    // Critical Section (hash)
+    ///////////////////////////////////////////////////////////////////////////
+    hash_mutex_.lock_upgrade();
+
+    const auto count = (heights_.size() - requested_.size()) / 2;
+
+    if (count == 0)
+    {
+        hash_mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return false;
+    }
+
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    hash_mutex_.unlock_upgrade_and_lock();
+
+    moved.reserve(count);
+    for (auto it = heights_.right.end(); moved.size() < count &&
+        it != heights_.right.begin();)
+    {
+        --it;
+
+        if (requested_.count(it->first) != 0)
+            continue;
+
+        moved.emplace_back(it->second, it->first);
+        it = heights_.right.erase(it);
+    }
+
+    pending_ = requested_.size() < heights_.size();
+
+    hash_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    for (const auto& entry: moved)
+        fast->insert(entry.first, entry.second);
+
+    log::debug(LOG_NODE)
+        << "Stole [" << moved.size() << "] blocks from slot (" << slot()
+        << ") to (" << fast->slot() << ") leaving [" << size() << "].";
+
+    return true;
+}
+
 bool reservation::find_height_and_erase(const hash_digest& hash,
     uint32_t& out_height)
 {
@@ -479,6 +609,7 @@ bool reservation::find_height_and_erase(const hash_digest& hash,
 
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     hash_mutex_.unlock_upgrade_and_lock();
+    requested_.erase(out_height);
     heights_.left.erase(it);
     hash_mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
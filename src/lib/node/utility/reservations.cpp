@@ -45,7 +45,9 @@ reservations::reservations(header_queue& hashes, simple_chain& chain,
   : hashes_(hashes),
     blockchain_(chain),
     max_request_(max_block_request),
-    timeout_(settings.block_timeout_seconds)
+    timeout_(settings.block_timeout_seconds),
+    imported_(0),
+    started_(std::chrono::steady_clock::now())
 {
     initialize(settings.download_connections);
 }
@@ -53,7 +55,12 @@ reservations::reservations(header_queue& hashes, simple_chain& chain,
 bool reservations::import(block::ptr block, size_t height)
 {
     // Thread safe.
-    return blockchain_.import(block, height);
+    const auto imported = blockchain_.import(block, height);
+
+    if (imported)
+        ++imported_;
+
+    return imported;
 }
 
 // Rate methods.
@@ -99,6 +106,49 @@ reservations::rate_statistics reservations::rates() const
     return{ active_rows, mean, standard_deviation };
 }
 
+// The current rate is the sum over active rows, inclusive of store time.
+reservations::sync_statistics reservations::statistics() const
+{
+    using namespace std::chrono;
+    static constexpr double micro_per_second = 1000 * 1000;
+
+    const auto rows = table();
+    size_t active_count = 0;
+    size_t in_flight = 0;
+    size_t remaining = hashes_.size();
+    double rate = 0;
+    double ratio = 0;
+
+    for (const auto& row: rows)
+    {
+        in_flight += row->in_flight();
+        remaining += row->size();
+
+        if (row->idle())
+            continue;
+
+        const auto record = row->rate();
+        ++active_count;
+        rate += record.total();
+        ratio += record.ratio();
+    }
+
+    const auto imported = imported_.load();
+    const auto elapsed = duration_cast<microseconds>(steady_clock::now() -
+        started_).count();
+
+    return
+    {
+        active_count,
+        imported,
+        in_flight,
+        remaining,
+        rate * micro_per_second,
+        divide<double>(imported, elapsed) * micro_per_second,
+        divide<double>(ratio, active_count)
+    };
+}
+
 // Table methods.
 //-----------------------------------------------------------------------------
 
@@ -215,8 +265,10 @@ bool reservations::populate(reservation::ptr minimal)
     ///////////////////////////////////////////////////////////////////////////
     mutex_.lock();
 
-    // Take from unallocated or allocated hashes, true if minimal not empty.
-    const auto populated = reserve(minimal) || partition(minimal);
+    // Take from unallocated, unrequested or allocated hashes, in that order.
+    // True if minimal not empty.
+    const auto populated = reserve(minimal) || take_unrequested(minimal) ||
+        partition(minimal);
 
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
@@ -229,6 +281,44 @@ bool reservations::populate(reservation::ptr minimal)
     return populated;
 }
 
+// Only a row at or above the mean rate takes work from other rows.
+bool reservations::steal(reservation::ptr fast)
+{
+    if (fast->idle() || fast->rate().normal() < rates().arithmentic_mean)
+        return false;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    return take_unrequested(fast);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// The victim is the slowest row with hashes it has not yet requested, idle
+// rows first. This does not reduce any row's in-flight requests.
+bool reservations::take_unrequested(reservation::ptr fast)
+{
+    reservation::ptr slowest;
+    auto slowest_rate = 0.0;
+
+    for (const auto& row: table_)
+    {
+        if (row == fast || row->unrequested() < 2)
+            continue;
+
+        const auto rate = row->idle() ? 0.0 : row->rate().normal();
+
+        if (!slowest || rate < slowest_rate)
+        {
+            slowest = row;
+            slowest_rate = rate;
+        }
+    }
+
+    return slowest && slowest->surrender(fast);
+}
+
 // This can cause reduction of an active reservation.
 bool reservations::partition(reservation::ptr minimal)
 {
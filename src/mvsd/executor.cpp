@@ -135,6 +135,13 @@ bool executor::do_initchain()
 
     if (ec.value() == directory_exists)
     {
+        // Add what newer versions keep to an existing database.
+        if (data_base::is_lower_database(data_path))
+        {
+            auto genesis = consensus::miner::create_genesis_block(!metadata_.configured.chain.use_testnet_rules);
+            if (!data_base::upgrade_database(metadata_.configured.database, *genesis))
+                throw std::runtime_error{ "upgrade database failed" };
+        }
         return false;
     }
 
@@ -14,6 +14,7 @@
  * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
  * 02110-1301, USA.
  */
+#include <cstring>
 #include <exception>
 #include <functional> //hash
 
@@ -27,10 +28,80 @@
 
 namespace mgbubble{
 
+using explorer::config::json_writer;
+using explorer::config::write_compact;
+
 thread_local OStream HttpServ::out_;
 thread_local Tokeniser<'/'> HttpServ::uri_;
 thread_local int HttpServ::state_ = 0;
 
+// The longest a long-poll getwork is held before the current work is returned.
+constexpr double long_poll_seconds = 60.0;
+
+// Rpc commands run on this many threads, off the mongoose loop.
+constexpr size_t rpc_worker_threads = 4;
+
+// Requests beyond this many waiting for a worker are refused as busy.
+constexpr size_t rpc_max_queue = 1024;
+
+// A request not answered within this time is answered with a timeout.
+constexpr double rpc_timeout_seconds = 60.0;
+
+// The most requests accepted in one json-rpc 2.0 batch.
+constexpr size_t rpc_max_batch = 500;
+
+// Read-only queries that may run concurrently, each up to its own limit.
+// Every other method (wallet writes, mining control and the rest) runs one
+// at a time in the serial group, in arrival order, as on the mongoose loop.
+static const std::unordered_map<std::string, size_t> rpc_concurrent_methods {
+    { "getheight", rpc_worker_threads },
+    { "getinfo", rpc_worker_threads },
+    { "getmininginfo", rpc_worker_threads },
+    { "getpeerinfo", rpc_worker_threads },
+    { "getblock", rpc_worker_threads },
+    { "getblockheader", rpc_worker_threads },
+    { "fetchheaderext", rpc_worker_threads },
+    { "gettx", rpc_worker_threads },
+    { "getmemorypool", rpc_worker_threads },
+    { "getasset", rpc_worker_threads },
+    { "getwork", rpc_worker_threads },
+    { "validateaddress", rpc_worker_threads },
+    { "decoderawtx", rpc_worker_threads },
+    { "listtxs", 2 },
+    { "getbalance", 2 },
+    { "listbalances", 2 },
+    { "listassets", 2 },
+    { "getaccountasset", 2 },
+    { "getaddressasset", 2 },
+    { "getaddressetp", 2 },
+};
+
+constexpr auto rpc_serial_group = "";
+
+// Cached results are also dropped after this age, as not all of a result
+// (peers, hash rate, pools) is fixed by the chain tip.
+constexpr std::chrono::seconds rpc_cache_max_age{ 5 };
+
+// The most bytes of rendered results held by the cache.
+constexpr size_t rpc_cache_max_bytes = 64 * 1024 * 1024;
+
+static bool header_equals(string_view value, const char* expected)
+{
+    const auto size = std::strlen(expected);
+    return value.size() == size && mg_ncasecmp(value.data(), expected, size) == 0;
+}
+
+HttpServ::HttpServ(const char* webroot, libbitcoin::server::server_node &node, const std::string& srv_addr)
+    : MgServer(srv_addr), node_(node), workers_(rpc_worker_threads, rpc_max_queue, 1),
+    cache_(node.server_settings().rpc_cache_entries, rpc_cache_max_bytes, rpc_cache_max_age)
+{
+    document_root_ = webroot;
+    set_document_root(document_root_.c_str());
+
+    for (const auto& method : rpc_concurrent_methods)
+        workers_.set_limit(method.first, method.second);
+}
+
 void HttpServ::reset(HttpMessage& data) noexcept
 {
     state_ = 0;
@@ -57,82 +128,529 @@ void HttpServ::reset(HttpMessage& data) noexcept
 void HttpServ::rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_version)
 {
     reset(data);
+
+    auto call = std::make_shared<RpcCall>();
+    call->rpc_version = rpc_version;
+
+    // Keep-alive unless the client asks to close, or is http/1.0 and does not ask to keep.
+    const auto connection = data.header("Connection");
+    if (data.proto() == "HTTP/1.0")
+        call->close = !header_equals(connection, "keep-alive");
+    else
+        call->close = header_equals(connection, "close");
+
+    Json::Value root;
+    try {
+        Json::Reader reader;
+        const auto body = data.body();
+        if (!reader.parse(body.data(), body.data() + body.size(), root))
+            throw libbitcoin::explorer::jsonrpc_parse_error();
+
+        if (rpc_version == 2 && root.isArray()) {
+            submit_batch(nc, call, data, root);
+            return;
+        }
+
+        data.request_to_arg(root, rpc_version);
+        call->args.assign(data.argv(), data.argv() + data.argc());
+        call->params = root["params"];
+    }
+    catch (...) {
+        call->error = std::current_exception();
+    }
+    call->jsonrpc_id = data.jsonrpc_id();
+
+    submit_rpc(nc, call);
+}
+
+// Queue the call on its connection and hand the command to the workers.
+void HttpServ::submit_rpc(mg_connection& nc, RpcCallPtr call)
+{
+    call->nc = &nc;
+    call->deadline = mg_time() + rpc_timeout_seconds;
+    rpc_calls_[&nc].push_back(call);
+
+    dispatch_rpc(call);
+    flush_rpc_calls(nc);
+}
+
+// Queue a json-rpc 2.0 batch as one call, its elements run concurrently.
+void HttpServ::submit_batch(mg_connection& nc, RpcCallPtr call, const HttpMessage& data,
+    const Json::Value& requests)
+{
+    call->nc = &nc;
+    call->deadline = mg_time() + rpc_timeout_seconds;
+    rpc_calls_[&nc].push_back(call);
+
+    try {
+        if (requests.empty() || requests.size() > rpc_max_batch)
+            throw libbitcoin::explorer::jsonrpc_invalid_request();
+    }
+    catch (...) {
+        call->error = std::current_exception();
+        call->done = true;
+        flush_rpc_calls(nc);
+        return;
+    }
+
+    for (const auto& request : requests) {
+        auto item = std::make_shared<RpcCall>();
+        item->nc = &nc;
+        item->rpc_version = call->rpc_version;
+        item->batch_parent = call;
+
+        HttpMessage message(data.get());
+        try {
+            message.request_to_arg(request, call->rpc_version);
+            item->args.assign(message.argv(), message.argv() + message.argc());
+            item->params = request["params"];
+        }
+        catch (...) {
+            item->error = std::current_exception();
+        }
+        item->jsonrpc_id = message.jsonrpc_id();
+        call->batch.push_back(item);
+    }
+
+    for (auto& item : call->batch) {
+        dispatch_rpc(item);
+        if (!item->done)
+            ++call->pending;
+    }
+
+    call->done = (call->pending == 0);
+    flush_rpc_calls(nc);
+}
+
+// Hand the command to the workers, the call is done at once if it cannot run
+// or its result is cached.
+void HttpServ::dispatch_rpc(RpcCallPtr call)
+{
+    if (!call->error) {
+        const auto& method = call->args.empty() ? std::string() : call->args.front();
+
+        if (cache_.enabled() && !call->websocket && RpcCache::cacheable(method)) {
+            call->cache_key = RpcCache::key(call->rpc_version, call->args, call->params);
+            call->cache_generation = cache_.generation();
+            call->rendered = cache_.find(call->cache_key);
+            if (call->rendered) {
+                call->retcode = console_result::okay;
+                call->done = true;
+                return;
+            }
+        }
+
+        const auto group = rpc_concurrent_methods.count(method) ? method : rpc_serial_group;
+
+        if (!workers_.submit(group, [this, call]() { execute_rpc(call); })) {
+            libbitcoin::explorer::explorer_exception ex(1000, "server busy, try again later");
+            call->error = std::make_exception_ptr(ex);
+        }
+    }
+
+    call->done = !!call->error;
+}
+
+void HttpServ::abandon_rpc(RpcCall& call)
+{
+    call.abandoned = true;
+    for (auto& item : call.batch)
+        item->abandoned = true;
+}
+
+// Worker thread, the result is handed back to the mongoose loop.
+void HttpServ::execute_rpc(RpcCallPtr call)
+{
+    // Timed out or closed while waiting for a worker.
+    if (call->abandoned)
+        return;
+
+    auto retcode = console_result::failure;
+    Json::Value output;
+    std::exception_ptr error;
+
+    try {
+        if (call->rpc_version == 2 && !call->args.empty()) {
+            retcode = explorer::dispatch_command(call->args.front(), call->params,
+                output, node_, call->rpc_version);
+        }
+        else {
+            std::vector<const char*> argv;
+            for (const auto& arg : call->args)
+                argv.push_back(arg.c_str());
+
+            retcode = explorer::dispatch_command(static_cast<int>(argv.size()), argv.data(),
+                output, node_, call->rpc_version);
+        }
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+
+    // Render a cacheable result here, off the mongoose loop, once for all hits.
+    RpcCache::Rendered rendered;
+    if (!call->cache_key.empty() && !error && retcode == console_result::okay) {
+        try {
+            if (call->rpc_version == 1 && !output.isObject() && !output.isArray())
+                rendered = std::make_shared<const std::string>(output.asString());
+            else
+                rendered = std::make_shared<const std::string>(write_compact(output));
+
+            cache_.insert(call->cache_key, call->cache_generation, rendered);
+        }
+        catch (const std::exception& e) {
+            log::debug(LOG_HTTP) << "rpc result not cached: " << e.what();
+            rendered = nullptr;
+        }
+    }
+
+    spawn_to_mongoose([this, call, retcode, output, error, rendered](uint64_t) {
+        call->retcode = retcode;
+        call->output = output;
+        call->error = error;
+        call->rendered = rendered;
+        complete_rpc(call);
+    });
+}
+
+void HttpServ::complete_rpc(RpcCallPtr call)
+{
+    // The connection closed or the call timed out meanwhile.
+    if (call->abandoned)
+        return;
+
+    call->done = true;
+
+    const auto batch = call->batch_parent.lock();
+    if (batch) {
+        if (--batch->pending != 0)
+            return;
+
+        batch->done = true;
+    }
+
+    flush_rpc_calls(*call->nc);
+}
+
+// Answer the completed calls at the head of the connection in order.
+void HttpServ::flush_rpc_calls(mg_connection& nc)
+{
+    auto it = rpc_calls_.find(&nc);
+    if (it == rpc_calls_.end()) {
+        rearm_timer(nc);
+        return;
+    }
+
+    // A parked long-poll is answered first, responses stay in request order.
+    auto& calls = it->second;
+    while (!calls.empty() && calls.front()->done && long_polls_.count(&nc) == 0) {
+        const auto call = calls.front();
+        calls.pop_front();
+        rpc_respond(nc, *call);
+    }
+
+    if (calls.empty())
+        rpc_calls_.erase(it);
+
+    rearm_timer(nc);
+}
+
+// The connection timer fires at the earliest rpc or long-poll deadline.
+void HttpServ::rearm_timer(mg_connection& nc)
+{
+    double deadline = 0;
+
+    const auto calls = rpc_calls_.find(&nc);
+    if (calls != rpc_calls_.end() && !calls->second.empty())
+        deadline = calls->second.front()->deadline;
+
+    const auto poll = long_polls_.find(&nc);
+    if (poll != long_polls_.end() && (deadline == 0 || poll->second.deadline < deadline))
+        deadline = poll->second.deadline;
+
+    mg_set_timer(&nc, deadline);
+}
+
+// Answer the calls past their deadline with a timeout, their results are dropped.
+void HttpServ::expire_rpc_calls(mg_connection& nc)
+{
+    auto it = rpc_calls_.find(&nc);
+    if (it == rpc_calls_.end())
+        return;
+
+    const auto now = mg_time();
+    for (auto& call : it->second) {
+        if (call->done || call->deadline > now)
+            continue;
+
+        abandon_rpc(*call);
+        call->batch.clear();
+        call->done = true;
+        libbitcoin::explorer::explorer_exception ex(1000, "request timed out");
+        call->error = std::make_exception_ptr(ex);
+        workers_.timed_out();
+    }
+
+    flush_rpc_calls(nc);
+}
+
+void HttpServ::rpc_respond(mg_connection& nc, const RpcCall& call)
+{
+    if (call.websocket) {
+        ws_respond(nc, call);
+        return;
+    }
+
+    // Nothing is sent for a parked long-poll until it is resumed.
+    if (!call.error && call.batch.empty() && call.retcode == console_result::okay &&
+        park_long_poll(nc, call))
+        return;
+
+    if (call.close)
+        nc.flags |= MG_F_SEND_AND_CLOSE;
+
     StreamBuf buf{ nc.send_mbuf };
     out_.rdbuf(&buf);
     out_.reset(200, "OK");
-    try {
-        data.data_to_arg(rpc_version);
 
-        Json::Value jv_output;
-                
-        auto retcode = explorer::dispatch_command(data.argc(), const_cast<const char**>(data.argv()),
-            jv_output, node_, rpc_version);
+    if (!call.batch.empty()) {
+        json_writer writer(out_);
+        writer.begin_array();
+        for (const auto& item : call.batch)
+            rpc_response(writer, *item);
+        writer.end_array();
+
+        out_.setContentLength();
+        return;
+    }
 
-        if (retcode == console_result::failure) { // only orignal command
-            if (rpc_version == 1 && !jv_output.isObject() && !jv_output.isArray()) {
+    try {
+        if (call.error)
+            std::rethrow_exception(call.error);
+
+        const auto& jv_output = call.output;
+        if (call.retcode == console_result::failure) { // only orignal command
+            if (call.rpc_version == 1 && !jv_output.isObject() && !jv_output.isArray()) {
                 throw explorer::command_params_exception{ jv_output.asString() };
             }
-            throw explorer::command_params_exception{ jv_output.toStyledString() };
+            throw explorer::command_params_exception{ write_compact(jv_output) };
         }
 
-        if (retcode == console_result::okay) {
-            if (rpc_version == 1) {
-                if (jv_output.isObject() || jv_output.isArray())
-                    out_ << jv_output.toStyledString();
-                else
-                    out_ << jv_output.asString();
-            }
-            else if (rpc_version == 2) {
-                Json::Value jv_root;
-                jv_root["jsonrpc"] = "2.0";
-                jv_root["id"] = data.jsonrpc_id();
-                jv_root["result"] = jv_output;
-
-                out_ << jv_root.toStyledString();
-            }
+        if (call.retcode == console_result::okay) {
+            if (call.rendered)
+                rpc_rendered(*call.rendered, call.jsonrpc_id, call.rpc_version);
+            else
+                rpc_result(jv_output, call.jsonrpc_id, call.rpc_version);
         }
     }
     catch (const libbitcoin::explorer::explorer_exception& e) {
-        if (rpc_version == 1) {
-            out_ << e;
-        }
-        else if (rpc_version == 2) {
-            Json::Value root;
-            root["jsonrpc"] = "2.0";
-            root["id"] = data.jsonrpc_id();
-            root["error"]["code"] = (int32_t)e.code();
-            root["error"]["message"] = e.what();
-           
-            out_ << root.toStyledString();
-        }
+        rpc_error(e, call.jsonrpc_id, call.rpc_version);
     }
     catch (const std::exception& e) {
-        if (rpc_version == 1) {
-            libbitcoin::explorer::explorer_exception ex(1000, e.what());
-            out_ << ex;
-        }
-        else if (rpc_version == 2) {
-            Json::Value root;
-            root["jsonrpc"] = "2.0";
-            root["id"] = data.jsonrpc_id();
-            root["error"]["code"] = 1000;
-            root["error"]["message"] = e.what();
-
-            out_ << root.toStyledString();
+        libbitcoin::explorer::explorer_exception ex(1000, e.what());
+        rpc_error(ex, call.jsonrpc_id, call.rpc_version);
+    }
+    out_.setContentLength();
+}
+
+// Responses are written compactly, straight into the send buffer.
+void HttpServ::rpc_result(const Json::Value& jv_output, int64_t jsonrpc_id, uint8_t rpc_version)
+{
+    if (rpc_version == 1) {
+        if (jv_output.isObject() || jv_output.isArray())
+            json_writer(out_).value(jv_output);
+        else
+            out_ << jv_output.asString();
+    }
+    else if (rpc_version == 2) {
+        json_writer writer(out_);
+        writer.begin_object();
+        writer.member("id", jsonrpc_id);
+        writer.member("jsonrpc", "2.0");
+        writer.member("result", jv_output);
+        writer.end_object();
+    }
+}
+
+// The result was rendered by rpc_result's rules when it was cached.
+void HttpServ::rpc_rendered(const std::string& rendered, int64_t jsonrpc_id, uint8_t rpc_version)
+{
+    if (rpc_version == 1) {
+        out_ << rendered;
+    }
+    else if (rpc_version == 2) {
+        json_writer writer(out_);
+        writer.begin_object();
+        writer.member("id", jsonrpc_id);
+        writer.member("jsonrpc", "2.0");
+        writer.key("result").raw(rendered);
+        writer.end_object();
+    }
+}
+
+void HttpServ::rpc_error(const explorer::explorer_exception& e, int64_t jsonrpc_id, uint8_t rpc_version)
+{
+    if (rpc_version == 1) {
+        out_ << e;
+    }
+    else if (rpc_version == 2) {
+        json_writer writer(out_);
+        writer.begin_object();
+        writer.key("error").begin_object();
+        writer.member("code", (int32_t)e.code());
+        writer.member("message", e.what());
+        writer.end_object();
+        writer.member("id", jsonrpc_id);
+        writer.member("jsonrpc", "2.0");
+        writer.end_object();
+    }
+}
+
+// The json-rpc 2.0 response object of one batch element.
+void HttpServ::rpc_response(json_writer& writer, const RpcCall& call)
+{
+    auto failed = true;
+    int32_t code = 0;
+    std::string message;
+
+    try {
+        if (call.error)
+            std::rethrow_exception(call.error);
+
+        if (call.retcode == console_result::failure)
+            throw explorer::command_params_exception{ write_compact(call.output) };
+
+        failed = false;
+    }
+    catch (const libbitcoin::explorer::explorer_exception& e) {
+        code = (int32_t)e.code();
+        message = e.what();
+    }
+    catch (const std::exception& e) {
+        code = 1000;
+        message = e.what();
+    }
+
+    writer.begin_object();
+    if (failed) {
+        writer.key("error").begin_object();
+        writer.member("code", code);
+        writer.member("message", message);
+        writer.end_object();
+    }
+    writer.member("id", call.jsonrpc_id);
+    writer.member("jsonrpc", "2.0");
+    if (!failed && call.rendered)
+        writer.key("result").raw(*call.rendered);
+    else if (!failed)
+        writer.member("result", call.output);
+    writer.end_object();
+}
+
+// Park a getwork whose --longpoll header hash matches the work just returned.
+bool HttpServ::park_long_poll(mg_connection& nc, const RpcCall& call)
+{
+    const auto& args = call.args;
+    if (args.size() < 3 || args.front() != "getwork")
+        return false;
+
+    std::string longpoll;
+    for (size_t i = 1; i + 1 < args.size(); ++i) {
+        if (args[i] == "--longpoll" || args[i] == "-l") {
+            longpoll = args[i + 1];
+            break;
         }
     }
+
+    const auto& jv_output = call.output;
+    const auto& work = call.rpc_version == 1 ? jv_output["result"] : jv_output;
+    if (longpoll.empty() || !work.isArray() || work[0u].asString() != longpoll)
+        return false;
+
+    long_polls_[&nc] = LongPoll{ call.jsonrpc_id, call.rpc_version, call.close, mg_time() + long_poll_seconds };
+    rearm_timer(nc);
+    return true;
+}
+
+// Answer a parked getwork with the current (cached) work of the miner.
+void HttpServ::resume_long_poll(mg_connection& nc)
+{
+    auto it = long_polls_.find(&nc);
+    if (it == long_polls_.end())
+        return;
+
+    const auto poll = it->second;
+    long_polls_.erase(it);
+
+    if (poll.close)
+        nc.flags |= MG_F_SEND_AND_CLOSE;
+
+    StreamBuf buf{ nc.send_mbuf };
+    out_.rdbuf(&buf);
+    out_.reset(200, "OK");
+
+    std::string seed_hash;
+    std::string header_hash;
+    std::string boundary;
+    if (node_.miner().get_work(seed_hash, header_hash, boundary)) {
+        Json::Value work;
+        work.append(header_hash);
+        work.append(seed_hash);
+        work.append(boundary);
+
+        Json::Value jv_output;
+        if (poll.rpc_version == 1)
+            jv_output["result"] = work;
+        else
+            jv_output = work;
+
+        rpc_result(jv_output, poll.jsonrpc_id, poll.rpc_version);
+    }
+    else {
+        explorer::setting_required_exception ex{"Use command <setminingaccount> to set mining address."};
+        rpc_error(ex, poll.jsonrpc_id, poll.rpc_version);
+    }
     out_.setContentLength();
+
+    // Answer the requests pipelined behind the poll.
+    flush_rpc_calls(nc);
+}
+
+void HttpServ::resume_long_polls()
+{
+    std::vector<mg_connection*> parked;
+    for (const auto& poll : long_polls_)
+        parked.push_back(poll.first);
+
+    for (auto* nc : parked)
+        resume_long_poll(*nc);
 }
 
 void HttpServ::ws_request(mg_connection& nc, WebsocketMessage ws)
+{
+    auto call = std::make_shared<RpcCall>();
+    call->websocket = true;
+    try {
+        ws.data_to_arg();
+        call->args.assign(ws.argv(), ws.argv() + ws.argc());
+    }
+    catch (...) {
+        call->error = std::current_exception();
+    }
+
+    submit_rpc(nc, call);
+}
+
+void HttpServ::ws_respond(mg_connection& nc, const RpcCall& call)
 {
     Json::Value jv_output;
 
     try{
-        ws.data_to_arg();
+        if (call.error)
+            std::rethrow_exception(call.error);
 
-        console_result retcode = explorer::dispatch_command(ws.argc(), const_cast<const char**>(ws.argv()), jv_output, node_);
-        if (retcode != console_result::okay) {
+        jv_output = call.output;
+        if (call.retcode != console_result::okay) {
             throw explorer::command_params_exception(jv_output.asString());
         }
 
@@ -143,7 +661,7 @@ void HttpServ::ws_request(mg_connection& nc, WebsocketMessage ws)
     }
 
     if (jv_output.isObject() || jv_output.isArray())
-        send_frame(nc, jv_output.toStyledString());
+        send_frame(nc, write_compact(jv_output));
     else
         send_frame(nc, jv_output.asString());
 }
@@ -152,15 +670,27 @@ bool HttpServ::start()
 {
     if (!attach_notify())
         return false;
+    workers_.start();
     return base::start();
 }
 
+void HttpServ::stop()
+{
+    workers_.stop();
+    base::stop();
+}
+
 void HttpServ::spawn_to_mongoose(const std::function<void(uint64_t)>&& handler)
 {
     auto msg = std::make_shared<MgEvent>(std::move(handler));
     struct mg_event ev { msg->hook() };
-    if (!notify(ev))
+    if (!notify(ev)) {
         msg->unhook();
+
+        // The request is left to its timeout, which answers the client.
+        workers_.undelivered();
+        log::warning(LOG_HTTP) << "Failed to notify the http service thread, completion dropped.";
+    }
 }
 
 void HttpServ::run() {
@@ -168,12 +698,45 @@ void HttpServ::run() {
 
     node_.subscribe_stop([this](const libbitcoin::code& ec) { stop(); });
 
+    node_.miner().subscribe_work([this]() {
+        spawn_to_mongoose([this](uint64_t) { resume_long_polls(); });
+    });
+
+    // Cached results are keyed by the chain tip, any new block replaces it.
+    if (cache_.enabled()) {
+        node_.publications().subscribe(
+            [this](const libbitcoin::code& ec, bc::server::publication::ptr value) {
+                if (ec == (libbitcoin::code)libbitcoin::error::service_stopped)
+                    return false;
+                if (!ec && !value->blocks.empty())
+                    cache_.invalidate();
+                return true;
+            });
+    }
+
     base::run();
 
     log::info(LOG_HTTP) << "Http Service Stopped.";
 }
 
 void HttpServ::on_http_req_handler(struct mg_connection& nc, http_message& msg)
+{
+    route_http_request(nc, msg);
+
+    // Mongoose parses one request per receive, requests pipelined behind it in
+    // the same read would wait for more data. Move them to the connection queue.
+    auto& io = nc.recv_mbuf;
+    const auto end = msg.message.p + msg.message.len;
+    if (is_websocket(nc) || end < io.buf || end >= io.buf + io.len)
+        return;
+
+    const size_t tail = io.buf + io.len - end;
+    pipelined_[&nc].append(end, tail);
+    io.len -= tail;
+    parse_pipelined(nc);
+}
+
+void HttpServ::route_http_request(struct mg_connection& nc, http_message& msg)
 {
     if ((mg_ncasecmp(msg.uri.p, "/rpc/v2", 7) == 0) || (mg_ncasecmp(msg.uri.p, "/rpc/v2/", 8) == 0)) {
         rpc_request(nc, HttpMessage(&msg), 2); // v2 rpc
@@ -186,6 +749,54 @@ void HttpServ::on_http_req_handler(struct mg_connection& nc, http_message& msg)
     }
 }
 
+// Once a connection has queued requests, everything it receives is appended
+// to its queue ahead of mongoose, which then finds nothing to parse.
+void HttpServ::ev_handler_default(struct mg_connection* nc, int ev, void* ev_data)
+{
+    if (ev != MG_EV_RECV)
+        return;
+
+    auto it = pipelined_.find(nc);
+    if (it == pipelined_.end())
+        return;
+
+    auto& io = nc->recv_mbuf;
+    it->second.append(io.buf, io.len);
+    io.len = 0;
+    parse_pipelined(*nc);
+}
+
+// Handle the complete requests at the head of the connection queue.
+void HttpServ::parse_pipelined(struct mg_connection& nc)
+{
+    auto it = pipelined_.find(&nc);
+    if (it == pipelined_.end())
+        return;
+
+    auto& queue = it->second;
+    size_t used = 0;
+    while (!(nc.flags & (MG_F_SEND_AND_CLOSE | MG_F_CLOSE_IMMEDIATELY))) {
+        http_message msg;
+        const auto size = queue.size() - used;
+        const auto head = mg_parse_http(queue.data() + used, size, &msg, 1);
+        if (head < 0 || (head == 0 && size >= MG_MAX_HTTP_REQUEST_SIZE)) {
+            nc.flags |= MG_F_CLOSE_IMMEDIATELY;
+            break;
+        }
+
+        // Not yet fully buffered.
+        if (head == 0 || msg.message.len > size)
+            break;
+
+        route_http_request(nc, msg);
+        used += msg.message.len;
+    }
+
+    queue.erase(0, used);
+    if (queue.empty())
+        pipelined_.erase(it);
+}
+
 void HttpServ::on_notify_handler(struct mg_connection& nc, struct mg_event& ev)
 {
     static uint64_t api_call_counter = 0;
@@ -197,6 +808,32 @@ void HttpServ::on_notify_handler(struct mg_connection& nc, struct mg_event& ev)
     msg(++api_call_counter);
 }
 
+void HttpServ::on_timer_handler(struct mg_connection& nc)
+{
+    expire_rpc_calls(nc);
+
+    const auto poll = long_polls_.find(&nc);
+    if (poll != long_polls_.end() && poll->second.deadline <= mg_time())
+        resume_long_poll(nc);
+    else
+        rearm_timer(nc);
+}
+
+void HttpServ::on_close_handler(struct mg_connection& nc)
+{
+    long_polls_.erase(&nc);
+    pipelined_.erase(&nc);
+
+    auto it = rpc_calls_.find(&nc);
+    if (it == rpc_calls_.end())
+        return;
+
+    for (auto& call : it->second)
+        abandon_rpc(*call);
+
+    rpc_calls_.erase(it);
+}
+
 void HttpServ::on_ws_handshake_done_handler(struct mg_connection& nc)
 {
     std::shared_ptr<struct mg_connection> con(&nc, [](struct mg_connection* ptr) { (void)(ptr); });
@@ -23,6 +23,18 @@
 namespace mgbubble {
 
 void HttpMessage::data_to_arg(uint8_t rpc_version) {
+    Json::Reader reader;
+    Json::Value root;
+    const char* begin = body().data();
+    const char* end = body().data() + body().size();
+    if (!reader.parse(begin, end, root)) {
+        throw libbitcoin::explorer::jsonrpc_parse_error();
+    }
+
+    request_to_arg(root, rpc_version);
+}
+
+void HttpMessage::request_to_arg(const Json::Value& root, uint8_t rpc_version) {
 
     auto vargv_to_argv = [this]() {
         // convert to char** argv
@@ -36,11 +48,7 @@ void HttpMessage::data_to_arg(uint8_t rpc_version) {
         argc_ = i;
     };
     
-    Json::Reader reader;
-    Json::Value root;
-    const char* begin = body().data();
-    const char* end = body().data() + body().size();
-    if (!reader.parse(begin, end, root) || !root.isObject()) {
+    if (!root.isObject()) {
         throw libbitcoin::explorer::jsonrpc_parse_error();
     }
 
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ * Copyright (C) 2013, 2016 Swirly Cloud Limited.
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#include <metaverse/mgbubble/RpcCache.hpp>
+
+#include <unordered_set>
+#include <metaverse/explorer/json_writer.hpp>
+
+namespace mgbubble {
+
+using namespace libbitcoin::explorer::config;
+
+RpcCache::RpcCache(size_t max_entries, size_t max_bytes, std::chrono::seconds max_age)
+    : max_entries_(max_entries),
+    max_bytes_(max_bytes),
+    max_age_(max_age)
+{
+}
+
+bool RpcCache::cacheable(const std::string& method)
+{
+    // Read-only, unauthenticated and fully determined by the chain tip.
+    static const std::unordered_set<std::string> methods{
+        "getheight",
+        "getinfo",
+        "getblockheader",
+        "getblock",
+        "getasset",
+        "listassets",
+        "getmininginfo"
+    };
+
+    return methods.count(method) != 0;
+}
+
+std::string RpcCache::key(uint8_t rpc_version, const std::vector<std::string>& args,
+    const Json::Value& params)
+{
+    std::string result(1, static_cast<char>('0' + rpc_version));
+
+    if (rpc_version == 1) {
+        // Arguments are separated by a character that cannot be typed in them.
+        for (const auto& arg : args) {
+            result += '\0';
+            result += arg;
+        }
+
+        return result;
+    }
+
+    result += '\0';
+    result += args.empty() ? std::string() : args.front();
+    result += '\0';
+    result += write_compact(params);
+    return result;
+}
+
+uint64_t RpcCache::generation() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return generation_;
+}
+
+RpcCache::Rendered RpcCache::find(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++misses_;
+        return nullptr;
+    }
+
+    if (it->second->expires <= clock::now()) {
+        erase(it->second);
+        ++misses_;
+        return nullptr;
+    }
+
+    lru_.splice(lru_.begin(), lru_, it->second);
+    ++hits_;
+    return it->second->rendered;
+}
+
+void RpcCache::insert(const std::string& key, uint64_t generation, Rendered rendered)
+{
+    if (!enabled() || !rendered || rendered->size() + key.size() > max_bytes_)
+        return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // The tip moved while the command executed, the result may be stale.
+    if (generation != generation_)
+        return;
+
+    auto it = index_.find(key);
+    if (it != index_.end())
+        erase(it->second);
+
+    lru_.push_front({ key, rendered, clock::now() + max_age_ });
+    index_.emplace(key, lru_.begin());
+    bytes_ += key.size() + rendered->size();
+
+    while (lru_.size() > max_entries_ || bytes_ > max_bytes_) {
+        erase(std::prev(lru_.end()));
+        ++evictions_;
+    }
+}
+
+void RpcCache::invalidate()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++generation_;
+    ++invalidations_;
+    index_.clear();
+    lru_.clear();
+    bytes_ = 0;
+}
+
+RpcCache::Statistics RpcCache::statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return { lru_.size(), bytes_, hits_, misses_, evictions_, invalidations_ };
+}
+
+void RpcCache::erase(Lru::iterator it)
+{
+    bytes_ -= it->key.size() + it->rendered->size();
+    index_.erase(it->key);
+    lru_.erase(it);
+}
+
+} // mgbubble
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS).
+ * Copyright (C) 2013, 2016 Swirly Cloud Limited.
+ *
+ * This program is free software; you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program; if
+ * not, write to the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+#include <metaverse/mgbubble/RpcWorkers.hpp>
+
+#include <algorithm>
+
+namespace mgbubble {
+
+RpcWorkers::RpcWorkers(size_t threads, size_t max_queue, size_t default_limit)
+    : threads_(std::max<size_t>(threads, 1)),
+    max_queue_(max_queue),
+    default_limit_(std::max<size_t>(default_limit, 1))
+{
+}
+
+RpcWorkers::~RpcWorkers()
+{
+    stop();
+}
+
+void RpcWorkers::set_limit(const std::string& group, size_t limit)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    limits_[group] = std::max<size_t>(limit, 1);
+}
+
+void RpcWorkers::start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!stopped_)
+        return;
+
+    stopped_ = false;
+    for (size_t i = 0; i < threads_; ++i)
+        workers_.emplace_back(&RpcWorkers::work, this);
+}
+
+// Queued jobs are dropped, their requests are abandoned with the server.
+void RpcWorkers::stop()
+{
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+        queue_.clear();
+        workers.swap(workers_);
+    }
+
+    condition_.notify_all();
+    for (auto& worker : workers)
+        if (worker.joinable())
+            worker.join();
+}
+
+bool RpcWorkers::submit(const std::string& group, Job job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_ || queue_.size() >= max_queue_) {
+            ++rejected_;
+            return false;
+        }
+
+        queue_.push_back(Pending{ group, std::move(job) });
+        queued_peak_ = std::max(queued_peak_, queue_.size());
+    }
+
+    condition_.notify_one();
+    return true;
+}
+
+void RpcWorkers::timed_out()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++timed_out_;
+}
+
+void RpcWorkers::undelivered()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++undelivered_;
+}
+
+RpcWorkers::Statistics RpcWorkers::statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return Statistics{ threads_, queue_.size(), queued_peak_, running_count_,
+        completed_, rejected_, timed_out_, undelivered_ };
+}
+
+size_t RpcWorkers::limit(const std::string& group) const
+{
+    const auto it = limits_.find(group);
+    return it == limits_.end() ? default_limit_ : it->second;
+}
+
+// The oldest job whose group is under its limit, called under the lock.
+RpcWorkers::Queue::iterator RpcWorkers::next_runnable()
+{
+    return std::find_if(queue_.begin(), queue_.end(), [this](const Pending& pending) {
+        const auto it = running_.find(pending.group);
+        const auto running = it == running_.end() ? 0 : it->second;
+        return running < limit(pending.group);
+    });
+}
+
+void RpcWorkers::work()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        auto it = queue_.end();
+        condition_.wait(lock, [this, &it]() {
+            return stopped_ || (it = next_runnable()) != queue_.end();
+        });
+
+        if (stopped_)
+            return;
+
+        auto pending = std::move(*it);
+        queue_.erase(it);
+        ++running_[pending.group];
+        ++running_count_;
+
+        lock.unlock();
+        try {
+            pending.job();
+        }
+        catch (...) {
+            // Jobs report their own failures, never lose the worker.
+        }
+        lock.lock();
+
+        if (--running_[pending.group] == 0)
+            running_.erase(pending.group);
+        --running_count_;
+        ++completed_;
+
+        // A job of the same group may now be runnable by another worker.
+        condition_.notify_all();
+    }
+}
+
+} // mgbubble
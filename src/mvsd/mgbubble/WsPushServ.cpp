@@ -15,9 +15,10 @@
 * 02110-1301, USA.
 */
 
+#include <algorithm>
 #include <thread>
 #include <sstream>
-#include <metaverse/explorer/json_helper.hpp>
+#include <metaverse/explorer/json_writer.hpp>
 #include <metaverse/mgbubble/WsPushServ.hpp>
 #include <metaverse/server/server_node.hpp>
 
@@ -35,6 +36,7 @@ namespace mgbubble {
 
     constexpr auto CH_BLOCK       = "block";
     constexpr auto CH_TRANSACTION = "tx";
+    constexpr auto CH_WORK        = "work";
 }
 namespace mgbubble {
 using namespace bc;
@@ -45,13 +47,13 @@ void WsPushServ::run() {
 
     node_.subscribe_stop([this](const libbitcoin::code& ec) { stop(); });
 
-    node_.subscribe_transaction_pool(
-        std::bind(&WsPushServ::handle_transaction_pool,
-            this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
-    
-    node_.subscribe_blockchain(
-        std::bind(&WsPushServ::handle_blockchain_reorganization,
-            this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
+    node_.publications().subscribe(
+        std::bind(&WsPushServ::handle_publication,
+            this, std::placeholders::_1, std::placeholders::_2));
+
+    node_.miner().subscribe_work([this]() {
+        spawn_to_mongoose([this](uint64_t) { notify_work(); });
+    });
 
     base::run();
 
@@ -75,148 +77,168 @@ void WsPushServ::spawn_to_mongoose(const std::function<void(uint64_t)>&& handler
         msg->unhook();
 }
 
-bool WsPushServ::handle_transaction_pool(const code& ec, const index_list&, message::transaction_message::ptr tx)
+bool WsPushServ::handle_publication(const code& ec, publication::ptr value)
 {
-    if (stopped())
+    if (stopped() || ec == (code)error::service_stopped)
         return false;
-    if (ec == (code)error::mock || ec == (code)error::service_stopped)
-        return true;
     if (ec)
     {
-        log::debug(NAME) << "Failure handling new transaction: " << ec.message();
+        log::debug(NAME) << "Failure handling publication: " << ec.message();
         return true;
     }
 
-    notify_transaction(0, null_hash, *tx);
-    return true;
-}
-
-bool WsPushServ::handle_blockchain_reorganization(const code& ec, uint64_t fork_point, const block_list& new_blocks, const block_list&)
-{
-    if (stopped())
-        return false;
-    if (ec == (code)error::mock || ec == (code)error::service_stopped)
-        return true;
-    if (ec)
+    // Without subscribers the publication is left unencoded.
     {
-        log::debug(NAME) << "Failure handling new block: " << ec.message();
-        return true;
+        std::lock_guard<std::mutex> guard(subscribers_lock_);
+        if (subscriptions_.empty())
+            return true;
     }
 
-    const auto fork_point32 = static_cast<uint32_t>(fork_point);
+    for (const auto& block : value->blocks)
+        for (const auto& tx : block->transactions)
+            notify_transaction(value->sequence, tx);
+
+    if (value->transaction)
+        notify_transaction(value->sequence, value->transaction);
 
-    notify_blocks(fork_point32, new_blocks);
     return true;
 }
 
-void WsPushServ::notify_blocks(uint32_t fork_point, const block_list& blocks)
+// The transaction json is encoded once by the publisher on first demand, members are sorted.
+static std::string transaction_frame(uint64_t sequence, const server::published_transaction& tx)
 {
-    if (stopped())
-        return;
-    
-    auto height = fork_point;
-
-    for (const auto block : blocks)
-        notify_block(height++, block);
+    std::string frame;
+    frame.reserve(tx.json().size() + 80);
+    frame.append("{\"channel\":\"").append(CH_TRANSACTION);
+    frame.append("\",\"event\":\"").append(EV_PUBLISH);
+    frame.append("\",\"result\":").append(tx.json());
+    frame.append(",\"sequence\":").append(std::to_string(sequence));
+    frame.append("}");
+    return frame;
 }
 
-void WsPushServ::notify_block(uint32_t height, const block::ptr block)
+// An address hash of 0 matches every transaction.
+static bool has_address(const server::published_transaction& tx, size_t addr_hash)
 {
-    if (stopped())
-        return;
-
-    const auto block_hash = block->header.hash();
+    if (addr_hash == 0)
+        return true;
 
-    for (const auto& tx : block->transactions)
-    {
-        const auto tx_hash = tx.hash();
+    for (const auto& address : tx.addresses())
+        if (std::hash<payment_address>()(address) == addr_hash)
+            return true;
 
-        notify_transaction(height, block_hash, tx);
-    }
+    return false;
 }
 
-void WsPushServ::notify_transaction(uint32_t height, const hash_digest& block_hash, const transaction& tx)
+void WsPushServ::notify_transaction(uint64_t sequence, published_transaction::ptr tx)
 {
-    if (stopped() || tx.outputs.empty())
+    if (stopped() || tx->tx().outputs.empty())
         return;
 
-    std::map<std::weak_ptr<mg_connection>, std::vector<size_t>, std::owner_less<std::weak_ptr<mg_connection>>> subscribers;
+    std::vector<size_t> tx_addrs;
+    for (const auto& address : tx->addresses())
+        tx_addrs.push_back(std::hash<payment_address>()(address));
+
+    // Look up only the connections subscribed to these addresses (or to all).
+    std::vector<Target> targets;
     {
         std::lock_guard<std::mutex> guard(subscribers_lock_);
-        if (subscribers_.size() == 0)
+        if (subscriptions_.empty())
             return;
-        for (auto& con : subscribers_)
+
+        const auto add = [this, &targets](mg_connection* nc) {
+            targets.push_back({ nc, subscriptions_[nc].connection_id });
+        };
+
+        for (auto* nc : all_subscribers_)
+            add(nc);
+
+        for (const auto addr_hash : tx_addrs)
         {
-            if (!con.first.expired())
-            {
-                subscribers.insert(con);
-            }
+            const auto it = address_subscribers_.find(addr_hash);
+            if (it == address_subscribers_.end())
+                continue;
+
+            for (auto* nc : it->second)
+                add(nc);
         }
-        if (subscribers.size() != subscribers_.size())
-            subscribers_ = subscribers;
     }
 
-    /* ---------- may has subscribers ---------- */
+    if (targets.empty())
+        return;
 
-    std::vector<size_t> tx_addrs;
-    for (const auto& input : tx.inputs)
-    {
-        const auto address = payment_address::extract(input.script);
-        if (address)
-            tx_addrs.push_back(std::hash<payment_address>()(address));
-    }
+    // A connection matched by several addresses is notified once.
+    std::sort(targets.begin(), targets.end());
+    targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
 
-    for (const auto& output : tx.outputs)
-    {
-        const auto address = payment_address::extract(output.script);
-        if (address)
-            tx_addrs.push_back(std::hash<payment_address>()(address));
-    }
+    log::info(NAME) << " ******** notify_transaction: height [" << tx->height << "]  ******** ";
 
-    std::vector<std::weak_ptr<mg_connection>> notify_cons;
-    for (auto& sub : subscribers)
-    {
-        auto& sub_addrs = sub.second;
-        bool bnotify = sub_addrs.size() == 0 ? true : std::any_of(sub_addrs.begin(), sub_addrs.end(), [&tx_addrs](size_t addr_hash) {
-            return tx_addrs.end() != std::find(tx_addrs.begin(), tx_addrs.end(), addr_hash);
-        });
+    auto rep = std::make_shared<std::string>(transaction_frame(sequence, *tx));
+    auto shared_targets = std::make_shared<std::vector<Target>>(std::move(targets));
+
+    spawn_to_mongoose([this, shared_targets, rep](uint64_t id) {
+        for (const auto& target : *shared_targets) {
+            // Skip connections closed (and addresses reused) since matching.
+            const auto it = connections_.find(target.nc);
+            if (it == connections_.end() || it->second != target.connection_id)
+                continue;
 
-        if (bnotify)
-            notify_cons.push_back(sub.first);
+            send_frame(*target.nc, *rep);
+        }
+    });
+}
+
+// Send the retained transactions published after the sequence to a new
+// subscriber. A publication in flight may also arrive live, the client
+// discards repeated sequences.
+void WsPushServ::replay_transactions(mg_connection& nc, uint64_t sequence, size_t addr_hash)
+{
+    publication::list values;
+    if (!node_.publications().replay(sequence, values))
+        send_bad_response(nc, "publications after the sequence are no longer retained.");
+
+    for (const auto& value : values) {
+        for (const auto& block : value->blocks)
+            for (const auto& tx : block->transactions)
+                if (has_address(*tx, addr_hash))
+                    send_frame(nc, transaction_frame(value->sequence, *tx));
+
+        if (value->transaction && has_address(*value->transaction, addr_hash))
+            send_frame(nc, transaction_frame(value->sequence, *value->transaction));
     }
-    if (notify_cons.size() == 0)
-        return;
+}
 
-    log::info(NAME) << " ******** notify_transaction: height [" << height << "]  ******** ";
+bool WsPushServ::work_response(Json::Value& root)
+{
+    std::string seed_hash;
+    std::string header_hash;
+    std::string boundary;
+    if (!node_.miner().get_work(seed_hash, header_hash, boundary))
+        return false;
+
+    Json::Value result;
+    result.append(header_hash);
+    result.append(seed_hash);
+    result.append(boundary);
 
-    Json::Value root;
     root["event"] = EV_PUBLISH;
-    root["channel"] = CH_TRANSACTION;
-    root["result"] = explorer::config::json_helper().prop_list(tx, height, true);
+    root["channel"] = CH_WORK;
+    root["result"] = result;
+    return true;
+}
 
-    auto rep = std::make_shared<std::string>(root.toStyledString());
+void WsPushServ::notify_work()
+{
+    if (stopped() || work_subscribers_.empty())
+        return;
 
-    for (auto& con : notify_cons)
-    {
-        auto shared_con = con.lock();
-        if (!shared_con)
-            continue;
+    Json::Value root;
+    if (!work_response(root))
+        return;
 
-        spawn_to_mongoose([this, shared_con, rep](uint64_t id) {
-            size_t active_connections = 0;
-            auto* mgr = &this->mg_mgr();
-            auto* notify_nc = shared_con.get();
-            for (auto* nc = mg_next(mgr, NULL); nc != NULL; nc = mg_next(mgr, nc)) {
-                if (!is_websocket(*nc) || is_listen_socket(*nc) || is_notify_socket(*nc))
-                    continue;
-                ++active_connections;
-                if (notify_nc == nc)
-                    send_frame(*nc, *rep);
-            }
-            if (active_connections != map_connections_.size())
-                refresh_connections();
-        });
-    }
+    const auto rep = explorer::config::write_compact(root);
+    for (auto* nc : work_subscribers_)
+        send_frame(*nc, rep);
 }
 
 void WsPushServ::send_bad_response(struct mg_connection& nc, const char* message, int code, Json::Value data)
@@ -230,7 +252,7 @@ void WsPushServ::send_bad_response(struct mg_connection& nc, const char* message
     root["event"]  = EV_MG_ERROR;
     root["result"] = result;
     
-    auto&& tmp = root.toStyledString();
+    auto&& tmp = explorer::config::write_compact(root);
     send_frame(nc, tmp.c_str(), tmp.size());
 }
 
@@ -240,27 +262,75 @@ void WsPushServ::send_response(struct mg_connection& nc, const std::string& even
     root["event"] = event;
     root["channel"] = channel;
 
-    auto&& tmp = root.toStyledString();
+    auto&& tmp = explorer::config::write_compact(root);
     send_frame(nc, tmp.c_str(), tmp.size());
 }
 
-void WsPushServ::refresh_connections()
+// Index an address subscription of the connection, 0 subscribes to all.
+// Called with subscribers_lock_ held.
+bool WsPushServ::subscribe_address(mg_connection& nc, uint64_t connection_id, size_t addr_hash)
+{
+    auto it = subscriptions_.find(&nc);
+    if (it == subscriptions_.end()) {
+        auto& subscription = subscriptions_[&nc];
+        subscription.connection_id = connection_id;
+        if (addr_hash == 0) {
+            all_subscribers_.insert(&nc);
+        }
+        else {
+            subscription.addresses.push_back(addr_hash);
+            address_subscribers_[addr_hash].insert(&nc);
+        }
+        return true;
+    }
+
+    auto& addresses = it->second.addresses;
+    if (addr_hash == 0) {
+        unindex_addresses(nc, addresses);
+        addresses.clear();
+        all_subscribers_.insert(&nc);
+        return true;
+    }
+
+    if (addresses.end() != std::find(addresses.begin(), addresses.end(), addr_hash))
+        return false;
+
+    // A subscriber to all narrows to the addresses it names, as before.
+    all_subscribers_.erase(&nc);
+    addresses.push_back(addr_hash);
+    address_subscribers_[addr_hash].insert(&nc);
+    return true;
+}
+
+// Called with subscribers_lock_ held.
+void WsPushServ::unsubscribe_addresses(mg_connection& nc)
+{
+    auto it = subscriptions_.find(&nc);
+    if (it == subscriptions_.end())
+        return;
+
+    unindex_addresses(nc, it->second.addresses);
+    all_subscribers_.erase(&nc);
+    subscriptions_.erase(it);
+}
+
+// Called with subscribers_lock_ held.
+void WsPushServ::unindex_addresses(mg_connection& nc, const std::vector<size_t>& addresses)
 {
-    auto* mgr = &mg_mgr();
-    std::unordered_map<void*, std::shared_ptr<mg_connection>> swap;
-    for (auto* nc = mg_next(mgr, NULL); nc != NULL; nc = mg_next(mgr, nc)) {
-        if (!is_websocket(*nc) || is_listen_socket(*nc) || is_notify_socket(*nc))
+    for (const auto addr_hash : addresses) {
+        auto it = address_subscribers_.find(addr_hash);
+        if (it == address_subscribers_.end())
             continue;
-        std::shared_ptr<struct mg_connection> con(nc, [](struct mg_connection* ptr) { (void)(ptr); });
-        swap.emplace(&nc, con);
+
+        it->second.erase(&nc);
+        if (it->second.empty())
+            address_subscribers_.erase(it);
     }
-    map_connections_.swap(swap);
 }
 
 void WsPushServ::on_ws_handshake_done_handler(struct mg_connection& nc)
 {
-    std::shared_ptr<struct mg_connection> con(&nc, [](struct mg_connection* ptr) { (void)(ptr); });
-    map_connections_.emplace(&nc, con);
+    connections_[&nc] = ++connection_sequence_;
 
     std::string version("{\"event\": \"version\", " "\"result\": \"" MVS_VERSION "\"}");
     send_frame(nc, version);
@@ -268,11 +338,11 @@ void WsPushServ::on_ws_handshake_done_handler(struct mg_connection& nc)
     std::stringstream ss;
     Json::Value root;
     Json::Value connections;
-    connections["connections"] = static_cast<uint64_t>(map_connections_.size());
+    connections["connections"] = static_cast<uint64_t>(connections_.size());
     root["event"] = EV_INFO;
     root["result"] = connections;
 
-    auto&& tmp = root.toStyledString();
+    auto&& tmp = explorer::config::write_compact(root);
     send_frame(nc, tmp);
 }
 
@@ -288,7 +358,8 @@ void WsPushServ::on_ws_frame_handler(struct mg_connection& nc, websocket_message
         const char* begin = (const char*)msg.data;
         const char* end = begin + msg.size;
         if (!reader.parse(begin, end, root) || !root.isObject() 
-            || !root["event"].isString() || !root["channel"].isString() || !root["address"].isString()) {
+            || !root["event"].isString() || !root["channel"].isString()
+            || (root["channel"].asString() != CH_WORK && !root["address"].isString())) {
             stringstream ss;
             ss << "parse request error, "
                 << reader.getFormattedErrorMessages();
@@ -306,46 +377,60 @@ void WsPushServ::on_ws_frame_handler(struct mg_connection& nc, websocket_message
             }
             else {
                 size_t hash_addr = short_addr.empty() ? 0 : std::hash<payment_address>()(pay_addr);
-                auto it = map_connections_.find(&nc);
-                if (it != map_connections_.end()) {
-                    std::lock_guard<std::mutex> guard(subscribers_lock_);
-                    std::weak_ptr<struct mg_connection> week_con(it->second);
-                    auto sub_it = subscribers_.find(week_con);
-                    if (sub_it != subscribers_.end()) {
-                        auto& sub_list = sub_it->second;
-                        if (hash_addr == 0) {
-                            sub_list.clear();
-                            send_response(nc, EV_SUBSCRIBED, channel);
-                        }
-                        else {
-                            if (sub_list.end() == std::find(sub_list.begin(), sub_list.end(), hash_addr)) {
-                                sub_list.push_back(hash_addr);
-                                send_response(nc, EV_SUBSCRIBED, channel);
-                            }
-                            else {
-                                send_bad_response(nc, "address already subscribed.");
-                            }
-                        }
+                auto it = connections_.find(&nc);
+                if (it != connections_.end()) {
+                    bool subscribed;
+                    {
+                        std::lock_guard<std::mutex> guard(subscribers_lock_);
+                        subscribed = subscribe_address(nc, it->second, hash_addr);
                     }
-                    else {
-                        if (hash_addr == 0)
-                            subscribers_.insert({ week_con, {} });
-                        else
-                            subscribers_.insert({ week_con, { hash_addr } });
+
+                    if (subscribed) {
                         send_response(nc, EV_SUBSCRIBED, channel);
+
+                        // Catch up from the last sequence the client has seen.
+                        if (root["sequence"].isUInt64())
+                            replay_transactions(nc, root["sequence"].asUInt64(), hash_addr);
                     }
+                    else
+                        send_bad_response(nc, "address already subscribed.");
                 }
                 else {
                     send_bad_response(nc, "connection lost.");
                 }
             }
         }
+        else if ((event == EV_SUBSCRIBE) && (channel == CH_WORK)) {
+            auto it = connections_.find(&nc);
+            if (it != connections_.end()) {
+                work_subscribers_.insert(&nc);
+                send_response(nc, EV_SUBSCRIBED, channel);
+
+                Json::Value work;
+                if (work_response(work))
+                    send_frame(nc, explorer::config::write_compact(work));
+            }
+            else {
+                send_bad_response(nc, "connection lost.");
+            }
+        }
+        else if ((event == EV_UNSUBSCRIBE) && (channel == CH_WORK)) {
+            auto it = connections_.find(&nc);
+            if (it != connections_.end()) {
+                work_subscribers_.erase(&nc);
+                send_response(nc, EV_UNSUBSCRIBED, channel);
+            }
+            else {
+                send_bad_response(nc, "no subscription.");
+            }
+        }
         else if ((event == EV_UNSUBSCRIBE) && (channel == CH_TRANSACTION)) {
-            auto it = map_connections_.find(&nc);
-            if (it != map_connections_.end()) {
-                std::lock_guard<std::mutex> guard(subscribers_lock_);
-                std::weak_ptr<struct mg_connection> week_con(it->second);
-                subscribers_.erase(week_con);
+            auto it = connections_.find(&nc);
+            if (it != connections_.end()) {
+                {
+                    std::lock_guard<std::mutex> guard(subscribers_lock_);
+                    unsubscribe_addresses(nc);
+                }
                 send_response(nc, EV_UNSUBSCRIBED, channel);
             }
             else {
@@ -366,7 +451,11 @@ void WsPushServ::on_close_handler(struct mg_connection& nc)
 {
     if (is_websocket(nc))
     {
-        map_connections_.erase(&nc);
+        connections_.erase(&nc);
+        work_subscribers_.erase(&nc);
+
+        std::lock_guard<std::mutex> guard(subscribers_lock_);
+        unsubscribe_addresses(nc);
     }
 }
 
@@ -36,11 +36,6 @@ StreamBuf::StreamBuf(mbuf& buf) throw(bad_alloc) : buf_(buf)
 
 StreamBuf::~StreamBuf() noexcept = default;
 
-void StreamBuf::reset() noexcept
-{
-  buf_.len = 0;
-}
-
 void StreamBuf::setContentLength(size_t pos, size_t len) noexcept
 {
   char* ptr{buf_.buf + pos};
@@ -75,20 +70,23 @@ OStream::~OStream() noexcept = default;
 
 void OStream::reset(int status, const char* reason,const char *content_type,const char *charset) noexcept
 {
-  rdbuf()->reset();
   mgbubble::reset(*this);
 
+  // Responses still queued on a keep-alive connection are kept, this one is appended behind them
+  // and its positions are recorded relative to where it begins.
+  begin_ = size();
+
   // Status-Line = HTTP-Version SP Status-Code SP Reason-Phrase CRLF. Use 10 space place-holder for
   // content length. RFC2616 states that field value MAY be preceded by any amount of LWS, though a
   // single SP is preferred.
   *this << "HTTP/1.1 " << status << ' ' << reason << "\r\nContent-Type: "<< content_type<<";charset="<<charset<<"\r\nContent-Length:           \r\n\r\n";
-  headSize_ = size();
+  headSize_ = size() - begin_;
   lengthAt_ = headSize_ - 4;
 }
 
 void OStream::setContentLength() noexcept
 {
-  rdbuf()->setContentLength(lengthAt_, size() - headSize_);
+  rdbuf()->setContentLength(begin_ + lengthAt_, size() - begin_ - headSize_);
 }
 
 } // mgbubble
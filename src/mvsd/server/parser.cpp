@@ -159,7 +159,7 @@ options_metadata parser::load_settings()
     (
         "network.protocol",
         value<uint32_t>(&configured.network.protocol),
-        "The network protocol version, defaults to 70012."
+        "The network protocol version, defaults to 70014."
     )
     (
         "network.identifier",
@@ -349,6 +349,11 @@ options_metadata parser::load_settings()
         value<std::string>(&configured.server.mongoose_listen),
         "The listening port for mongoose(Json-RPC), defaults to 127.0.0.1:8820."
     )
+    (
+        "server.rpc_cache_entries",
+        value<uint32_t>(&configured.server.rpc_cache_entries),
+        "The number of read-only Json-RPC results cached until the next block, defaults to 0 (disabled)."
+    )
     (
         "server.websocket_listen",
         value<std::string>(&configured.server.websocket_listen),
@@ -359,6 +364,11 @@ options_metadata parser::load_settings()
         value<uint16_t>(&configured.server.query_workers),
         "The number of query worker threads per endpoint, defaults to 1."
     )
+    (
+        "server.query_history_workers",
+        value<uint16_t>(&configured.server.query_history_workers),
+        "The number of threads per endpoint for history, stealth and validation queries, defaults to 2."
+    )
     (
         "server.heartbeat_interval_seconds",
         value<uint32_t>(&configured.server.heartbeat_interval_seconds),
@@ -374,6 +384,11 @@ options_metadata parser::load_settings()
         value<uint32_t>(&configured.server.subscription_limit),
         "The maximum number of subscriptions, defaults to 100000000."
     )
+    (
+        "server.publication_replay_limit",
+        value<uint32_t>(&configured.server.publication_replay_limit),
+        "The number of block and transaction publications retained for replay, defaults to 100."
+    )
     (
         "server.log_level",
         value<std::string>(&configured.server.log_level),
@@ -49,6 +49,7 @@ server_node::server_node(const configuration& configuration)
   : p2p_node(configuration),
     under_blockchain_sync_(true),
     configuration_(configuration),
+    publisher_(*this, configuration.server.publication_replay_limit),
     authenticator_(*this),
     secure_query_service_(authenticator_, *this, true),
     public_query_service_(authenticator_, *this, false),
@@ -91,6 +92,9 @@ void server_node::run(result_handler handler)
         return;
     }
 
+    // Publications are subscribed to the node ahead of their consumers.
+    publisher_.start();
+
     if (!rest_server_->start() || !push_server_->start())
     {
         log::error(LOG_SERVER) << "Http/Websocket server can not start.";
@@ -136,6 +140,7 @@ void server_node::handle_running(const code& ec, result_handler handler)
 bool server_node::stop()
 {
     // Suspend new work last so we can use work to clear subscribers.
+    publisher_.stop();
     return authenticator_.stop() && p2p_node::stop();
 }
 
@@ -143,7 +148,14 @@ bool server_node::stop()
 bool server_node::close()
 {
     // Invoke own stop to signal work suspension, then close node and join.
-    return server_node::stop() && p2p_node::close();
+    const auto result = server_node::stop() && p2p_node::close();
+
+    // History queries complete (as stopped) on their own threads.
+    secure_history_pool_.shutdown();
+    public_history_pool_.shutdown();
+    secure_history_pool_.join();
+    public_history_pool_.join();
+    return result;
 }
 
 /// Get miner.
@@ -152,6 +164,26 @@ consensus::miner& server_node::miner()
 	return miner_;
 }
 
+publisher& server_node::publications()
+{
+    return publisher_;
+}
+
+query_statistics& server_node::query_latency()
+{
+    return query_latency_;
+}
+
+mgbubble::RpcWorkers::Statistics server_node::rpc_statistics() const
+{
+    return rest_server_->rpc_statistics();
+}
+
+mgbubble::RpcCache::Statistics server_node::rpc_cache_statistics() const
+{
+    return rest_server_->rpc_cache_statistics();
+}
+
 // Notification.
 // ----------------------------------------------------------------------------
 
@@ -287,11 +319,15 @@ bool server_node::start_query_workers(bool secure)
 {
     auto& server = *this;
     const auto& settings = configuration_.server;
+    auto& history_pool = secure ? secure_history_pool_ : public_history_pool_;
+
+    // History queries of all workers of the endpoint share one pool.
+    history_pool.spawn(settings.query_history_workers);
 
     for (auto count = 0; count < settings.query_workers; ++count)
     {
         auto worker = std::make_shared<query_worker>(authenticator_,
-            server, secure);
+            server, secure, history_pool);
 
         if (!worker->start())
             return false;
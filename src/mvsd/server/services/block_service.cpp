@@ -51,10 +51,10 @@ block_service::block_service(zmq::authenticator& authenticator,
 // There is no unsubscribe so this class shouldn't be restarted.
 bool block_service::start()
 {
-    // Subscribe to blockchain reorganizations.
-    node_.subscribe_blockchain(
-        std::bind(&block_service::handle_reorganization,
-            this, _1, _2, _3, _4));
+    // Subscribe to blockchain reorganizations (as shared publications).
+    node_.publications().subscribe(
+        std::bind(&block_service::handle_publication,
+            this, _1, _2));
 
     return zmq::worker::start();
 }
@@ -144,15 +144,12 @@ bool block_service::unbind(zmq::socket& xpub, zmq::socket& xsub)
 // Publish (integral worker).
 // ----------------------------------------------------------------------------
 
-bool block_service::handle_reorganization(const code& ec, uint64_t fork_point,
-    const block_list& new_blocks, const block_list&)
+bool block_service::handle_publication(const code& ec,
+    publication::ptr value)
 {
     if (stopped() || ec == (code)error::service_stopped)
         return false;
 
-    if (ec == error::mock)
-    	return true;
-
     if (ec)
     {
         log::warning(LOG_SERVER)
@@ -162,16 +159,13 @@ bool block_service::handle_reorganization(const code& ec, uint64_t fork_point,
         return true;
     }
 
-    // Blockchain height is 64 bit but obelisk protocol is 32 bit.
-    BITCOIN_ASSERT(fork_point <= max_uint32);
-    const auto fork_point32 = static_cast<uint32_t>(fork_point);
+    if (!value->blocks.empty())
+        publish_blocks(value->blocks);
 
-    publish_blocks(fork_point32, new_blocks);
     return true;
 }
 
-void block_service::publish_blocks(uint32_t fork_point,
-    const block_list& blocks)
+void block_service::publish_blocks(const published_block::list& blocks)
 {
     if (stopped())
         return;
@@ -196,12 +190,8 @@ void block_service::publish_blocks(uint32_t fork_point,
         return;
     }
 
-    BITCOIN_ASSERT(blocks.size() <= max_uint32);
-    BITCOIN_ASSERT(fork_point < max_uint32 - blocks.size());
-    auto height = fork_point;
-
-    for (const auto block: blocks)
-        publish_block(publisher, height++, block);
+    for (const auto& block: blocks)
+        publish_block(publisher, *block);
 }
 
 // [ height:4 ]
@@ -209,8 +199,10 @@ void block_service::publish_blocks(uint32_t fork_point,
 // [ txs... ]
 // The payload for block publication is delimited within the zeromq message.
 // This is required for compatability and inconsistent with query payloads.
-void block_service::publish_block(zmq::socket& publisher, uint32_t height,
-    const block_ptr block)
+// The block is serialized once by the publisher, on first demand, for all
+// services.
+void block_service::publish_block(zmq::socket& publisher,
+    const published_block& block)
 {
     if (stopped())
         return;
@@ -218,8 +210,8 @@ void block_service::publish_block(zmq::socket& publisher, uint32_t height,
     const auto security = secure_ ? "secure" : "public";
 
     zmq::message broadcast;
-    broadcast.enqueue_little_endian(height);
-    broadcast.enqueue(block->to_data(false));
+    broadcast.enqueue_little_endian(block.height);
+    broadcast.enqueue(block.data());
     const auto ec = publisher.send(broadcast);
 
     if (ec == (code)error::service_stopped)
@@ -229,14 +221,14 @@ void block_service::publish_block(zmq::socket& publisher, uint32_t height,
     {
         log::warning(LOG_SERVER)
             << "Failed to publish " << security << " bloc ["
-            << encode_hash(block->header.hash()) << "] " << ec.message();
+            << encode_hash(block.hash) << "] " << ec.message();
         return;
     }
 
     // This isn't actually a request, should probably update settings.
     log::debug(LOG_SERVER)
         << "Published " << security << " block ["
-        << encode_hash(block->header.hash()) << "]";
+        << encode_hash(block.hash) << "]";
 }
 
 } // namespace server
@@ -52,10 +52,10 @@ transaction_service::transaction_service(zmq::authenticator& authenticator,
 // There is no unsubscribe so this class shouldn't be restarted.
 bool transaction_service::start()
 {
-    // Subscribe to transaction pool acceptances.
-    node_.subscribe_transaction_pool(
-        std::bind(&transaction_service::handle_transaction,
-            this, _1, _2, _3));
+    // Subscribe to transaction pool acceptances (as shared publications).
+    node_.publications().subscribe(
+        std::bind(&transaction_service::handle_publication,
+            this, _1, _2));
 
     return zmq::worker::start();
 }
@@ -146,17 +146,12 @@ bool transaction_service::unbind(zmq::socket& xpub, zmq::socket& xsub)
 // Publish (integral worker).
 // ----------------------------------------------------------------------------
 
-bool transaction_service::handle_transaction(const code& ec, const index_list&,
-    transaction_message::ptr tx)
+bool transaction_service::handle_publication(const code& ec,
+    publication::ptr value)
 {
     if (stopped() || ec == (code)error::service_stopped)
         return false;
 
-    if (ec == (code)error::mock)
-	{
-		return true;
-	}
-
     if (ec)
     {
         log::warning(LOG_SERVER)
@@ -166,12 +161,16 @@ bool transaction_service::handle_transaction(const code& ec, const index_list&,
         return true;
     }
 
-    publish_transaction(*tx);
+    if (value->transaction)
+        publish_transaction(*value->transaction);
+
     return true;
 }
 
 // [ tx... ]
-void transaction_service::publish_transaction(const transaction& tx)
+// The transaction is serialized once by the publisher, on first demand, for
+// all services.
+void transaction_service::publish_transaction(const published_transaction& tx)
 {
     if (stopped())
         return;
@@ -200,8 +199,7 @@ void transaction_service::publish_transaction(const transaction& tx)
         return;
 
     zmq::message broadcast;
-    bc::message::transaction_message tx_msg(tx);
-    broadcast.enqueue(tx_msg.to_data(bc::message::version::level::maximum));
+    broadcast.enqueue(tx.data());
     ec = publisher.send(broadcast);
 
     if (ec == (code)error::service_stopped)
@@ -211,14 +209,14 @@ void transaction_service::publish_transaction(const transaction& tx)
     {
         log::warning(LOG_SERVER)
             << "Failed to publish " << security << " transaction ["
-            << encode_hash(tx_msg.hash()) << "] " << ec.message();
+            << encode_hash(tx.hash()) << "] " << ec.message();
         return;
     }
 
     // This isn't actually a request, should probably update settings.
     log::debug(LOG_SERVER)
         << "Published " << security << " transaction ["
-        << encode_hash(tx_msg.hash()) << "]";
+        << encode_hash(tx.hash()) << "]";
 }
 
 } // namespace server
@@ -28,9 +28,12 @@ using namespace asio;
 
 settings::settings()
   : query_workers(1),
+    query_history_workers(2),
     heartbeat_interval_seconds(5),
     subscription_expiration_minutes(10),
     subscription_limit(100000000),
+    publication_replay_limit(100),
+    rpc_cache_entries(0),
     mongoose_listen("127.0.0.1:8820"),
     websocket_listen("127.0.0.1:8821"),
     administrator_required(false),
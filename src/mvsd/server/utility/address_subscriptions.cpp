@@ -0,0 +1,341 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse-server.
+ *
+ * metaverse-server is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/server/utility/address_subscriptions.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/server/messages/route.hpp>
+#include <metaverse/server/utility/address_key.hpp>
+
+namespace libbitcoin {
+namespace server {
+
+using namespace bc::asio;
+
+static duration at_least_one(const duration& value)
+{
+    return value.count() > 0 ? value : duration(1);
+}
+
+// A subscription expires once a full expiration period of ticks has passed.
+static size_t to_span(const duration& expiration, const duration& resolution)
+{
+    const auto ticks = (expiration + resolution - duration(1)) / resolution;
+    return std::max(static_cast<size_t>(ticks), size_t(1));
+}
+
+address_subscriptions::address_subscriptions(size_t limit,
+    const duration& expiration, const duration& resolution)
+  : limit_(limit),
+    resolution_(at_least_one(resolution)),
+    span_(to_span(expiration, resolution_)),
+    epoch_(steady_clock::now()),
+    stopped_(true),
+    tick_(0),
+    wheel_(span_ + 1)
+{
+}
+
+void address_subscriptions::start()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_upgrade();
+
+    if (stopped_)
+    {
+        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        mutex_.unlock_upgrade_and_lock();
+        stopped_ = false;
+        mutex_.unlock();
+        //---------------------------------------------------------------------
+        return;
+    }
+
+    mutex_.unlock_upgrade();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+address_subscriptions::list address_subscriptions::stop()
+{
+    list dropped;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    if (!stopped_)
+    {
+        stopped_ = true;
+        dropped.reserve(index_.size());
+
+        for (const auto& entry: index_)
+            dropped.push_back(entry.second);
+
+        // The index keys reference the dropped subscriptions, clear it first.
+        index_.clear();
+        root_.subscriptions.clear();
+        root_.children[0].reset();
+        root_.children[1].reset();
+
+        for (auto& slot: wheel_)
+            slot.clear();
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return dropped;
+}
+
+bool address_subscriptions::subscribe(const route& reply_to, uint32_t id,
+    const binary& prefix_filter)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_upgrade();
+
+    if (!stopped_)
+    {
+        const auto it = index_.find(address_key(reply_to, prefix_filter));
+
+        if (it != index_.end())
+        {
+            const auto existing = it->second;
+            //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            mutex_.unlock_upgrade_and_lock();
+            unschedule(existing);
+            schedule(existing);
+            mutex_.unlock();
+            //-----------------------------------------------------------------
+            return true;
+        }
+        else if (limit_ == 0 || index_.size() < limit_)
+        {
+            const auto created = std::make_shared<subscription>(
+                subscription{ reply_to, id, prefix_filter, 0, 0 });
+            //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            mutex_.unlock_upgrade_and_lock();
+            insert(created);
+            mutex_.unlock();
+            //-----------------------------------------------------------------
+            return true;
+        }
+    }
+
+    mutex_.unlock_upgrade();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Limit exceeded and stopped share the same result.
+    return false;
+}
+
+address_subscriptions::ptr address_subscriptions::unsubscribe(
+    const route& reply_to, const binary& prefix_filter)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_upgrade();
+
+    if (!stopped_)
+    {
+        const auto it = index_.find(address_key(reply_to, prefix_filter));
+
+        if (it != index_.end())
+        {
+            const auto existing = it->second;
+            //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+            mutex_.unlock_upgrade_and_lock();
+            remove(existing);
+            mutex_.unlock();
+            //-----------------------------------------------------------------
+            return existing;
+        }
+    }
+
+    mutex_.unlock_upgrade();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return nullptr;
+}
+
+address_subscriptions::list address_subscriptions::match(
+    const binary& field) const
+{
+    list matches;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+
+    // Every node on the path of the field is a prefix of the field.
+    auto current = &root_;
+
+    for (binary::size_type depth = 0; current != nullptr; ++depth)
+    {
+        matches.insert(matches.end(), current->subscriptions.begin(),
+            current->subscriptions.end());
+
+        if (depth == field.size())
+            break;
+
+        current = current->children[field[depth] ? 1 : 0].get();
+    }
+
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return matches;
+}
+
+address_subscriptions::list address_subscriptions::expire()
+{
+    list expired;
+    const auto target = current_tick();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_upgrade();
+
+    if (stopped_ || target <= tick_)
+    {
+        mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return expired;
+    }
+
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    mutex_.unlock_upgrade_and_lock();
+
+    // A lagging tick visits each slot at most once. A slot may also hold
+    // subscriptions a whole wheel later, these remain until their turn.
+    const auto slots = wheel_.size();
+    const auto steps = std::min(target - tick_, slots);
+
+    for (size_t step = 1; step <= steps; ++step)
+        for (const auto& entry: wheel_[(tick_ + step) % slots])
+            if (entry->deadline <= target)
+                expired.push_back(entry);
+
+    for (const auto& entry: expired)
+        remove(entry);
+
+    tick_ = target;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return expired;
+}
+
+size_t address_subscriptions::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    const auto count = index_.size();
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return count;
+}
+
+// private
+// ----------------------------------------------------------------------------
+// These require the exclusive lock.
+
+size_t address_subscriptions::current_tick() const
+{
+    return static_cast<size_t>((steady_clock::now() - epoch_) / resolution_);
+}
+
+void address_subscriptions::schedule(const ptr& subscription)
+{
+    subscription->deadline = current_tick() + span_;
+    wheel_[subscription->deadline % wheel_.size()].insert(subscription);
+}
+
+void address_subscriptions::unschedule(const ptr& subscription)
+{
+    wheel_[subscription->deadline % wheel_.size()].erase(subscription);
+}
+
+void address_subscriptions::insert(const ptr& subscription)
+{
+    const auto& filter = subscription->prefix_filter;
+    auto current = &root_;
+
+    for (binary::size_type depth = 0; depth < filter.size(); ++depth)
+    {
+        auto& child = current->children[filter[depth] ? 1 : 0];
+
+        if (!child)
+            child.reset(new node);
+
+        current = child.get();
+    }
+
+    current->subscriptions.push_back(subscription);
+
+    // The key references the members of the subscription it maps to.
+    index_.emplace(address_key(subscription->reply_to, filter), subscription);
+    schedule(subscription);
+}
+
+void address_subscriptions::remove(const ptr& subscription)
+{
+    const auto& filter = subscription->prefix_filter;
+    std::vector<node*> path{ &root_ };
+    path.reserve(filter.size() + 1);
+
+    for (binary::size_type depth = 0; depth < filter.size(); ++depth)
+    {
+        const auto child = path.back()->children[filter[depth] ? 1 : 0].get();
+        BITCOIN_ASSERT(child != nullptr);
+        path.push_back(child);
+    }
+
+    auto& entries = path.back()->subscriptions;
+    entries.erase(std::remove(entries.begin(), entries.end(), subscription),
+        entries.end());
+
+    // Prune the branch back to the deepest node that is still in use.
+    for (auto depth = filter.size(); depth > 0; --depth)
+    {
+        const auto leaf = path[depth];
+
+        if (!leaf->subscriptions.empty() || leaf->children[0] ||
+            leaf->children[1])
+            break;
+
+        path[depth - 1]->children[filter[depth - 1] ? 1 : 0].reset();
+    }
+
+    unschedule(subscription);
+    index_.erase(address_key(subscription->reply_to, filter));
+}
+
+} // namespace server
+} // namespace libbitcoin
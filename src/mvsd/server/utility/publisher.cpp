@@ -0,0 +1,304 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse-server.
+ *
+ * metaverse-server is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/server/utility/publisher.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/explorer/json_helper.hpp>
+#include <metaverse/explorer/json_writer.hpp>
+#include <metaverse/server/server_node.hpp>
+
+namespace libbitcoin {
+namespace server {
+
+#define NAME "publisher"
+
+using namespace std::placeholders;
+using namespace bc::chain;
+using namespace bc::wallet;
+
+publisher::publisher(server_node& node, size_t replay_limit)
+  : node_(node),
+    subscriber_(std::make_shared<subscriber>(node.thread_pool(), NAME)),
+    sequence_(0),
+    retained_(replay_limit)
+{
+}
+
+// There is no unsubscribe so this class shouldn't be restarted.
+void publisher::start()
+{
+    subscriber_->start();
+
+    node_.subscribe_blockchain(
+        std::bind(&publisher::handle_reorganization,
+            this, _1, _2, _3, _4));
+
+    node_.subscribe_transaction_pool(
+        std::bind(&publisher::handle_transaction_pool,
+            this, _1, _2, _3));
+}
+
+void publisher::stop()
+{
+    subscriber_->stop();
+    subscriber_->invoke(error::service_stopped, nullptr);
+}
+
+void publisher::subscribe(handler handler)
+{
+    subscriber_->subscribe(handler, error::service_stopped, nullptr);
+}
+
+uint64_t publisher::sequence() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return sequence_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool publisher::replay(uint64_t sequence, publication::list& out) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (sequence >= sequence_)
+        return true;
+
+    for (const auto& value: retained_)
+        if (value->sequence > sequence)
+            out.push_back(value);
+
+    // Complete if the next publication after the sequence is retained.
+    return !retained_.empty() && retained_.front()->sequence <= sequence + 1;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Handlers.
+// ----------------------------------------------------------------------------
+
+bool publisher::handle_reorganization(const code& ec, uint64_t fork_point,
+    const block_list& new_blocks, const block_list&)
+{
+    if (ec == (code)error::service_stopped)
+    {
+        subscriber_->relay(ec, nullptr);
+        return false;
+    }
+
+    if (ec == (code)error::mock)
+        return true;
+
+    if (ec)
+    {
+        log::warning(LOG_SERVER)
+            << "Failure handling new block: " << ec.message();
+
+        // Don't let a failure here prevent prevent future notifications.
+        return true;
+    }
+
+    // Blockchain height is 64 bit but obelisk protocol is 32 bit.
+    BITCOIN_ASSERT(fork_point <= max_uint32);
+    BITCOIN_ASSERT(new_blocks.size() <= max_uint32);
+    const auto fork_point32 = static_cast<uint32_t>(fork_point);
+
+    auto value = std::make_shared<publication>();
+    value->fork_point = fork_point32;
+    value->blocks.reserve(new_blocks.size());
+    auto height = fork_point32;
+
+    for (const auto& block: new_blocks)
+        value->blocks.push_back(encode(height++, block));
+
+    publish(value);
+    return true;
+}
+
+bool publisher::handle_transaction_pool(const code& ec, const index_list&,
+    bc::message::transaction_message::ptr tx)
+{
+    if (ec == (code)error::service_stopped)
+    {
+        subscriber_->relay(ec, nullptr);
+        return false;
+    }
+
+    if (ec == (code)error::mock)
+        return true;
+
+    if (ec)
+    {
+        log::warning(LOG_SERVER)
+            << "Failure handling new transaction: " << ec.message();
+
+        // Don't let a failure here prevent future notifications.
+        return true;
+    }
+
+    auto value = std::make_shared<publication>();
+    value->fork_point = 0;
+    value->transaction = encode(tx);
+
+    publish(value);
+    return true;
+}
+
+// Encoding.
+// ----------------------------------------------------------------------------
+
+published_block::ptr publisher::encode(uint32_t height,
+    block::ptr block) const
+{
+    auto value = std::make_shared<published_block>();
+    value->height = height;
+    value->hash = block->header.hash();
+    value->block = block;
+    value->transactions.reserve(block->transactions.size());
+
+    BITCOIN_ASSERT(block->transactions.size() <= max_uint32);
+    const auto count = static_cast<uint32_t>(block->transactions.size());
+
+    for (uint32_t index = 0; index < count; ++index)
+        value->transactions.push_back(encode(height, value->hash, block,
+            index));
+
+    return value;
+}
+
+published_transaction::ptr publisher::encode(uint32_t height,
+    const hash_digest& block_hash, block::ptr block, uint32_t index) const
+{
+    auto value = std::make_shared<published_transaction>();
+    value->height = height;
+    value->block_hash = block_hash;
+    value->block = block;
+    value->index = index;
+    return value;
+}
+
+published_transaction::ptr publisher::encode(
+    bc::message::transaction_message::ptr tx) const
+{
+    auto value = std::make_shared<published_transaction>();
+    value->height = 0;
+    value->block_hash = null_hash;
+    value->index = 0;
+    value->pool_transaction = tx;
+    return value;
+}
+
+void publisher::publish(std::shared_ptr<publication> value)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    value->sequence = ++sequence_;
+    retained_.push_back(value);
+
+    // The relay is ordered, so subscribers receive sequence order.
+    subscriber_->relay(error::success, value);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Published values.
+// ----------------------------------------------------------------------------
+
+const data_chunk& published_block::data() const
+{
+    std::call_once(data_once_, [this]()
+    {
+        data_ = block->to_data(false);
+    });
+
+    return data_;
+}
+
+const hash_digest& published_transaction::hash() const
+{
+    std::call_once(hash_once_, [this]()
+    {
+        hash_ = tx().hash();
+    });
+
+    return hash_;
+}
+
+const data_chunk& published_transaction::data() const
+{
+    std::call_once(data_once_, [this]()
+    {
+        data_ = tx().to_data();
+    });
+
+    return data_;
+}
+
+// see data_base::push_inputs and data_base::push_outputs
+const std::vector<payment_address>& published_transaction::addresses() const
+{
+    std::call_once(addresses_once_, [this]()
+    {
+        const auto& transaction = tx();
+
+        for (const auto& input: transaction.inputs)
+        {
+            const auto address = payment_address::extract(input.script);
+
+            if (address)
+                addresses_.push_back(address);
+        }
+
+        for (const auto& output: transaction.outputs)
+        {
+            const auto address = payment_address::extract(output.script);
+
+            if (address)
+                addresses_.push_back(address);
+        }
+    });
+
+    return addresses_;
+}
+
+const std::string& published_transaction::json() const
+{
+    std::call_once(json_once_, [this]()
+    {
+        std::ostringstream stream;
+        explorer::config::json_writer writer(stream);
+        explorer::config::json_helper().prop_list(writer, tx(), height, true);
+        json_ = stream.str();
+    });
+
+    return json_;
+}
+
+} // namespace server
+} // namespace libbitcoin
@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse-server.
+ *
+ * metaverse-server is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/server/utility/query_statistics.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace server {
+
+static size_t to_bucket(uint64_t microseconds)
+{
+    size_t bucket = 0;
+
+    // The number of significant bits, so zero and one share no bucket.
+    while (microseconds != 0 && bucket < query_statistics::buckets - 1)
+    {
+        microseconds >>= 1;
+        ++bucket;
+    }
+
+    return bucket;
+}
+
+query_statistics::histogram::histogram(bool heavy)
+  : heavy(heavy), total(0), maximum(0)
+{
+    for (auto& count: counts)
+        count.store(0);
+}
+
+void query_statistics::attach(const std::string& command, bool heavy)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_upgrade();
+
+    if (histograms_.find(command) == histograms_.end())
+    {
+        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        mutex_.unlock_upgrade_and_lock();
+        histograms_.emplace(command,
+            std::unique_ptr<histogram>(new histogram(heavy)));
+        mutex_.unlock();
+        //---------------------------------------------------------------------
+        return;
+    }
+
+    mutex_.unlock_upgrade();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void query_statistics::record(const std::string& command,
+    const asio::duration& latency)
+{
+    const auto elapsed = std::chrono::duration_cast<asio::microseconds>(
+        latency).count();
+    const auto microseconds = static_cast<uint64_t>(std::max(elapsed,
+        decltype(elapsed)(0)));
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    // Histograms are never removed, so the counters are updated in place.
+    const auto it = histograms_.find(command);
+
+    if (it == histograms_.end())
+        return;
+
+    auto& value = *it->second;
+    value.counts[to_bucket(microseconds)].fetch_add(1);
+    value.total.fetch_add(microseconds);
+
+    auto maximum = value.maximum.load();
+    while (microseconds > maximum &&
+        !value.maximum.compare_exchange_weak(maximum, microseconds));
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+query_statistics::list query_statistics::snapshot() const
+{
+    list methods;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    methods.reserve(histograms_.size());
+
+    for (const auto& entry: histograms_)
+    {
+        const auto& value = *entry.second;
+        uint64_t counts[buckets];
+        uint64_t count = 0;
+
+        for (size_t bucket = 0; bucket < buckets; ++bucket)
+        {
+            counts[bucket] = value.counts[bucket].load();
+            count += counts[bucket];
+        }
+
+        const auto maximum = value.maximum.load();
+        const auto mean = count == 0 ? 0 : value.total.load() / count;
+
+        methods.push_back(
+        {
+            entry.first,
+            value.heavy,
+            count,
+            mean,
+            percentile(counts, count, maximum, 50),
+            percentile(counts, count, maximum, 99),
+            maximum
+        });
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    return methods;
+}
+
+// The upper bound of the bucket holding the percentile, capped by the
+// maximum (which also bounds the open last bucket).
+uint64_t query_statistics::percentile(const uint64_t (&counts)[buckets],
+    uint64_t count, uint64_t maximum, size_t percent)
+{
+    if (count == 0)
+        return 0;
+
+    const auto rank = (count * percent + 99) / 100;
+    uint64_t seen = 0;
+
+    for (size_t bucket = 0; bucket < buckets - 1; ++bucket)
+    {
+        seen += counts[bucket];
+
+        if (seen >= rank)
+            return std::min(uint64_t(1) << bucket, maximum);
+    }
+
+    return maximum;
+}
+
+} // namespace server
+} // namespace libbitcoin
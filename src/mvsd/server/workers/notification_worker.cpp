@@ -59,14 +59,18 @@ notification_worker::notification_worker(zmq::authenticator& authenticator,
     settings_(node.server_settings()),
     node_(node),
     authenticator_(authenticator),
-    payment_subscriber_(std::make_shared<payment_subscriber>(
-        node.thread_pool(), settings_.subscription_limit, NAME "_payment")),
-    stealth_subscriber_(std::make_shared<stealth_subscriber>(
-        node.thread_pool(), settings_.subscription_limit, NAME "_stealth")),
-    address_subscriber_(std::make_shared<address_subscriber>(
-        node.thread_pool(), settings_.subscription_limit, NAME "_address")),
+    payment_subscriptions_(settings_.subscription_limit,
+        settings_.subscription_expiration(),
+        settings_.subscription_expiration() / purge_interval_ratio),
+    stealth_subscriptions_(settings_.subscription_limit,
+        settings_.subscription_expiration(),
+        settings_.subscription_expiration() / purge_interval_ratio),
+    address_subscriptions_(settings_.subscription_limit,
+        settings_.subscription_expiration(),
+        settings_.subscription_expiration() / purge_interval_ratio),
     penetration_subscriber_(std::make_shared<penetration_subscriber>(
-        node.thread_pool(), settings_.subscription_limit, NAME "_penetration"))
+        node.thread_pool(), settings_.subscription_limit, NAME "_penetration")),
+    dispatch_(node.thread_pool(), NAME "_dispatch")
 {
 }
 
@@ -74,25 +78,18 @@ notification_worker::notification_worker(zmq::authenticator& authenticator,
 bool notification_worker::start()
 {
     // v2/v3 (deprecated)
-    payment_subscriber_->start();
-    stealth_subscriber_->start();
+    payment_subscriptions_.start();
+    stealth_subscriptions_.start();
 
     // v3
-    address_subscriber_->start();
+    address_subscriptions_.start();
     penetration_subscriber_->start();
 
-    if(settings_.block_service_enabled)
-    {
-		// Subscribe to blockchain reorganizations.
-		node_.subscribe_blockchain(
-			std::bind(&notification_worker::handle_blockchain_reorganization,
-				this, _1, _2, _3, _4));
-    }
-
-    // Subscribe to transaction pool acceptances.
-    node_.subscribe_transaction_pool(
-        std::bind(&notification_worker::handle_transaction_pool,
-            this, _1, _2, _3));
+    // Subscribe to blockchain reorganizations and transaction pool
+    // acceptances (as shared publications).
+    node_.publications().subscribe(
+        std::bind(&notification_worker::handle_publication,
+            this, _1, _2));
 
     // Subscribe to all inventory messages from all peers.
     node_.subscribe<bc::message::inventory>(
@@ -108,15 +105,11 @@ bool notification_worker::stop()
     static const auto code = error::channel_stopped;
 
     // v2/v3 (deprecated)
-    payment_subscriber_->stop();
-    payment_subscriber_->invoke(code, {}, 0, {}, {});
-
-    stealth_subscriber_->stop();
-    stealth_subscriber_->invoke(code, 0, 0, {}, {});
+    send_error(payment_subscriptions_.stop(), address_update, code);
+    send_error(stealth_subscriptions_.stop(), address_stealth, code);
 
     // v3
-    address_subscriber_->stop();
-    address_subscriber_->invoke(code, {}, 0, {}, {});
+    send_error(address_subscriptions_.stop(), address_update2, code);
 
     penetration_subscriber_->stop();
     penetration_subscriber_->invoke(code, 0, {}, {});
@@ -155,7 +148,7 @@ int32_t notification_worker::purge_interval_milliseconds() const
 {
     const int64_t minutes = settings_.subscription_expiration_minutes;
     const int64_t milliseconds = minutes * 60 * 1000 / purge_interval_ratio;
-    const auto capped = std::max(milliseconds, static_cast<int64_t>(max_int32));
+    const auto capped = std::min(milliseconds, static_cast<int64_t>(max_int32));
     return static_cast<int32_t>(capped);
 }
 
@@ -199,17 +192,17 @@ bool notification_worker::disconnect(socket& router)
 // Pruning.
 // ----------------------------------------------------------------------------
 
-// Signal expired subscriptions to self-remove.
+// Advance the expiry wheels and signal expired subscriptions.
 void notification_worker::purge()
 {
     static const auto code = error::channel_timeout;
 
     // v2/v3 (deprecated)
-    payment_subscriber_->purge(code, {}, 0, {}, {});
-    stealth_subscriber_->purge(code, 0, 0, {}, {});
+    send_error(payment_subscriptions_.expire(), address_update, code);
+    send_error(stealth_subscriptions_.expire(), address_stealth, code);
 
     // v3
-    address_subscriber_->purge(code, {}, 0, {}, {});
+    send_error(address_subscriptions_.expire(), address_update2, code);
     penetration_subscriber_->purge(code, 0, {}, {});
 }
 
@@ -247,9 +240,17 @@ void notification_worker::send(const route& reply_to,
             << notification.route().display() << " " << ec.message();
 }
 
+void notification_worker::send_error(const subscription_list& subscriptions,
+    const std::string& command, const code& ec)
+{
+    const auto payload = message::to_bytes(ec);
+
+    for (const auto& subscription: subscriptions)
+        send(subscription->reply_to, command, subscription->id, payload);
+}
+
 void notification_worker::send_payment(const route& reply_to, uint32_t id,
-    const wallet::payment_address& address, uint32_t height,
-    const hash_digest& block_hash, const chain::transaction& tx)
+    const wallet::payment_address& address, const published_transaction& tx)
 {
     // [ address.version:1 ]
     // [ address.hash:20 ]
@@ -260,17 +261,16 @@ void notification_worker::send_payment(const route& reply_to, uint32_t id,
     {
         to_array(address.version()),
         address.hash(),
-        to_little_endian(height),
-        block_hash,
-        tx.to_data()
+        to_little_endian(tx.height),
+        tx.block_hash,
+        tx.data()
     });
     
     send(reply_to, address_update, id, payload);
 }
 
 void notification_worker::send_stealth(const route& reply_to, uint32_t id,
-    uint32_t prefix, uint32_t height, const hash_digest& block_hash,
-    const chain::transaction& tx)
+    uint32_t prefix, const published_transaction& tx)
 {
     // [ prefix:4 ]
     // [ height:4 ]
@@ -279,17 +279,16 @@ void notification_worker::send_stealth(const route& reply_to, uint32_t id,
     const auto payload = build_chunk(
     {
         to_little_endian(prefix),
-        to_little_endian(height),
-        block_hash,
-        tx.to_data()
+        to_little_endian(tx.height),
+        tx.block_hash,
+        tx.data()
     });
 
     send(reply_to, address_stealth, id, payload);
 }
 
 void notification_worker::send_address(const route& reply_to, uint32_t id,
-    uint8_t sequence, uint32_t height, const hash_digest& block_hash,
-    const chain::transaction& tx)
+    uint8_t sequence, const published_transaction& tx)
 {
     // [ code:4 ]
     // [ sequence:1 ]
@@ -300,69 +299,40 @@ void notification_worker::send_address(const route& reply_to, uint32_t id,
     {
         message::to_bytes(error::success),
         to_array(sequence),
-        to_little_endian(height),
-        block_hash,
-        tx.to_data()
+        to_little_endian(tx.height),
+        tx.block_hash,
+        tx.data()
     });
 
     send(reply_to, address_update2, id, payload);
 }
 
-// Handlers.
+// Matched subscribers.
 // ----------------------------------------------------------------------------
+// These run on the ordered dispatch, which also serializes the v3 sequence.
 
-bool notification_worker::handle_payment(const code& ec,
-    const payment_address& address, uint32_t height,
-    const hash_digest& block_hash, const chain::transaction& tx,
-    const route& reply_to, uint32_t id, const binary& prefix_filter)
+void notification_worker::send_payments(
+    const subscription_list& subscriptions, const payment_address& address,
+    published_transaction::ptr tx)
 {
-    if (ec)
-    {
-        send(reply_to, address_update, id, message::to_bytes(ec));
-        return false;
-    }
-
-    if (prefix_filter.is_prefix_of(address.hash()))
-        send_payment(reply_to, id, address, height, block_hash, tx);
-
-    return true;
+    for (const auto& subscription: subscriptions)
+        send_payment(subscription->reply_to, subscription->id, address, *tx);
 }
 
-bool notification_worker::handle_stealth(const code& ec,
-    uint32_t prefix, uint32_t height, const hash_digest& block_hash,
-    const chain::transaction& tx, const route& reply_to, uint32_t id,
-    const binary& prefix_filter)
+void notification_worker::send_stealths(
+    const subscription_list& subscriptions, uint32_t prefix,
+    published_transaction::ptr tx)
 {
-    if (ec)
-    {
-        send(reply_to, address_stealth, id, message::to_bytes(ec));
-        return false;
-    }
-
-    if (prefix_filter.is_prefix_of(prefix))
-        send_stealth(reply_to, id, prefix, height, block_hash, tx);
-
-    return true;
+    for (const auto& subscription: subscriptions)
+        send_stealth(subscription->reply_to, subscription->id, prefix, *tx);
 }
 
-bool notification_worker::handle_address(const code& ec,
-    const binary& field, uint32_t height, const hash_digest& block_hash,
-    const chain::transaction& tx, const route& reply_to, uint32_t id,
-    const binary& prefix_filter, sequence_ptr sequence)
+void notification_worker::send_addresses(
+    const subscription_list& subscriptions, published_transaction::ptr tx)
 {
-    if (ec)
-    {
-        send(reply_to, address_update2, id, message::to_bytes(ec));
-        return false;
-    }
-
-    if (prefix_filter.is_prefix_of(field))
-    {
-        send_address(reply_to, id, *sequence, height, block_hash, tx);
-        ++(*sequence);
-    }
-
-    return true;
+    for (const auto& subscription: subscriptions)
+        send_address(subscription->reply_to, subscription->id,
+            subscription->sequence++, *tx);
 }
 
 // Subscribers.
@@ -374,34 +344,26 @@ void notification_worker::subscribe_address(const route& reply_to, uint32_t id,
     const binary& prefix_filter, subscribe_type type)
 {
     static const auto error_code = error::channel_stopped;
-    const auto& duration = settings_.subscription_expiration();
-    const address_key key(reply_to, prefix_filter);
 
+    // Renewing an existing subscription only extends its expiration.
+    // Limit exceeded and stopped are both reported as channel_stopped.
     switch (type)
     {
         // v2/v3 (deprecated)
         case subscribe_type::payment:
         {
-            // This class must be kept in scope until work is terminated.
-            const auto handler =
-                std::bind(&notification_worker::handle_payment,
-                    this, _1, _2, _3, _4, _5, reply_to, id, prefix_filter);
-
-            payment_subscriber_->subscribe(handler, key, duration, error_code,
-                {}, 0, {}, {});
+            if (!payment_subscriptions_.subscribe(reply_to, id, prefix_filter))
+                send(reply_to, address_update, id,
+                    message::to_bytes(error_code));
             break;
         }
 
         // v2/v3 (deprecated)
         case subscribe_type::stealth:
         {
-            // This class must be kept in scope until work is terminated.
-            const auto handler =
-                std::bind(&notification_worker::handle_stealth,
-                    this, _1, _2, _3, _4, _5, reply_to, id, prefix_filter);
-
-            stealth_subscriber_->subscribe(handler, key, duration, error_code,
-                0, 0, {}, {});
+            if (!stealth_subscriptions_.subscribe(reply_to, id, prefix_filter))
+                send(reply_to, address_stealth, id,
+                    message::to_bytes(error_code));
             break;
         }
 
@@ -409,17 +371,9 @@ void notification_worker::subscribe_address(const route& reply_to, uint32_t id,
         case subscribe_type::unspecified:
         {
             // The sequence enables the client to detect dropped messages.
-            const auto sequence = std::make_shared<uint8_t>(0);
-
-            // This class must be kept in scope until work is terminated.
-            const auto handler =
-                std::bind(&notification_worker::handle_address,
-                    this, _1, _2, _3, _4, _5, reply_to, id, prefix_filter,
-                    sequence);
-
-            // v3
-            address_subscriber_->subscribe(handler, key, duration, error_code,
-                {}, 0, {}, {});
+            if (!address_subscriptions_.subscribe(reply_to, id, prefix_filter))
+                send(reply_to, address_update2, id,
+                    message::to_bytes(error_code));
             break;
         }
 
@@ -427,13 +381,15 @@ void notification_worker::subscribe_address(const route& reply_to, uint32_t id,
         default:
         case subscribe_type::unsubscribe:
         {
-            // Just as with an expiration (purge) this will cause the stored
-            // handler (notification_worker::handle_address) to be invoked but
-            // with the specified error code (error::channel_stopped) as
-            // opposed to error::channel_timeout.
-
-            // v3
-            address_subscriber_->unsubscribe(key, error_code, {}, 0, {}, {});
+            // Just as with an expiration (purge) the subscriber is sent the
+            // specified error code (error::channel_stopped) as opposed to
+            // error::channel_timeout, using the id of the subscription.
+            const auto removed = address_subscriptions_.unsubscribe(reply_to,
+                prefix_filter);
+
+            if (removed)
+                send(removed->reply_to, address_update2, removed->id,
+                    message::to_bytes(error_code));
             break;
         }
     }
@@ -458,11 +414,11 @@ void notification_worker::subscribe_penetration(const route& reply_to,
     ////penetration_subscriber_->subscribe();
 }
 
-// Notification (via blockchain).
+// Notification (via publication).
 // ----------------------------------------------------------------------------
 
-bool notification_worker::handle_blockchain_reorganization(const code& ec,
-    uint64_t fork_point, const block_list& new_blocks, const block_list&)
+bool notification_worker::handle_publication(const code& ec,
+    publication::ptr value)
 {
     if (stopped() || ec == (code)error::service_stopped)
         return false;
@@ -470,68 +426,37 @@ bool notification_worker::handle_blockchain_reorganization(const code& ec,
     if (ec)
     {
         log::warning(LOG_SERVER)
-            << "Failure handling new block: " << ec.message();
+            << "Failure handling publication: " << ec.message();
 
         // Don't let a failure here prevent prevent future notifications.
         return true;
     }
 
-    // Blockchain height is 64 bit but obelisk protocol is 32 bit.
-    BITCOIN_ASSERT(fork_point <= max_uint32);
-    const auto fork_point32 = static_cast<uint32_t>(fork_point);
+    // Blocks are only notified with the block service enabled, as before.
+    if (settings_.block_service_enabled)
+        notify_blocks(value->blocks);
+
+    if (value->transaction)
+        notify_transaction(value->transaction);
 
-    notify_blocks(fork_point32, new_blocks);
     return true;
 }
 
-void notification_worker::notify_blocks(uint32_t fork_point,
-    const block_list& blocks)
+void notification_worker::notify_blocks(const published_block::list& blocks)
 {
-    if (stopped())
-        return;
-
-    const auto security = secure_ ? "secure" : "public";
-    const auto& endpoint = secure_ ? block_service::secure_worker :
-        block_service::public_worker;
-
-    // Notifications are off the pub-sub thread so this must connect back.
-    // This could be optimized by caching the socket as thread static.
-    zmq::socket publisher(authenticator_, zmq::socket::role::publisher);
-    const auto ec = publisher.connect(endpoint);
-
-    if (ec == (code)error::service_stopped)
-        return;
-
-    if (ec)
-    {
-        log::warning(LOG_SERVER)
-            << "Failed to connect " << security << " block worker: "
-            << ec.message();
-        return;
-    }
-
-    BITCOIN_ASSERT(blocks.size() <= max_uint32);
-    BITCOIN_ASSERT(fork_point < max_uint32 - blocks.size());
-    auto height = fork_point;
-
-    for (const auto block: blocks)
-        notify_block(publisher, height++, block);
+    for (const auto& block: blocks)
+        notify_block(*block);
 }
 
-void notification_worker::notify_block(zmq::socket& publisher, uint32_t height,
-    const block::ptr block)
+void notification_worker::notify_block(const published_block& block)
 {
     if (stopped())
         return;
 
-    const auto block_hash = block->header.hash();
-
-    for (const auto& tx: block->transactions)
+    for (const auto& tx: block.transactions)
     {
-        const auto tx_hash = tx.hash();
-
-        notify_transaction(height, block_hash, tx);
-        notify_penetration(height, block_hash, tx_hash);
+        notify_transaction(tx);
+        notify_penetration(block.height, block.hash, tx->hash());
     }
 }
 
@@ -562,36 +487,9 @@ bool notification_worker::handle_inventory(const code& ec,
     return true;
 }
 
-// Notification (via mempool).
-// ----------------------------------------------------------------------------
-
-bool notification_worker::handle_transaction_pool(const code& ec,
-    const point::indexes&, bc::message::transaction_message::ptr tx)
-{
-    if (stopped() || ec == (code)error::service_stopped)
-        return false;
-
-    if (ec == (code)error::mock)
-	{
-		return true;
-	}
-
-    if (ec)
-    {
-        log::warning(LOG_SERVER)
-            << "Failure handling new transaction: " << ec.message();
-
-        // Don't let a failure here prevent future notifications.
-        return true;
-    }
-
-    notify_transaction(0, null_hash, *tx);
-    return true;
-}
-
 // This parsing is duplicated by bc::database::data_base.
-void notification_worker::notify_transaction(uint32_t height,
-    const hash_digest& block_hash, const transaction& tx)
+// Payment addresses are extracted once by the publisher, on first demand.
+void notification_worker::notify_transaction(published_transaction::ptr tx)
 {
     uint32_t prefix;
 
@@ -599,43 +497,31 @@ void notification_worker::notify_transaction(uint32_t height,
     static constexpr size_t prefix_bits = sizeof(prefix) * byte_bits;
     static constexpr size_t address_bits = short_hash_size * byte_bits;
 
-    if (stopped() || tx.outputs.empty())
-        return;
+    const auto& outputs = tx->tx().outputs;
 
-    // see data_base::push_inputs
-    // Loop inputs and extract payment addresses.
-    for (const auto& input: tx.inputs)
-    {
-        const auto address = payment_address::extract(input.script);
+    if (stopped() || outputs.empty())
+        return;
 
-        if (address)
-        {
-            const binary field(address_bits, address.hash());
-            notify_address(field, height, block_hash, tx);
-            notify_payment(address, height, block_hash, tx);
-        }
-    }
+    // Without subscribers the publication is left unencoded.
+    if (payment_subscriptions_.size() == 0 &&
+        stealth_subscriptions_.size() == 0 &&
+        address_subscriptions_.size() == 0)
+        return;
 
-    // see data_base::push_outputs
-    // Loop outputs and extract payment addresses.
-    for (const auto& output: tx.outputs)
+    // see data_base::push_inputs and data_base::push_outputs
+    for (const auto& address: tx->addresses())
     {
-        const auto address = payment_address::extract(output.script);
-
-        if (address)
-        {
-            const binary field(address_bits, address.hash());
-            notify_address(field, height, block_hash, tx);
-            notify_payment(address, height, block_hash, tx);
-        }
+        const binary field(address_bits, address.hash());
+        notify_address(field, tx);
+        notify_payment(field, address, tx);
     }
 
     // see data_base::push_stealth
     // Loop output pairs and extract stealth payments.
-    for (size_t index = 0; index < (tx.outputs.size() - 1); ++index)
+    for (size_t index = 0; index < (outputs.size() - 1); ++index)
     {
-        const auto& ephemeral_script = tx.outputs[index].script;
-        const auto& payment_script = tx.outputs[index + 1].script;
+        const auto& ephemeral_script = outputs[index].script;
+        const auto& payment_script = outputs[index + 1].script;
 
         // Try to extract a stealth prefix from the first output.
         // Try to extract the payment address from the second output.
@@ -643,34 +529,46 @@ void notification_worker::notify_transaction(uint32_t height,
             payment_address::extract(payment_script))
         {
             const binary field(prefix_bits, to_little_endian(prefix));
-            notify_address(field, height, block_hash, tx);
-            notify_stealth(prefix, height, block_hash, tx);
+            notify_address(field, tx);
+            notify_stealth(field, prefix, tx);
         }
     }
 }
 
+// Matching is a walk of the subscription trie on the calling thread, only
+// matched subscriptions are queued for sending.
+
 // v2/v3 (deprecated)
-void notification_worker::notify_payment(const payment_address& address,
-    uint32_t height, const hash_digest& block_hash, const transaction& tx)
+void notification_worker::notify_payment(const binary& field,
+    const payment_address& address, published_transaction::ptr tx)
 {
-    static const auto code = error::success;
-    payment_subscriber_->relay(code, address, height, block_hash, tx);
+    const auto matches = payment_subscriptions_.match(field);
+
+    if (!matches.empty())
+        dispatch_.ordered(&notification_worker::send_payments,
+            this, matches, address, tx);
 }
 
 // v2/v3 (deprecated)
-void notification_worker::notify_stealth(uint32_t prefix, uint32_t height,
-    const hash_digest& block_hash, const transaction& tx)
+void notification_worker::notify_stealth(const binary& field, uint32_t prefix,
+    published_transaction::ptr tx)
 {
-    static const auto code = error::success;
-    stealth_subscriber_->relay(code, prefix, height, block_hash, tx);
+    const auto matches = stealth_subscriptions_.match(field);
+
+    if (!matches.empty())
+        dispatch_.ordered(&notification_worker::send_stealths,
+            this, matches, prefix, tx);
 }
 
 // v3
-void notification_worker::notify_address(const binary& field, uint32_t height,
-    const hash_digest& block_hash, const transaction& tx)
+void notification_worker::notify_address(const binary& field,
+    published_transaction::ptr tx)
 {
-    static const auto code = error::success;
-    address_subscriber_->relay(code, field, height, block_hash, tx);
+    const auto matches = address_subscriptions_.match(field);
+
+    if (!matches.empty())
+        dispatch_.ordered(&notification_worker::send_addresses,
+            this, matches, tx);
 }
 
 // v3.x
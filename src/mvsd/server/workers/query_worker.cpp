@@ -20,7 +20,10 @@
  */
 #include <metaverse/server/workers/query_worker.hpp>
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 #include <metaverse/protocol.hpp>
 #include <metaverse/server/define.hpp>
@@ -30,6 +33,7 @@
 #include <metaverse/server/interface/transaction_pool.hpp>
 #include <metaverse/server/messages/message.hpp>
 #include <metaverse/server/server_node.hpp>
+#include <metaverse/server/services/query_service.hpp>
 
 namespace libbitcoin {
 namespace server {
@@ -37,13 +41,29 @@ namespace server {
 using namespace std::placeholders;
 using namespace bc::protocol;
 
+static constexpr bool light = false;
+static constexpr bool heavy = true;
+
+// Each worker pulls the responses of its history queries from its own
+// inprocess endpoint, so that only the worker thread sends on its router.
+static config::endpoint responses_endpoint(bool secure)
+{
+    static std::atomic<uint64_t> instance(0);
+    const auto security = secure ? "secure" : "public";
+    return config::endpoint(std::string("inproc://") + security +
+        "_query_responses_" + std::to_string(++instance));
+}
+
 query_worker::query_worker(zmq::authenticator& authenticator,
-    server_node& node, bool secure)
+    server_node& node, bool secure, threadpool& history_pool)
   : worker(node.thread_pool()),
     secure_(secure),
     settings_(node.server_settings()),
+    responses_(responses_endpoint(secure)),
     node_(node),
-    authenticator_(authenticator)
+    authenticator_(authenticator),
+    history_pool_(history_pool),
+    statistics_(node.query_latency())
 {
     // The same interface is attached to the secure and public interfaces.
     attach_interface();
@@ -55,22 +75,33 @@ query_worker::query_worker(zmq::authenticator& authenticator,
 void query_worker::work()
 {
     zmq::socket router(authenticator_, zmq::socket::role::router);
+    zmq::socket puller(authenticator_, zmq::socket::role::puller);
 
-    // Connect socket to the service endpoint.
-    if (!started(connect(router)))
+    // Connect socket to the service endpoint, bind the response endpoint.
+    if (!started(connect(router) && bind(puller) && open_responder()))
         return;
 
     zmq::poller poller;
     poller.add(router);
+    poller.add(puller);
 
     while (!poller.terminated() && !stopped())
     {
-        if (poller.wait().contains(router.id()))
+        const auto signaled = poller.wait();
+
+        if (signaled.contains(router.id()))
             query(router);
+
+        // Responses are fully framed (including route) by the history pool.
+        if (signaled.contains(puller.id()) && !forward(puller, router))
+        {
+            log::warning(LOG_SERVER)
+                << "Failed to forward from history pool to router.";
+        }
     }
 
     // Disconnect the socket and exit this thread.
-    finished(disconnect(router));
+    finished(disconnect(router) && close_responder() && puller.stop());
 }
 
 // Connect/Disconnect.
@@ -97,6 +128,64 @@ bool query_worker::connect(zmq::socket& router)
     return true;
 }
 
+bool query_worker::bind(zmq::socket& puller)
+{
+    const auto security = secure_ ? "secure" : "public";
+    const auto ec = puller.bind(responses_);
+
+    if (ec)
+    {
+        log::error(LOG_SERVER)
+            << "Failed to bind " << security << " query responses to "
+            << responses_ << " : " << ec.message();
+        return false;
+    }
+
+    return true;
+}
+
+// The history pool sends every response on this one connected pusher.
+bool query_worker::open_responder()
+{
+    const auto security = secure_ ? "secure" : "public";
+    const auto pusher = std::make_shared<zmq::socket>(authenticator_,
+        zmq::socket::role::pusher);
+    const auto ec = pusher->connect(responses_);
+
+    if (ec)
+    {
+        log::error(LOG_SERVER)
+            << "Failed to connect " << security << " query responses: "
+            << ec.message();
+        return false;
+    }
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    scoped_lock lock(pusher_mutex_);
+
+    pusher_ = pusher;
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Called on the worker thread, which opened the pusher, before the context
+// is stopped. Responses completing after this are dropped.
+bool query_worker::close_responder()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    scoped_lock lock(pusher_mutex_);
+
+    if (!pusher_)
+        return true;
+
+    const auto result = pusher_->stop();
+    pusher_.reset();
+    return result;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 bool query_worker::disconnect(zmq::socket& router)
 {
     const auto security = secure_ ? "secure" : "public";
@@ -167,27 +256,84 @@ void query_worker::query(zmq::socket& router)
         << request.route().display();
 
     // The query executor is the delegate bound by the attach method.
-    const auto& query_execute = handler->second;
+    const auto query_execute = handler->second.handler;
+    const auto command = request.command();
+    const auto started = asio::steady_clock::now();
+    auto& statistics = statistics_;
+
+    // Latency is measured from receipt to the response, per method.
+    const auto timed = [&statistics, command, started](send_handler send)
+    {
+        return [&statistics, command, started, send](message&& response)
+        {
+            send(std::move(response));
+            statistics.record(command, asio::steady_clock::now() - started);
+        };
+    };
+
+    if (!handler->second.heavy || settings_.query_history_workers == 0)
+    {
+        // Execute the request and forward result to queue.
+        // Example: address.renew(node_, request, sender);
+        // Example: blockchain.fetch_last_height(node_, request, sender);
+        query_execute(request, timed(sender));
+        return;
+    }
 
-    // Execute the request and forward result to queue.
-    // Example: address.renew(node_, request, sender);
+    const send_handler responder =
+        std::bind(&query_worker::respond, this, _1);
+
+    // Execute the request on the history pool and return the result.
     // Example: blockchain.fetch_history(node_, request, sender);
-    query_execute(request, sender);
+    history_pool_.service().post(
+        [this, query_execute, request, responder, timed]()
+        {
+            if (!stopped())
+                query_execute(request, timed(responder));
+        });
+}
+
+// Called from the history pool, sends are serialized on the shared pusher.
+void query_worker::respond(message&& response)
+{
+    code ec;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section.
+    pusher_mutex_.lock();
+
+    if (!pusher_)
+    {
+        pusher_mutex_.unlock();
+        return;
+    }
+
+    ec = response.send(*pusher_);
+
+    pusher_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (ec && ec != (code)error::service_stopped)
+        log::warning(LOG_SERVER)
+            << "Failed to send query response to "
+            << response.route().display() << " " << ec.message();
 }
 
 // Query Interface.
 // ----------------------------------------------------------------------------
 
 // Class and method names must match protocol expectations (do not change).
-#define ATTACH(class_name, method_name, node) \
+// Heavy queries execute on the history pool, others on the worker thread.
+#define ATTACH(class_name, method_name, node, lane) \
     attach(#class_name "." #method_name, \
         std::bind(&bc::server::class_name::method_name, \
-            std::ref(node), _1, _2));
+            std::ref(node), _1, _2), lane);
 
 void query_worker::attach(const std::string& command,
-    command_handler handler)
+    command_handler handler, bool heavy)
 {
-    command_handlers_[command] = handler;
+    command_handlers_[command] = { handler, heavy };
+    statistics_.attach(command, heavy);
 }
 
 //=============================================================================
@@ -212,26 +358,26 @@ void query_worker::attach(const std::string& command,
 // Interface class.method names must match protocol (do not change).
 void query_worker::attach_interface()
 {
-    ATTACH(address, renew, node_);
-    ATTACH(address, subscribe, node_);
-    ATTACH(address, subscribe2, node_);
-    ATTACH(address, unsubscribe2, node_);
-    ATTACH(address, fetch_history2, node_);
-    ATTACH(blockchain, fetch_history, node_);
-    ATTACH(blockchain, fetch_block_header, node_);
-    ATTACH(blockchain, fetch_block_height, node_);
-    ATTACH(blockchain, fetch_block_transaction_hashes, node_);
-    ATTACH(blockchain, fetch_last_height, node_);
-    ATTACH(blockchain, fetch_transaction, node_);
-    ATTACH(blockchain, fetch_transaction_index, node_);
-    ATTACH(blockchain, fetch_spend, node_);
-    ATTACH(blockchain, fetch_stealth, node_);
-    ATTACH(blockchain, fetch_stealth2, node_);
-    ATTACH(transaction_pool, fetch_transaction, node_);
-    ATTACH(transaction_pool, validate, node_);
-    ////ATTACH(transaction_pool, broadcast, node_);
-    ATTACH(protocol, broadcast_transaction, node_);
-    ATTACH(protocol, total_connections, node_);
+    ATTACH(address, renew, node_, light);
+    ATTACH(address, subscribe, node_, light);
+    ATTACH(address, subscribe2, node_, light);
+    ATTACH(address, unsubscribe2, node_, light);
+    ATTACH(address, fetch_history2, node_, heavy);
+    ATTACH(blockchain, fetch_history, node_, heavy);
+    ATTACH(blockchain, fetch_block_header, node_, light);
+    ATTACH(blockchain, fetch_block_height, node_, light);
+    ATTACH(blockchain, fetch_block_transaction_hashes, node_, light);
+    ATTACH(blockchain, fetch_last_height, node_, light);
+    ATTACH(blockchain, fetch_transaction, node_, light);
+    ATTACH(blockchain, fetch_transaction_index, node_, light);
+    ATTACH(blockchain, fetch_spend, node_, light);
+    ATTACH(blockchain, fetch_stealth, node_, heavy);
+    ATTACH(blockchain, fetch_stealth2, node_, heavy);
+    ATTACH(transaction_pool, fetch_transaction, node_, light);
+    ATTACH(transaction_pool, validate, node_, heavy);
+    ////ATTACH(transaction_pool, broadcast, node_, light);
+    ATTACH(protocol, broadcast_transaction, node_, heavy);
+    ATTACH(protocol, total_connections, node_, light);
 }
 
 #undef ATTACH
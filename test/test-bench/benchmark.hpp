@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_TEST_BENCHMARK_HPP
+#define MVS_TEST_BENCHMARK_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace bench {
+
+/// The mean wall time of one call in nanoseconds, after one warm-up call.
+template <typename Function>
+double nanoseconds_per_call(size_t calls, Function function)
+{
+    function();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t call = 0; call < calls; ++call)
+        function();
+    const auto end = std::chrono::steady_clock::now();
+
+    const std::chrono::duration<double, std::nano> elapsed = end - start;
+    return elapsed.count() / calls;
+}
+
+/// Print a result line, the timings are reported and never asserted.
+inline void report(const std::string& name, double nanoseconds)
+{
+    std::cout << std::left << std::setw(48) << name << std::right
+        << std::fixed << std::setprecision(0) << std::setw(12)
+        << nanoseconds << " ns/call" << std::endl;
+}
+
+} // namespace bench
+
+#endif
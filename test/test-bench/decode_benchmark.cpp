@@ -0,0 +1,136 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/consensus/miner.hpp>
+#include "benchmark.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::message;
+
+// Decoding of block and transaction payloads as received from peers, through
+// a stream over the payload and through a reader over it in place.
+BOOST_AUTO_TEST_SUITE(decode_benchmark)
+
+static const auto protocol_version = version::level::bip152;
+
+// Two signed key hash inputs and two key hash outputs, a common payment.
+static transaction make_payment(uint32_t sequence)
+{
+    const data_chunk signature(72, 0x30);
+    const data_chunk public_key(33, 0x02);
+    short_hash payee;
+    payee.fill(0x42);
+
+    input in;
+    in.script.operations = { { opcode::special, signature },
+        { opcode::special, public_key } };
+    in.sequence = max_uint32;
+
+    output out;
+    out.value = 100000000;
+    out.script.operations = operation::to_pay_key_hash_pattern(payee);
+
+    transaction tx{ 1, 0, { in, in }, { out, out } };
+    tx.inputs[0].previous_output = output_point{ null_hash, sequence };
+    tx.inputs[1].previous_output = output_point{ null_hash, sequence + 1 };
+    return tx;
+}
+
+static block make_block(size_t count)
+{
+    block instance;
+    instance.header.version = 1;
+    instance.header.number = 42;
+    instance.header.timestamp = 1500000000;
+
+    for (uint32_t index = 0; index < count; ++index)
+        instance.transactions.push_back(make_payment(2 * index));
+
+    instance.header.transaction_count = count;
+    instance.header.merkle =
+        block::generate_merkle_root(instance.transactions);
+    return instance;
+}
+
+template <typename Message>
+static void report(const std::string& name, const data_chunk& payload,
+    size_t calls)
+{
+    const auto stream = bench::nanoseconds_per_call(calls, [&]()
+    {
+        data_source source(payload);
+        Message instance;
+        instance.from_data(protocol_version, source);
+    });
+
+    const auto in_place = bench::nanoseconds_per_call(calls, [&]()
+    {
+        data_reader source(payload);
+        Message instance;
+        instance.from_data(protocol_version, source);
+    });
+
+    bench::report(name + ", stream", stream);
+    bench::report(name + ", in place", in_place);
+}
+
+template <typename Message>
+static void require_same_decoding(const data_chunk& payload)
+{
+    data_source stream(payload);
+    Message streamed;
+    BOOST_REQUIRE(streamed.from_data(protocol_version, stream));
+
+    data_reader reader(payload);
+    Message read;
+    BOOST_REQUIRE(read.from_data(protocol_version, reader));
+    BOOST_REQUIRE(reader.is_exhausted());
+    BOOST_REQUIRE(read.to_data(protocol_version) == payload);
+    BOOST_REQUIRE(streamed.to_data(protocol_version) == payload);
+}
+
+BOOST_AUTO_TEST_CASE(decode_benchmark__genesis_block__stream_and_in_place)
+{
+    const auto genesis = consensus::miner::create_genesis_block(true);
+    const auto payload = block_message(*genesis).to_data(protocol_version);
+    require_same_decoding<block_message>(payload);
+    report<block_message>("genesis block", payload, 20000);
+}
+
+BOOST_AUTO_TEST_CASE(decode_benchmark__block__stream_and_in_place)
+{
+    const auto payload = block_message(make_block(500)).to_data(
+        protocol_version);
+    require_same_decoding<block_message>(payload);
+    report<block_message>("block of 500 payments", payload, 50);
+}
+
+BOOST_AUTO_TEST_CASE(decode_benchmark__transaction__stream_and_in_place)
+{
+    const auto payload = transaction_message(make_payment(0)).to_data(
+        protocol_version);
+    require_same_decoding<transaction_message>(payload);
+    report<transaction_message>("payment transaction", payload, 20000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
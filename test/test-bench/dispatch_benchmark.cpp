@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <jsoncpp/json/json.h>
+#include <metaverse/explorer/command.hpp>
+#include <metaverse/explorer/generated.hpp>
+#include <metaverse/explorer/parser.hpp>
+#include <metaverse/explorer/extensions/command_extension_func.hpp>
+#include <metaverse/mgbubble/Mongoose.hpp>
+#include "benchmark.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::explorer;
+
+// Lookup and parameter binding of one rpc call, the command is not invoked.
+BOOST_AUTO_TEST_SUITE(dispatch_benchmark)
+
+static const size_t calls = 20000;
+
+// A /rpc/v2 request with options and arguments, as sent by a wallet.
+static Json::Value make_request()
+{
+    Json::Value options;
+    options["height"] = "1000:2000";
+    options["limit"] = 20;
+    options["index"] = 2;
+
+    Json::Value request;
+    request["jsonrpc"] = "2.0";
+    request["id"] = 1;
+    request["method"] = "listtxs";
+    request["params"].append(options);
+    request["params"].append("alice");
+    request["params"].append("secret");
+    return request;
+}
+
+// The former route: params flattened into argv and tokenized by
+// program_options.
+static bool dispatch_argv(const Json::Value& request)
+{
+    mgbubble::HttpMessage message(nullptr);
+    message.request_to_arg(request, 2);
+
+    // The server copies the arguments for its worker, see HttpServ.
+    std::vector<const char*> args(message.argv(),
+        message.argv() + message.argc());
+
+    const auto command = find(message.get_command());
+    std::istringstream input;
+    std::string error;
+    parser metadata(*command);
+    return metadata.parse(error, input, message.argc(), args.data());
+}
+
+// The /rpc/v2 route: params bound directly against the command metadata.
+static bool dispatch_json(const Json::Value& request)
+{
+    const auto command = find(request["method"].asString());
+    std::istringstream input;
+    std::string error;
+    parser metadata(*command);
+    return metadata.parse(error, input, request["params"]);
+}
+
+BOOST_AUTO_TEST_CASE(dispatch_benchmark__lookup__registry_and_linear_scan)
+{
+    // The symbols in the order of the former comparison chain.
+    std::vector<std::string> symbols;
+    broadcast_extension([&symbols](std::shared_ptr<command> instance)
+    {
+        symbols.push_back(instance->name());
+    });
+
+    const std::string target("listtxs");
+    BOOST_REQUIRE(find_extension(target));
+
+    // The position is kept so that the scan is not optimized away.
+    volatile size_t position = 0;
+    const auto scan = bench::nanoseconds_per_call(calls, [&]()
+    {
+        size_t index = 0;
+        while (index < symbols.size() && symbols[index] != target)
+            ++index;
+
+        position = index;
+    });
+
+    BOOST_REQUIRE_LT(position, symbols.size());
+
+    const auto registry = bench::nanoseconds_per_call(calls, [&]()
+    {
+        find_extension(target);
+    });
+
+    bench::report("lookup, linear symbol scan (no construction)", scan);
+    bench::report("lookup, sorted registry (with construction)", registry);
+}
+
+BOOST_AUTO_TEST_CASE(dispatch_benchmark__bind__argv_and_json)
+{
+    const auto request = make_request();
+    BOOST_REQUIRE(dispatch_argv(request));
+    BOOST_REQUIRE(dispatch_json(request));
+
+    const auto argv = bench::nanoseconds_per_call(calls, [&]()
+    {
+        dispatch_argv(request);
+    });
+
+    const auto json = bench::nanoseconds_per_call(calls, [&]()
+    {
+        dispatch_json(request);
+    });
+
+    bench::report("dispatch, params to argv and tokenized", argv);
+    bench::report("dispatch, params bound from json", json);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,211 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/consensus/libdevcore/BasicType.h>
+#include <metaverse/consensus/libdevcore/RLP.h>
+#include <metaverse/consensus/libdevcore/SHA3.h>
+#include "benchmark.hpp"
+
+using namespace libbitcoin;
+
+// Header validation arithmetic (seal hash, boundary and retarget) and the
+// ethash field decoding, through the replaced bigint and FixedHash code and
+// through the fixed width code now in the tree.
+BOOST_AUTO_TEST_SUITE(header_benchmark)
+
+static const uint32_t time_config = 24;
+static const u256 minimum_difficulty = 914572800;
+
+// The replaced implementations, kept here as the baseline.
+// ----------------------------------------------------------------------------
+
+static h256 bigint_hash_head(const chain::header& header)
+{
+    RLPStream s;
+    s << (bigint)header.version << (bigint)header.bits << (bigint)header.number
+        << header.merkle << header.previous_block_hash
+        << (bigint)header.timestamp;
+    return sha3(s.out());
+}
+
+static h256 bigint_boundary(const chain::header& header)
+{
+    const auto d = header.bits;
+    return d ? (h256)u256(((bigint(1) << 255) - bigint(1) +
+        (bigint(1) << 255)) / d) : h256();
+}
+
+static u256 bigint_difficulty(const chain::header& header,
+    const chain::header& parent)
+{
+    bigint target;
+    if (header.timestamp >= parent.timestamp + time_config)
+        target = parent.bits - (parent.bits / 1024);
+    else
+        target = parent.bits + (parent.bits / 1024);
+
+    bigint result = target;
+    result = std::max<bigint>(bigint(minimum_difficulty), result);
+    return u256(std::min<bigint>(result, std::numeric_limits<u256>::max()));
+}
+
+static void fixed_hash_fields(const data_chunk& fields, u256& bits,
+    u64& nonce, u256& mixhash)
+{
+    bits = (h256::Arith)(h256(&fields[0], h256::ConstructFromPointer));
+    nonce = (h64::Arith)(h64(&fields[32], h64::ConstructFromPointer));
+    mixhash = (h256::Arith)(h256(&fields[40], h256::ConstructFromPointer));
+}
+
+// ----------------------------------------------------------------------------
+
+static void word_fields(const data_chunk& fields, u256& bits, u64& nonce,
+    u256& mixhash)
+{
+    data_reader source(fields);
+    const auto read_u256 = [&source]()
+    {
+        u256 value = 0;
+        for (size_t word = 0; word < 4; ++word)
+            value = (value << 64) | source.read_8_bytes_big_endian();
+        return value;
+    };
+
+    bits = read_u256();
+    nonce = source.read_8_bytes_big_endian();
+    mixhash = read_u256();
+}
+
+static chain::header make_header(uint32_t number, uint32_t timestamp,
+    const u256& bits)
+{
+    chain::header header;
+    header.version = 1;
+    header.number = number;
+    header.timestamp = timestamp;
+    header.bits = bits;
+    header.nonce = 0x0123456789abcdef;
+    header.mixhash = u256(
+        "0x1f2e3d4c5b6a79881f2e3d4c5b6a79881f2e3d4c5b6a79881f2e3d4c5b6a7988");
+    header.merkle.fill(0x11);
+    header.previous_block_hash.fill(0x22);
+    return header;
+}
+
+static data_chunk ethash_fields(const chain::header& header)
+{
+    const auto data = header.to_data(false);
+
+    // version, previous hash, merkle and timestamp precede the fields.
+    const auto begin = data.begin() + 4 + 32 + 32 + 4;
+    return data_chunk(begin, begin + 32 + 8 + 32);
+}
+
+BOOST_AUTO_TEST_CASE(header_benchmark__results__match_bigint)
+{
+    const auto maximum = std::numeric_limits<u256>::max();
+    const std::vector<u256> parents{ minimum_difficulty,
+        u256("0x2b3c4d5e6f708192"), maximum - maximum / 2048, maximum };
+
+    for (const auto& bits: parents)
+    {
+        const auto parent = make_header(99, 1500000000, bits);
+
+        // A retarget up (fast block) and one down (slow block).
+        for (const auto delay: { 1u, 60u })
+        {
+            auto header = make_header(100, parent.timestamp + delay, bits);
+            BOOST_REQUIRE(HeaderAux::calculateDifficulty(header,
+                const_cast<chain::header&>(parent)) ==
+                bigint_difficulty(header, parent));
+            BOOST_REQUIRE(HeaderAux::hashHead(header) ==
+                bigint_hash_head(header));
+            BOOST_REQUIRE(HeaderAux::boundary(header) ==
+                bigint_boundary(header));
+
+            u256 bits1, mixhash1, bits2, mixhash2;
+            u64 nonce1, nonce2;
+            const auto fields = ethash_fields(header);
+            fixed_hash_fields(fields, bits1, nonce1, mixhash1);
+            word_fields(fields, bits2, nonce2, mixhash2);
+            BOOST_REQUIRE(bits1 == header.bits && bits2 == header.bits);
+            BOOST_REQUIRE(nonce1 == header.nonce && nonce2 == header.nonce);
+            BOOST_REQUIRE(mixhash1 == header.mixhash &&
+                mixhash2 == header.mixhash);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(header_benchmark__validation__bigint_and_fixed_width)
+{
+    static const size_t calls = 100000;
+    const auto parent = make_header(999, 1500000000,
+        u256("0x2b3c4d5e6f708192"));
+    auto header = make_header(1000, parent.timestamp + 1, parent.bits);
+    const auto fields = ethash_fields(header);
+    volatile bool sink = false;
+
+    bench::report("hash head, bigint", bench::nanoseconds_per_call(calls, [&]()
+    {
+        sink = !bigint_hash_head(header);
+    }));
+    bench::report("hash head, fixed width", bench::nanoseconds_per_call(calls, [&]()
+    {
+        sink = !HeaderAux::hashHead(header);
+    }));
+
+    bench::report("boundary, bigint", bench::nanoseconds_per_call(calls, [&]()
+    {
+        sink = !bigint_boundary(header);
+    }));
+    bench::report("boundary, fixed width", bench::nanoseconds_per_call(calls, [&]()
+    {
+        sink = !HeaderAux::boundary(header);
+    }));
+
+    bench::report("difficulty, bigint", bench::nanoseconds_per_call(calls, [&]()
+    {
+        sink = bigint_difficulty(header, parent) == 0;
+    }));
+    bench::report("difficulty, fixed width", bench::nanoseconds_per_call(calls, [&]()
+    {
+        sink = HeaderAux::calculateDifficulty(header,
+            const_cast<chain::header&>(parent)) == 0;
+    }));
+
+    u256 bits, mixhash;
+    u64 nonce;
+    bench::report("ethash fields, fixed hash", bench::nanoseconds_per_call(calls, [&]()
+    {
+        fixed_hash_fields(fields, bits, nonce, mixhash);
+        sink = nonce == 0;
+    }));
+    bench::report("ethash fields, words", bench::nanoseconds_per_call(calls, [&]()
+    {
+        word_fields(fields, bits, nonce, mixhash);
+        sink = nonce == 0;
+    }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
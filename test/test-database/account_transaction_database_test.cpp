@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/databases/account_transaction_database.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::database;
+using namespace boost::filesystem;
+
+struct account_transaction_database_fixture
+{
+    account_transaction_database_fixture()
+      : directory(temp_directory_path() / unique_path()),
+        account(ripemd160_hash(to_chunk(std::string("alice"))))
+    {
+        create_directories(directory);
+
+        for (const auto& file: { "lookup", "rows", "addresses", "address_rows" })
+        {
+            std::ofstream stream((directory / file).string());
+            stream.put('w');
+        }
+    }
+
+    ~account_transaction_database_fixture()
+    {
+        remove_all(directory);
+    }
+
+    static account_transaction row(uint32_t height, uint8_t fill)
+    {
+        hash_digest hash;
+        hash.fill(fill);
+        return { height, hash, height * 10 };
+    }
+
+    path directory;
+    short_hash account;
+};
+
+BOOST_FIXTURE_TEST_SUITE(account_transaction_database_tests,
+    account_transaction_database_fixture)
+
+BOOST_AUTO_TEST_CASE(account_transaction_database__replace__no_rows__indexed)
+{
+    account_transaction_database instance(directory / "lookup",
+        directory / "rows", directory / "addresses",
+        directory / "address_rows");
+    BOOST_REQUIRE(instance.create());
+    BOOST_REQUIRE(instance.empty(account));
+
+    // An account without transactions is marked, so it is not built again.
+    instance.replace(account, {});
+    BOOST_REQUIRE(!instance.empty(account));
+
+    uint64_t total;
+    BOOST_REQUIRE(instance.get(account, 0, 0, 0, 0, total).empty());
+    BOOST_REQUIRE_EQUAL(total, 0u);
+    BOOST_REQUIRE(instance.get(account).empty());
+
+    instance.reset(account);
+    BOOST_REQUIRE(instance.empty(account));
+}
+
+BOOST_AUTO_TEST_CASE(account_transaction_database__get__marked__transactions_only)
+{
+    account_transaction_database instance(directory / "lookup",
+        directory / "rows", directory / "addresses",
+        directory / "address_rows");
+    BOOST_REQUIRE(instance.create());
+
+    instance.replace(account, { row(1, 0x01), row(5, 0x05) });
+    instance.store(account, row(9, 0x09));
+
+    uint64_t total;
+    const auto rows = instance.get(account, 0, 0, 0, 0, total);
+    BOOST_REQUIRE_EQUAL(total, 3u);
+    BOOST_REQUIRE_EQUAL(rows.size(), 3u);
+    BOOST_REQUIRE_EQUAL(rows.front().height, 9u);
+    BOOST_REQUIRE_EQUAL(rows.back().height, 1u);
+
+    const auto range = instance.get(account, 0, 5, 0, 0, total);
+    BOOST_REQUIRE_EQUAL(total, 1u);
+    BOOST_REQUIRE_EQUAL(range.front().height, 1u);
+
+    // Removing every transaction leaves the account indexed.
+    instance.remove(account, row(9, 0x09).hash);
+    instance.remove(account, row(1, 0x01).hash);
+    instance.remove(account, row(5, 0x05).hash);
+    BOOST_REQUIRE(!instance.empty(account));
+    BOOST_REQUIRE(instance.get(account).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
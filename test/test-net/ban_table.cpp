@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/network.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::network;
+
+BOOST_AUTO_TEST_SUITE(test_ban_table)
+
+// Two entries per shard, a 100 second wheel slot and a 6400 second rotation.
+static constexpr size_t capacity = 32;
+static constexpr uint32_t ban_seconds = 6400;
+
+static config::authority make_authority(uint32_t index)
+{
+    return config::authority("10.0." + std::to_string(index / 256) + "." +
+        std::to_string(index % 256), 5251);
+}
+
+BOOST_AUTO_TEST_CASE(ban_table__ban__full__evicts_nearest_expiry)
+{
+    ban_table table(capacity, ban_seconds);
+    const auto shortest = make_authority(0);
+    table.ban(shortest, 60);
+
+    // Full duration bans land a whole rotation ahead, in the cursor slot.
+    for (uint32_t index = 1; index < 1000; ++index)
+        table.ban(make_authority(index), ban_seconds);
+
+    BOOST_REQUIRE(!table.banned(shortest));
+    BOOST_REQUIRE(table.banned(make_authority(999)));
+}
+
+BOOST_AUTO_TEST_CASE(ban_table__ban__extended__outlives_full_duration)
+{
+    ban_table table(capacity, ban_seconds);
+    const auto extended = make_authority(0);
+    table.ban(extended, 60);
+    table.ban(extended, 2 * ban_seconds);
+
+    // The superseded short entry no longer stands in for the extended ban.
+    for (uint32_t index = 1; index < 1000; ++index)
+        table.ban(make_authority(index), ban_seconds + index);
+
+    BOOST_REQUIRE(table.banned(extended));
+    BOOST_REQUIRE_LE(table.size(), capacity);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
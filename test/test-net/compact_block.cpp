@@ -0,0 +1,593 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/network.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::message;
+using namespace libbitcoin::network;
+
+BOOST_AUTO_TEST_SUITE(test_compact_block)
+
+static const auto protocol_version = version::level::bip152;
+
+// Transactions are told apart by their locktime, the first is the coinbase.
+static transaction make_transaction(uint32_t locktime)
+{
+    input in;
+    in.previous_output = output_point{ null_hash, max_uint32 };
+    in.sequence = max_uint32;
+    return transaction{ 1, locktime, { in }, {} };
+}
+
+static block make_block(size_t count)
+{
+    block instance;
+    for (uint32_t index = 0; index < count; ++index)
+        instance.transactions.push_back(make_transaction(index));
+
+    instance.header.version = 1;
+    instance.header.number = 42;
+    instance.header.timestamp = 1500000000;
+    instance.header.transaction_count = count;
+    instance.header.merkle =
+        block::generate_merkle_root(instance.transactions);
+    return instance;
+}
+
+// The sender's compact block as decoded by the receiver.
+static compact_block loopback(const block& original)
+{
+    const auto sent = compact_block::from_block(original, 0x0123456789abcdef);
+    return compact_block::factory_from_data(protocol_version,
+        sent.to_data(protocol_version));
+}
+
+// A memory pool holding the given transactions of the block.
+struct pool
+{
+    hash_list hashes() const
+    {
+        hash_list out;
+        for (const auto& tx: transactions)
+            out.push_back(tx.hash());
+
+        return out;
+    }
+
+    bool find(const hash_digest& hash, transaction& out) const
+    {
+        for (const auto& tx: transactions)
+        {
+            if (tx.hash() != hash)
+                continue;
+
+            out = tx;
+            return true;
+        }
+
+        return false;
+    }
+
+    compact_block::transaction_finder finder() const
+    {
+        return [this](const hash_digest& hash, transaction& out)
+        {
+            return find(hash, out);
+        };
+    }
+
+    transaction::list transactions;
+};
+
+BOOST_AUTO_TEST_CASE(compact_block__from_block__coinbase_prefilled_short_ids_for_rest)
+{
+    const auto original = make_block(4);
+    const auto instance = loopback(original);
+
+    BOOST_REQUIRE_EQUAL(instance.transactions.size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.transactions.front().index, 0u);
+    BOOST_REQUIRE(instance.transactions.front().transaction.hash() ==
+        original.transactions.front().hash());
+    BOOST_REQUIRE_EQUAL(instance.short_ids.size(), 3u);
+    BOOST_REQUIRE(instance.header.hash() == original.header.hash());
+
+    const auto key = instance.short_id_key();
+    for (size_t index = 1; index < original.transactions.size(); ++index)
+        BOOST_REQUIRE(instance.short_ids[index - 1] == compact_block::to_short_id(
+            key, original.transactions[index].hash()));
+}
+
+BOOST_AUTO_TEST_CASE(compact_block__reconstruct__all_in_pool__complete)
+{
+    const auto original = make_block(4);
+    const auto instance = loopback(original);
+
+    pool mempool;
+    mempool.transactions.assign(original.transactions.begin() + 1,
+        original.transactions.end());
+
+    block rebuilt;
+    std::vector<uint64_t> missing;
+    BOOST_REQUIRE(instance.reconstruct(rebuilt, missing, mempool.hashes(),
+        mempool.finder()));
+    BOOST_REQUIRE(missing.empty());
+    BOOST_REQUIRE(block::generate_merkle_root(rebuilt.transactions) ==
+        original.header.merkle);
+    BOOST_REQUIRE(rebuilt.header.hash() == original.header.hash());
+}
+
+BOOST_AUTO_TEST_CASE(compact_block__reconstruct__missing__completed_by_block_transactions)
+{
+    const auto original = make_block(5);
+    const auto instance = loopback(original);
+
+    // The pool lacks the transactions at indexes 2 and 4.
+    pool mempool;
+    mempool.transactions.push_back(original.transactions[1]);
+    mempool.transactions.push_back(original.transactions[3]);
+
+    block rebuilt;
+    std::vector<uint64_t> missing;
+    BOOST_REQUIRE(instance.reconstruct(rebuilt, missing, mempool.hashes(),
+        mempool.finder()));
+    BOOST_REQUIRE_EQUAL(missing.size(), 2u);
+    BOOST_REQUIRE_EQUAL(missing[0], 2u);
+    BOOST_REQUIRE_EQUAL(missing[1], 4u);
+
+    // The sender answers get_block_transactions by index.
+    block_transactions sent;
+    sent.block_hash = original.header.hash();
+    for (const auto index: missing)
+        sent.transactions.push_back(original.transactions[index]);
+
+    const auto reply = block_transactions::factory_from_data(
+        protocol_version, sent.to_data(protocol_version));
+    BOOST_REQUIRE_EQUAL(reply.transactions.size(), missing.size());
+
+    for (size_t index = 0; index < missing.size(); ++index)
+        rebuilt.transactions[missing[index]] = reply.transactions[index];
+
+    BOOST_REQUIRE(block::generate_merkle_root(rebuilt.transactions) ==
+        original.header.merkle);
+}
+
+BOOST_AUTO_TEST_CASE(compact_block__reconstruct__short_id_collision__falls_back)
+{
+    auto instance = loopback(make_block(3));
+    instance.short_ids[1] = instance.short_ids[0];
+
+    pool mempool;
+    block rebuilt;
+    std::vector<uint64_t> missing;
+    BOOST_REQUIRE(!instance.reconstruct(rebuilt, missing, mempool.hashes(),
+        mempool.finder()));
+}
+
+BOOST_AUTO_TEST_CASE(compact_block__reconstruct__bad_prefilled_index__falls_back)
+{
+    auto instance = loopback(make_block(3));
+    instance.transactions.front().index = 3;
+
+    pool mempool;
+    block rebuilt;
+    std::vector<uint64_t> missing;
+    BOOST_REQUIRE(!instance.reconstruct(rebuilt, missing, mempool.hashes(),
+        mempool.finder()));
+}
+
+BOOST_AUTO_TEST_CASE(compact_block__reconstruct__wrong_match__merkle_mismatch)
+{
+    const auto original = make_block(3);
+    const auto instance = loopback(original);
+
+    // A pool transaction whose short id matches but whose body differs, as
+    // after a short id collision with the pool, fails the merkle check and
+    // the receiver requests the full block.
+    pool mempool;
+    mempool.transactions.assign(original.transactions.begin() + 1,
+        original.transactions.end());
+    const auto substitute = [&mempool](const hash_digest& hash,
+        transaction& out)
+    {
+        if (!mempool.find(hash, out))
+            return false;
+
+        out.locktime += 100;
+        return true;
+    };
+
+    block rebuilt;
+    std::vector<uint64_t> missing;
+    BOOST_REQUIRE(instance.reconstruct(rebuilt, missing, mempool.hashes(),
+        substitute));
+    BOOST_REQUIRE(missing.empty());
+    BOOST_REQUIRE(block::generate_merkle_root(rebuilt.transactions) !=
+        original.header.merkle);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(test_compact_block_relay)
+
+using test_compact_block::make_block;
+using test_compact_block::pool;
+
+// Two in-process nodes connected on loopback. The sender holds the block
+// and answers as protocol_block_out does, the receiver holds a memory pool
+// and rebuilds the block as protocol_block_in does.
+
+static const uint16_t relay_port = 18251;
+static const auto relay_timeout = std::chrono::seconds(10);
+
+enum class relay_route
+{
+    compact,
+    block_transactions,
+    full_block
+};
+
+struct relay_result
+{
+    block delivered;
+    relay_route route;
+};
+
+static network::settings relay_settings(uint16_t inbound_port)
+{
+    network::settings configuration(bc::settings::testnet);
+    configuration.threads = 1;
+    configuration.inbound_port = inbound_port;
+    configuration.inbound_connections = inbound_port == 0 ? 0 : 1;
+    configuration.outbound_connections = 0;
+    configuration.host_pool_capacity = 0;
+    configuration.manual_attempt_limit = 1;
+    configuration.upnp_map_port = false;
+    configuration.be_found = false;
+    configuration.seeds.clear();
+    return configuration;
+}
+
+static code start_result(p2p& network)
+{
+    std::promise<code> promise;
+    network.start([&promise](const code& ec)
+    {
+        promise.set_value(ec);
+    });
+    return promise.get_future().get();
+}
+
+static code run_result(p2p& network)
+{
+    std::promise<code> promise;
+    network.run([&promise](const code& ec)
+    {
+        promise.set_value(ec);
+    });
+    return promise.get_future().get();
+}
+
+static void ignore_send(const code&)
+{
+}
+
+class relay_fixture
+{
+public:
+    relay_fixture()
+      : sender_settings_(relay_settings(relay_port)),
+        receiver_settings_(relay_settings(0)),
+        sender_(sender_settings_),
+        receiver_(receiver_settings_)
+    {
+        BOOST_REQUIRE_EQUAL(start_result(sender_), error::success);
+        BOOST_REQUIRE_EQUAL(run_result(sender_), error::success);
+        BOOST_REQUIRE_EQUAL(start_result(receiver_), error::success);
+
+        const auto inbound = std::make_shared<std::promise<channel::ptr>>();
+        sender_.subscribe_connection(
+            [inbound](const code& ec, channel::ptr channel)
+            {
+                inbound->set_value(ec ? nullptr : channel);
+                return false;
+            });
+
+        const auto outbound = std::make_shared<std::promise<channel::ptr>>();
+        receiver_.connect("127.0.0.1", relay_port,
+            [outbound](const code& ec, channel::ptr channel)
+            {
+                outbound->set_value(ec ? nullptr : channel);
+            });
+
+        auto sender_channel = inbound->get_future();
+        auto receiver_channel = outbound->get_future();
+        BOOST_REQUIRE(sender_channel.wait_for(relay_timeout) ==
+            std::future_status::ready);
+        BOOST_REQUIRE(receiver_channel.wait_for(relay_timeout) ==
+            std::future_status::ready);
+
+        sender_channel_ = sender_channel.get();
+        receiver_channel_ = receiver_channel.get();
+        BOOST_REQUIRE(sender_channel_);
+        BOOST_REQUIRE(receiver_channel_);
+    }
+
+    ~relay_fixture()
+    {
+        receiver_.close();
+        sender_.close();
+    }
+
+    // The sender pushes the announcement to a high bandwidth peer and
+    // serves getdata and get_block_transactions from the original block.
+    void serve(const block& original, const compact_block& announcement)
+    {
+        const auto channel = sender_channel_;
+
+        channel->subscribe<send_compact_blocks>(
+            [channel, announcement](const code& ec,
+                send_compact_blocks::ptr message)
+            {
+                if (ec)
+                    return false;
+
+                if (message->high_bandwidth_mode)
+                    channel->send(announcement, ignore_send);
+
+                return true;
+            });
+
+        channel->subscribe<get_data>(
+            [channel, original, announcement](const code& ec,
+                get_data::ptr message)
+            {
+                if (ec)
+                    return false;
+
+                for (const auto& inventory: message->inventories)
+                {
+                    if (inventory.type == inventory::type_id::compact_block)
+                        channel->send(announcement, ignore_send);
+                    else if (inventory.type == inventory::type_id::block)
+                        channel->send(block_message(original), ignore_send);
+                }
+
+                return true;
+            });
+
+        channel->subscribe<get_block_transactions>(
+            [channel, original](const code& ec,
+                get_block_transactions::ptr message)
+            {
+                if (ec)
+                    return false;
+
+                block_transactions response;
+                response.block_hash = message->block_hash;
+                for (const auto index: message->indexes)
+                    response.transactions.push_back(
+                        original.transactions[index]);
+
+                channel->send(response, ignore_send);
+                return true;
+            });
+    }
+
+    // The receiver rebuilds the block from its pool, requests what it lacks
+    // and falls back to a full getdata if the compact block is unusable.
+    std::future<relay_result> receive(const pool& mempool)
+    {
+        struct state
+        {
+            pool mempool;
+            block pending;
+            std::vector<uint64_t> missing;
+            std::promise<relay_result> result;
+        };
+
+        const auto channel = receiver_channel_;
+        const auto shared = std::make_shared<state>();
+        shared->mempool = mempool;
+
+        const auto get_block = [channel](const hash_digest& hash)
+        {
+            const get_data request{ { inventory::type_id::block, hash } };
+            channel->send(request, ignore_send);
+        };
+
+        channel->subscribe<compact_block>(
+            [channel, shared, get_block](const code& ec,
+                compact_block::ptr message)
+            {
+                if (ec)
+                    return false;
+
+                const auto hash = message->header.hash();
+                auto& rebuilt = shared->pending;
+                auto& missing = shared->missing;
+
+                if (!message->reconstruct(rebuilt, missing,
+                    shared->mempool.hashes(), shared->mempool.finder()))
+                {
+                    get_block(hash);
+                    return false;
+                }
+
+                if (!missing.empty())
+                {
+                    const get_block_transactions request{ hash, missing };
+                    channel->send(request, ignore_send);
+                    return false;
+                }
+
+                if (block::generate_merkle_root(rebuilt.transactions) !=
+                    rebuilt.header.merkle)
+                {
+                    get_block(hash);
+                    return false;
+                }
+
+                shared->result.set_value({ rebuilt, relay_route::compact });
+                return false;
+            });
+
+        channel->subscribe<block_transactions>(
+            [shared, get_block](const code& ec,
+                block_transactions::ptr message)
+            {
+                if (ec)
+                    return false;
+
+                auto& rebuilt = shared->pending;
+                const auto& missing = shared->missing;
+                if (message->transactions.size() != missing.size())
+                {
+                    get_block(message->block_hash);
+                    return false;
+                }
+
+                for (size_t index = 0; index < missing.size(); ++index)
+                    rebuilt.transactions[missing[index]] =
+                        message->transactions[index];
+
+                if (block::generate_merkle_root(rebuilt.transactions) !=
+                    rebuilt.header.merkle)
+                {
+                    get_block(message->block_hash);
+                    return false;
+                }
+
+                shared->result.set_value(
+                    { rebuilt, relay_route::block_transactions });
+                return false;
+            });
+
+        channel->subscribe<block_message>(
+            [shared](const code& ec, block_message::ptr message)
+            {
+                if (ec)
+                    return false;
+
+                shared->result.set_value(
+                    { *message, relay_route::full_block });
+                return false;
+            });
+
+        return shared->result.get_future();
+    }
+
+    void request_high_bandwidth()
+    {
+        const send_compact_blocks request{ true, 1 };
+        receiver_channel_->send(request, ignore_send);
+    }
+
+    void request_compact_block(const hash_digest& hash)
+    {
+        const get_data request{ { inventory::type_id::compact_block, hash } };
+        receiver_channel_->send(request, ignore_send);
+    }
+
+private:
+    // The network retains a reference to its settings.
+    const network::settings sender_settings_;
+    const network::settings receiver_settings_;
+    p2p sender_;
+    p2p receiver_;
+    channel::ptr sender_channel_;
+    channel::ptr receiver_channel_;
+};
+
+static relay_result relay_wait(std::future<relay_result>& future)
+{
+    BOOST_REQUIRE(future.wait_for(relay_timeout) ==
+        std::future_status::ready);
+    return future.get();
+}
+
+BOOST_FIXTURE_TEST_CASE(compact_block_relay__high_bandwidth__all_in_pool__reconstructed, relay_fixture)
+{
+    const auto original = make_block(4);
+    pool mempool;
+    mempool.transactions.assign(original.transactions.begin() + 1,
+        original.transactions.end());
+
+    serve(original, compact_block::from_block(original, pseudo_random()));
+    auto future = receive(mempool);
+    request_high_bandwidth();
+
+    const auto result = relay_wait(future);
+    BOOST_REQUIRE(result.route == relay_route::compact);
+    BOOST_REQUIRE(result.delivered.header.hash() == original.header.hash());
+    BOOST_REQUIRE(block::generate_merkle_root(result.delivered.transactions) ==
+        original.header.merkle);
+}
+
+BOOST_FIXTURE_TEST_CASE(compact_block_relay__low_bandwidth__missing__completed_by_block_transactions, relay_fixture)
+{
+    const auto original = make_block(5);
+
+    // The pool lacks the transactions at indexes 2 and 4.
+    pool mempool;
+    mempool.transactions.push_back(original.transactions[1]);
+    mempool.transactions.push_back(original.transactions[3]);
+
+    serve(original, compact_block::from_block(original, pseudo_random()));
+    auto future = receive(mempool);
+    request_compact_block(original.header.hash());
+
+    const auto result = relay_wait(future);
+    BOOST_REQUIRE(result.route == relay_route::block_transactions);
+    BOOST_REQUIRE(result.delivered.header.hash() == original.header.hash());
+    BOOST_REQUIRE(block::generate_merkle_root(result.delivered.transactions) ==
+        original.header.merkle);
+}
+
+BOOST_FIXTURE_TEST_CASE(compact_block_relay__short_id_collision__falls_back_to_full_block, relay_fixture)
+{
+    const auto original = make_block(3);
+    auto announcement = compact_block::from_block(original, pseudo_random());
+    announcement.short_ids[1] = announcement.short_ids[0];
+
+    pool mempool;
+    mempool.transactions.assign(original.transactions.begin() + 1,
+        original.transactions.end());
+
+    serve(original, announcement);
+    auto future = receive(mempool);
+    request_high_bandwidth();
+
+    const auto result = relay_wait(future);
+    BOOST_REQUIRE(result.route == relay_route::full_block);
+    BOOST_REQUIRE(result.delivered.header.hash() == original.header.hash());
+    BOOST_REQUIRE(block::generate_merkle_root(result.delivered.transactions) ==
+        original.header.merkle);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+
+using namespace libbitcoin;
+
+BOOST_AUTO_TEST_SUITE(sequence_buffer_tests)
+
+typedef std::vector<uint64_t> released;
+
+static std::function<void(uint64_t)> collect(released& out)
+{
+    return [&out](uint64_t item) { out.push_back(item); };
+}
+
+BOOST_AUTO_TEST_CASE(sequence_buffer__push__in_order__released_immediately)
+{
+    sequence_buffer<uint64_t> buffer;
+    released out;
+
+    for (uint64_t sequence = 0; sequence < 3; ++sequence)
+    {
+        buffer.push(sequence, sequence, collect(out));
+        BOOST_REQUIRE_EQUAL(out.size(), sequence + 1);
+        BOOST_REQUIRE_EQUAL(buffer.held(), 0u);
+    }
+
+    BOOST_REQUIRE_EQUAL(buffer.next(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(sequence_buffer__push__out_of_order__held_until_predecessors)
+{
+    sequence_buffer<uint64_t> buffer;
+    released out;
+
+    buffer.push(2, 2, collect(out));
+    buffer.push(1, 1, collect(out));
+    BOOST_REQUIRE(out.empty());
+    BOOST_REQUIRE_EQUAL(buffer.held(), 2u);
+
+    buffer.push(0, 0, collect(out));
+    BOOST_REQUIRE(out == released({ 0, 1, 2 }));
+    BOOST_REQUIRE_EQUAL(buffer.held(), 0u);
+
+    // A gap holds only the items after it.
+    buffer.push(4, 4, collect(out));
+    buffer.push(3, 3, collect(out));
+    buffer.push(6, 6, collect(out));
+    BOOST_REQUIRE(out == released({ 0, 1, 2, 3, 4 }));
+    BOOST_REQUIRE_EQUAL(buffer.next(), 5u);
+    BOOST_REQUIRE_EQUAL(buffer.held(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(sequence_buffer__push__concurrent_completion__released_in_arrival_order)
+{
+    static constexpr uint64_t items = 1000;
+    static constexpr size_t threads = 4;
+
+    // Items complete on several threads, each in its own shuffled order.
+    std::vector<uint64_t> sequences(items);
+    for (uint64_t sequence = 0; sequence < items; ++sequence)
+        sequences[sequence] = sequence;
+
+    std::shuffle(sequences.begin(), sequences.end(), std::mt19937(42));
+
+    sequence_buffer<uint64_t> buffer;
+    released out;
+    std::mutex mutex;
+    std::vector<std::thread> workers;
+
+    for (size_t thread = 0; thread < threads; ++thread)
+        workers.emplace_back([&, thread]()
+        {
+            for (auto index = thread; index < items; index += threads)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                buffer.push(sequences[index], sequences[index], collect(out));
+            }
+        });
+
+    for (auto& worker: workers)
+        worker.join();
+
+    BOOST_REQUIRE_EQUAL(out.size(), items);
+    BOOST_REQUIRE(std::is_sorted(out.begin(), out.end()));
+    BOOST_REQUIRE_EQUAL(buffer.held(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,142 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/server/messages/route.hpp>
+#include <metaverse/server/utility/address_subscriptions.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::server;
+
+BOOST_AUTO_TEST_SUITE(address_subscriptions_tests)
+
+static const auto expiration = std::chrono::seconds(600);
+static const auto resolution = std::chrono::seconds(1);
+
+static route make_route(uint8_t client)
+{
+    route reply_to;
+    reply_to.address1 = data_chunk{ client };
+    return reply_to;
+}
+
+static bool contains(const address_subscriptions::list& list, uint32_t id)
+{
+    return std::any_of(list.begin(), list.end(),
+        [id](const address_subscriptions::ptr& entry)
+        {
+            return entry->id == id;
+        });
+}
+
+BOOST_AUTO_TEST_CASE(address_subscriptions__match__prefixes_of_field__only)
+{
+    address_subscriptions subscriptions(0, expiration, resolution);
+    subscriptions.start();
+    BOOST_REQUIRE(subscriptions.subscribe(make_route(1), 1, binary("")));
+    BOOST_REQUIRE(subscriptions.subscribe(make_route(1), 2, binary("1")));
+    BOOST_REQUIRE(subscriptions.subscribe(make_route(1), 3, binary("10")));
+    BOOST_REQUIRE(subscriptions.subscribe(make_route(1), 4, binary("11")));
+    BOOST_REQUIRE(subscriptions.subscribe(make_route(1), 5, binary("1010")));
+    BOOST_REQUIRE(subscriptions.subscribe(make_route(1), 6, binary("0")));
+
+    const auto matches = subscriptions.match(binary("101100"));
+    BOOST_REQUIRE_EQUAL(matches.size(), 3u);
+    BOOST_REQUIRE(contains(matches, 1));
+    BOOST_REQUIRE(contains(matches, 2));
+    BOOST_REQUIRE(contains(matches, 3));
+
+    // A filter longer than the field is not a prefix of it.
+    BOOST_REQUIRE_EQUAL(subscriptions.match(binary("101")).size(), 3u);
+    BOOST_REQUIRE(contains(subscriptions.match(binary("1010")), 5));
+}
+
+BOOST_AUTO_TEST_CASE(address_subscriptions__subscribe__existing__renews_without_new_entry)
+{
+    address_subscriptions subscriptions(2, expiration, resolution);
+    subscriptions.start();
+    BOOST_REQUIRE(subscriptions.subscribe(make_route(1), 1, binary("10")));
+    BOOST_REQUIRE(subscriptions.subscribe(make_route(1), 7, binary("10")));
+    BOOST_REQUIRE_EQUAL(subscriptions.size(), 1u);
+
+    // The id is not changed by a renewal.
+    const auto matches = subscriptions.match(binary("10"));
+    BOOST_REQUIRE_EQUAL(matches.size(), 1u);
+    BOOST_REQUIRE_EQUAL(matches.front()->id, 1u);
+
+    BOOST_REQUIRE(subscriptions.subscribe(make_route(2), 2, binary("10")));
+    BOOST_REQUIRE(!subscriptions.subscribe(make_route(3), 3, binary("10")));
+    BOOST_REQUIRE_EQUAL(subscriptions.size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(address_subscriptions__unsubscribe__subscribed__no_longer_matches)
+{
+    address_subscriptions subscriptions(0, expiration, resolution);
+    subscriptions.start();
+    BOOST_REQUIRE(subscriptions.subscribe(make_route(1), 1, binary("1")));
+    BOOST_REQUIRE(subscriptions.subscribe(make_route(1), 2, binary("1011")));
+
+    const auto removed = subscriptions.unsubscribe(make_route(1), binary("1011"));
+    BOOST_REQUIRE(removed);
+    BOOST_REQUIRE_EQUAL(removed->id, 2u);
+    BOOST_REQUIRE(!subscriptions.unsubscribe(make_route(1), binary("1011")));
+
+    const auto matches = subscriptions.match(binary("1011"));
+    BOOST_REQUIRE_EQUAL(matches.size(), 1u);
+    BOOST_REQUIRE_EQUAL(matches.front()->id, 1u);
+    BOOST_REQUIRE_EQUAL(subscriptions.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(address_subscriptions__expire__after_expiration__removes)
+{
+    address_subscriptions subscriptions(0, std::chrono::milliseconds(20),
+        std::chrono::milliseconds(10));
+    subscriptions.start();
+    BOOST_REQUIRE(subscriptions.subscribe(make_route(1), 1, binary("10")));
+    BOOST_REQUIRE(subscriptions.expire().empty());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+
+    const auto expired = subscriptions.expire();
+    BOOST_REQUIRE_EQUAL(expired.size(), 1u);
+    BOOST_REQUIRE_EQUAL(expired.front()->id, 1u);
+    BOOST_REQUIRE_EQUAL(subscriptions.size(), 0u);
+    BOOST_REQUIRE(subscriptions.match(binary("10")).empty());
+}
+
+BOOST_AUTO_TEST_CASE(address_subscriptions__stop__subscribed__drops_all)
+{
+    address_subscriptions subscriptions(0, expiration, resolution);
+    BOOST_REQUIRE(!subscriptions.subscribe(make_route(1), 1, binary("1")));
+
+    subscriptions.start();
+    BOOST_REQUIRE(subscriptions.subscribe(make_route(1), 1, binary("1")));
+    BOOST_REQUIRE(subscriptions.subscribe(make_route(2), 2, binary("0")));
+
+    BOOST_REQUIRE_EQUAL(subscriptions.stop().size(), 2u);
+    BOOST_REQUIRE_EQUAL(subscriptions.size(), 0u);
+    BOOST_REQUIRE(!subscriptions.subscribe(make_route(1), 1, binary("1")));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/explorer/json_helper.hpp>
+#include <metaverse/explorer/json_writer.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::explorer::config;
+
+BOOST_AUTO_TEST_SUITE(json_helper_tests)
+
+static chain::transaction make_payment()
+{
+    short_hash payee;
+    payee.fill(0x42);
+
+    chain::output out;
+    out.value = 1000;
+    out.script.operations = chain::operation::to_pay_key_hash_pattern(payee);
+
+    chain::input in;
+    in.previous_output = chain::output_point{ null_hash, 3 };
+    in.sequence = max_uint32;
+
+    return chain::transaction{ 1, 0, { in }, { out, out } };
+}
+
+static chain::header make_header()
+{
+    chain::header value;
+    value.version = 1;
+    value.number = 42;
+    value.timestamp = 1486796400;
+    value.transaction_count = 2;
+    value.bits = 914;
+    value.nonce = 7;
+    return value;
+}
+
+template <typename Write>
+static std::string stream(Write write)
+{
+    std::ostringstream out;
+    json_writer writer(out);
+    write(writer);
+    return out.str();
+}
+
+BOOST_AUTO_TEST_CASE(json_helper__prop_list__header_writer__matches_tree)
+{
+    const auto header = make_header();
+
+    for (const auto version: { 1, 2 })
+    {
+        json_helper helper(version);
+        BOOST_REQUIRE_EQUAL(stream([&](json_writer& writer)
+        {
+            helper.prop_list(writer, header);
+        }), write_compact(helper.prop_list(header)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(json_helper__prop_list__transaction_writer__matches_tree)
+{
+    const auto tx = make_payment();
+
+    for (const auto version: { 1, 2 })
+    {
+        json_helper helper(version);
+        BOOST_REQUIRE_EQUAL(stream([&](json_writer& writer)
+        {
+            helper.prop_list(writer, tx, 42, true);
+        }), write_compact(helper.prop_list(tx, 42, true)));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(json_helper__prop_list__empty_transaction_writer__matches_tree)
+{
+    const chain::transaction tx{ 1, 0, {}, {} };
+
+    for (const auto version: { 1, 2 })
+    {
+        json_helper helper(version);
+        const auto tree = helper.prop_list(tx, 0, true);
+        BOOST_REQUIRE(tree["inputs"].isNull());
+        BOOST_REQUIRE_EQUAL(tree["outputs"].isNull(), version != 1);
+        BOOST_REQUIRE_EQUAL(stream([&](json_writer& writer)
+        {
+            helper.prop_list(writer, tx, 0, true);
+        }), write_compact(tree));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <memory>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/explorer/json_helper.hpp>
+#include <metaverse/explorer/json_writer.hpp>
+#include <metaverse/server/utility/publisher.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::server;
+using namespace libbitcoin::wallet;
+
+BOOST_AUTO_TEST_SUITE(publisher_tests)
+
+static short_hash make_payee()
+{
+    short_hash payee;
+    payee.fill(0x42);
+    return payee;
+}
+
+static transaction make_payment(uint32_t index)
+{
+    output out;
+    out.value = 1000;
+    out.script.operations = operation::to_pay_key_hash_pattern(make_payee());
+
+    input in;
+    in.previous_output = output_point{ null_hash, index };
+    in.sequence = max_uint32;
+
+    return transaction{ 1, 0, { in }, { out, out } };
+}
+
+static block::ptr make_block()
+{
+    const auto instance = std::make_shared<block>();
+    instance->header.version = 1;
+    instance->header.number = 42;
+    instance->transactions = { make_payment(0), make_payment(1) };
+    instance->header.transaction_count = instance->transactions.size();
+    instance->header.merkle =
+        block::generate_merkle_root(instance->transactions);
+    return instance;
+}
+
+BOOST_AUTO_TEST_CASE(publisher__published_transaction__in_block__encodes_indexed_transaction)
+{
+    const auto block = make_block();
+    published_transaction value;
+    value.height = 42;
+    value.block_hash = block->header.hash();
+    value.block = block;
+    value.index = 1;
+
+    const auto& expected = block->transactions[1];
+    BOOST_REQUIRE(&value.tx() == &expected);
+    BOOST_REQUIRE(value.hash() == expected.hash());
+    BOOST_REQUIRE(value.data() == expected.to_data());
+
+    // The encodings are made once and then shared.
+    BOOST_REQUIRE(&value.data() == &value.data());
+    BOOST_REQUIRE(&value.json() == &value.json());
+
+    const auto& addresses = value.addresses();
+    BOOST_REQUIRE_EQUAL(addresses.size(), 2u);
+    BOOST_REQUIRE(addresses[0] == payment_address(make_payee()));
+    BOOST_REQUIRE(addresses[1] == payment_address(make_payee()));
+}
+
+BOOST_AUTO_TEST_CASE(publisher__published_transaction__json__matches_property_tree)
+{
+    const auto block = make_block();
+    published_transaction value;
+    value.height = 42;
+    value.block_hash = block->header.hash();
+    value.block = block;
+    value.index = 0;
+
+    const auto tree = explorer::config::json_helper().prop_list(
+        block->transactions[0], 42, true);
+    BOOST_REQUIRE_EQUAL(value.json(),
+        explorer::config::write_compact(tree));
+}
+
+BOOST_AUTO_TEST_CASE(publisher__published_transaction__pool__encodes_pool_transaction)
+{
+    published_transaction value;
+    value.height = 0;
+    value.block_hash = null_hash;
+    value.index = 0;
+    value.pool_transaction = std::make_shared<const transaction>(
+        make_payment(7));
+
+    BOOST_REQUIRE(&value.tx() == value.pool_transaction.get());
+    BOOST_REQUIRE(value.hash() == value.pool_transaction->hash());
+    BOOST_REQUIRE(value.data() == value.pool_transaction->to_data());
+}
+
+BOOST_AUTO_TEST_CASE(publisher__published_block__data__excludes_transaction_count)
+{
+    published_block value;
+    value.height = 42;
+    value.block = make_block();
+    value.hash = value.block->header.hash();
+
+    BOOST_REQUIRE(value.data() == value.block->to_data(false));
+    BOOST_REQUIRE(&value.data() == &value.data());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/server/utility/query_statistics.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::server;
+
+BOOST_AUTO_TEST_SUITE(query_statistics_tests)
+
+static asio::duration microseconds(uint64_t value)
+{
+    return std::chrono::duration_cast<asio::duration>(
+        asio::microseconds(value));
+}
+
+BOOST_AUTO_TEST_CASE(query_statistics__record__unregistered__ignored)
+{
+    query_statistics statistics;
+    statistics.attach("blockchain.fetch_history", true);
+    statistics.record("blockchain.fetch_stealth", microseconds(10));
+
+    const auto methods = statistics.snapshot();
+    BOOST_REQUIRE_EQUAL(methods.size(), 1u);
+    BOOST_REQUIRE_EQUAL(methods[0].count, 0u);
+    BOOST_REQUIRE_EQUAL(methods[0].p99_microseconds, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(query_statistics__attach__twice__keeps_first_lane)
+{
+    query_statistics statistics;
+    statistics.attach("blockchain.fetch_history", true);
+    statistics.attach("blockchain.fetch_history", false);
+    statistics.attach("address.subscribe", false);
+
+    const auto methods = statistics.snapshot();
+    BOOST_REQUIRE_EQUAL(methods.size(), 2u);
+    BOOST_REQUIRE_EQUAL(methods[0].name, "address.subscribe");
+    BOOST_REQUIRE(!methods[0].heavy);
+    BOOST_REQUIRE_EQUAL(methods[1].name, "blockchain.fetch_history");
+    BOOST_REQUIRE(methods[1].heavy);
+}
+
+BOOST_AUTO_TEST_CASE(query_statistics__snapshot__percentiles__bucket_upper_bounds)
+{
+    query_statistics statistics;
+    statistics.attach("blockchain.fetch_history", true);
+
+    // Ten microseconds falls in the bucket below 16.
+    for (size_t count = 0; count < 98; ++count)
+        statistics.record("blockchain.fetch_history", microseconds(10));
+
+    statistics.record("blockchain.fetch_history", microseconds(5000));
+    statistics.record("blockchain.fetch_history", microseconds(5000));
+
+    const auto method = statistics.snapshot().front();
+    BOOST_REQUIRE_EQUAL(method.count, 100u);
+    BOOST_REQUIRE_EQUAL(method.mean_microseconds, (98u * 10 + 2 * 5000) / 100);
+    BOOST_REQUIRE_EQUAL(method.p50_microseconds, 16u);
+
+    // The bucket bound of 8192 is capped by the maximum.
+    BOOST_REQUIRE_EQUAL(method.p99_microseconds, 5000u);
+    BOOST_REQUIRE_EQUAL(method.max_microseconds, 5000u);
+}
+
+BOOST_AUTO_TEST_CASE(query_statistics__record__concurrent__counts_every_query)
+{
+    static constexpr size_t threads = 4;
+    static constexpr size_t queries = 10000;
+
+    query_statistics statistics;
+    statistics.attach("blockchain.fetch_history", true);
+
+    std::vector<std::thread> recorders;
+    for (size_t thread = 0; thread < threads; ++thread)
+        recorders.emplace_back([&statistics, thread]()
+        {
+            for (size_t query = 0; query < queries; ++query)
+                statistics.record("blockchain.fetch_history",
+                    microseconds(thread + 1));
+        });
+
+    for (auto& recorder: recorders)
+        recorder.join();
+
+    const auto method = statistics.snapshot().front();
+    BOOST_REQUIRE_EQUAL(method.count, threads * queries);
+    BOOST_REQUIRE_EQUAL(method.max_microseconds, threads);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * libbitcoin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <jsoncpp/json/json.h>
+#include <metaverse/mgbubble/RpcCache.hpp>
+
+using namespace mgbubble;
+
+BOOST_AUTO_TEST_SUITE(rpc_cache_tests)
+
+static const auto max_age = std::chrono::seconds(60);
+
+static RpcCache::Rendered render(const std::string& text)
+{
+    return std::make_shared<const std::string>(text);
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cache__cacheable__read_only__only)
+{
+    BOOST_REQUIRE(RpcCache::cacheable("getheight"));
+    BOOST_REQUIRE(RpcCache::cacheable("getblock"));
+    BOOST_REQUIRE(!RpcCache::cacheable("getbalance"));
+    BOOST_REQUIRE(!RpcCache::cacheable("sendfrom"));
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cache__key__v2_member_order__same_key)
+{
+    Json::Value first;
+    first["hash"] = "00ff";
+    first["json"] = true;
+
+    Json::Value second;
+    second["json"] = true;
+    second["hash"] = "00ff";
+
+    BOOST_REQUIRE_EQUAL(RpcCache::key(2, { "getblock" }, first),
+        RpcCache::key(2, { "getblock" }, second));
+    BOOST_REQUIRE(RpcCache::key(2, { "getblock" }, first) !=
+        RpcCache::key(2, { "getblockheader" }, first));
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cache__key__v1_arguments__not_concatenated)
+{
+    const Json::Value none;
+    BOOST_REQUIRE(RpcCache::key(1, { "getblock", "12" }, none) !=
+        RpcCache::key(1, { "getblock1", "2" }, none));
+    BOOST_REQUIRE(RpcCache::key(1, { "getheight" }, none) !=
+        RpcCache::key(2, { "getheight" }, none));
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cache__find__inserted__hit)
+{
+    RpcCache cache(8, 1024, max_age);
+    BOOST_REQUIRE(!cache.find("getheight"));
+
+    cache.insert("getheight", cache.generation(), render("42"));
+    const auto found = cache.find("getheight");
+    BOOST_REQUIRE(found);
+    BOOST_REQUIRE_EQUAL(*found, "42");
+
+    const auto statistics = cache.statistics();
+    BOOST_REQUIRE_EQUAL(statistics.entries, 1u);
+    BOOST_REQUIRE_EQUAL(statistics.bytes, std::string("getheight42").size());
+    BOOST_REQUIRE_EQUAL(statistics.hits, 1u);
+    BOOST_REQUIRE_EQUAL(statistics.misses, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cache__insert__older_generation__not_stored)
+{
+    RpcCache cache(8, 1024, max_age);
+    const auto generation = cache.generation();
+    cache.insert("getheight", generation, render("42"));
+
+    // A new tip arrives while the command is executing.
+    cache.invalidate();
+    BOOST_REQUIRE(!cache.find("getheight"));
+
+    cache.insert("getheight", generation, render("42"));
+    BOOST_REQUIRE(!cache.find("getheight"));
+    BOOST_REQUIRE_EQUAL(cache.statistics().invalidations, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cache__insert__entry_limit__evicts_least_recently_used)
+{
+    RpcCache cache(2, 1024, max_age);
+    cache.insert("a", cache.generation(), render("1"));
+    cache.insert("b", cache.generation(), render("2"));
+    BOOST_REQUIRE(cache.find("a"));
+
+    cache.insert("c", cache.generation(), render("3"));
+    BOOST_REQUIRE(cache.find("a"));
+    BOOST_REQUIRE(!cache.find("b"));
+    BOOST_REQUIRE(cache.find("c"));
+    BOOST_REQUIRE_EQUAL(cache.statistics().evictions, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cache__insert__byte_limit__evicts_and_skips_oversized)
+{
+    RpcCache cache(8, 7, max_age);
+    cache.insert("a", cache.generation(), render("123"));
+    cache.insert("b", cache.generation(), render("456"));
+    BOOST_REQUIRE(!cache.find("a"));
+    BOOST_REQUIRE(cache.find("b"));
+
+    cache.insert("c", cache.generation(), render("123456789"));
+    BOOST_REQUIRE(!cache.find("c"));
+    BOOST_REQUIRE(cache.find("b"));
+    BOOST_REQUIRE_EQUAL(cache.statistics().bytes, 4u);
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cache__find__expired__miss)
+{
+    RpcCache cache(8, 1024, std::chrono::seconds(0));
+    cache.insert("getinfo", cache.generation(), render("{}"));
+    BOOST_REQUIRE(!cache.find("getinfo"));
+    BOOST_REQUIRE_EQUAL(cache.statistics().entries, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cache__insert__disabled__not_stored)
+{
+    RpcCache cache(0, 1024, max_age);
+    BOOST_REQUIRE(!cache.enabled());
+    cache.insert("getheight", cache.generation(), render("42"));
+    BOOST_REQUIRE(!cache.find("getheight"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()